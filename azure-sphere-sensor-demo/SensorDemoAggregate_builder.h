@@ -0,0 +1,90 @@
+#ifndef SENSORDEMOAGGREGATE_BUILDER_H
+#define SENSORDEMOAGGREGATE_BUILDER_H
+
+/* Generated by flatcc 0.5.3-pre FlatBuffers schema compiler for C by dvide.com */
+
+#ifndef SENSORDEMOAGGREGATE_READER_H
+#include "SensorDemoAggregate_reader.h"
+#endif
+#ifndef FLATBUFFERS_COMMON_BUILDER_H
+#include "flatbuffers_common_builder.h"
+#endif
+#include "flatcc/flatcc_prologue.h"
+#ifndef flatbuffers_identifier
+#define flatbuffers_identifier 0
+#endif
+#ifndef flatbuffers_extension
+#define flatbuffers_extension ".bin"
+#endif
+
+static const flatbuffers_voffset_t __SensorDemoAggregate_required[] = { 0 };
+typedef flatbuffers_ref_t SensorDemoAggregate_ref_t;
+static SensorDemoAggregate_ref_t SensorDemoAggregate_clone(flatbuffers_builder_t *B, SensorDemoAggregate_table_t t);
+__flatbuffers_build_table(flatbuffers_, SensorDemoAggregate, 13)
+
+#define __SensorDemoAggregate_formal_args ,\
+  uint64_t v0, uint64_t v1, uint64_t v2, uint32_t v3, float v4, float v5, float v6, float v7, float v8, float v9, float v10, float v11, float v12
+#define __SensorDemoAggregate_call_args ,\
+  v0, v1, v2, v3, v4, v5, v6, v7, v8, v9, v10, v11, v12
+static inline SensorDemoAggregate_ref_t SensorDemoAggregate_create(flatbuffers_builder_t *B __SensorDemoAggregate_formal_args);
+__flatbuffers_build_table_prolog(flatbuffers_, SensorDemoAggregate, SensorDemoAggregate_identifier, SensorDemoAggregate_type_identifier)
+
+__flatbuffers_build_scalar_field(0, flatbuffers_, SensorDemoAggregate_id, flatbuffers_uint64, uint64_t, 8, 8, UINT64_C(0), SensorDemoAggregate)
+__flatbuffers_build_scalar_field(1, flatbuffers_, SensorDemoAggregate_windowStart, flatbuffers_uint64, uint64_t, 8, 8, UINT64_C(0), SensorDemoAggregate)
+__flatbuffers_build_scalar_field(2, flatbuffers_, SensorDemoAggregate_windowEnd, flatbuffers_uint64, uint64_t, 8, 8, UINT64_C(0), SensorDemoAggregate)
+__flatbuffers_build_scalar_field(3, flatbuffers_, SensorDemoAggregate_count, flatbuffers_uint32, uint32_t, 4, 4, UINT32_C(0), SensorDemoAggregate)
+__flatbuffers_build_scalar_field(4, flatbuffers_, SensorDemoAggregate_lightIntensityMin, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(5, flatbuffers_, SensorDemoAggregate_lightIntensityMax, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(6, flatbuffers_, SensorDemoAggregate_lightIntensityAvg, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(7, flatbuffers_, SensorDemoAggregate_temperatureMin, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(8, flatbuffers_, SensorDemoAggregate_temperatureMax, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(9, flatbuffers_, SensorDemoAggregate_temperatureAvg, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(10, flatbuffers_, SensorDemoAggregate_humidityMin, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(11, flatbuffers_, SensorDemoAggregate_humidityMax, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+__flatbuffers_build_scalar_field(12, flatbuffers_, SensorDemoAggregate_humidityAvg, flatbuffers_float, float, 4, 4, 0.000000f, SensorDemoAggregate)
+
+static inline SensorDemoAggregate_ref_t SensorDemoAggregate_create(flatbuffers_builder_t *B __SensorDemoAggregate_formal_args)
+{
+    if (SensorDemoAggregate_start(B)
+        || SensorDemoAggregate_id_add(B, v0)
+        || SensorDemoAggregate_windowStart_add(B, v1)
+        || SensorDemoAggregate_windowEnd_add(B, v2)
+        || SensorDemoAggregate_count_add(B, v3)
+        || SensorDemoAggregate_lightIntensityMin_add(B, v4)
+        || SensorDemoAggregate_lightIntensityMax_add(B, v5)
+        || SensorDemoAggregate_lightIntensityAvg_add(B, v6)
+        || SensorDemoAggregate_temperatureMin_add(B, v7)
+        || SensorDemoAggregate_temperatureMax_add(B, v8)
+        || SensorDemoAggregate_temperatureAvg_add(B, v9)
+        || SensorDemoAggregate_humidityMin_add(B, v10)
+        || SensorDemoAggregate_humidityMax_add(B, v11)
+        || SensorDemoAggregate_humidityAvg_add(B, v12)) {
+        return 0;
+    }
+    return SensorDemoAggregate_end(B);
+}
+
+static SensorDemoAggregate_ref_t SensorDemoAggregate_clone(flatbuffers_builder_t *B, SensorDemoAggregate_table_t t)
+{
+    __flatbuffers_memoize_begin(B, t);
+    if (SensorDemoAggregate_start(B)
+        || SensorDemoAggregate_id_pick(B, t)
+        || SensorDemoAggregate_windowStart_pick(B, t)
+        || SensorDemoAggregate_windowEnd_pick(B, t)
+        || SensorDemoAggregate_count_pick(B, t)
+        || SensorDemoAggregate_lightIntensityMin_pick(B, t)
+        || SensorDemoAggregate_lightIntensityMax_pick(B, t)
+        || SensorDemoAggregate_lightIntensityAvg_pick(B, t)
+        || SensorDemoAggregate_temperatureMin_pick(B, t)
+        || SensorDemoAggregate_temperatureMax_pick(B, t)
+        || SensorDemoAggregate_temperatureAvg_pick(B, t)
+        || SensorDemoAggregate_humidityMin_pick(B, t)
+        || SensorDemoAggregate_humidityMax_pick(B, t)
+        || SensorDemoAggregate_humidityAvg_pick(B, t)) {
+        return 0;
+    }
+    __flatbuffers_memoize_end(B, t, SensorDemoAggregate_end(B));
+}
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* SENSORDEMOAGGREGATE_BUILDER_H */
@@ -0,0 +1,440 @@
+#ifndef SENSORDEMOAGGREGATE_OBX_H
+#define SENSORDEMOAGGREGATE_OBX_H
+
+/* Generated by generate-entity-api.py from SensorDemoAggregate.fbs, do not edit. */
+
+#include <stddef.h>
+#include <objectbox.h>
+
+#ifndef SENSORDEMOAGGREGATE_BUILDER_H
+#include "SensorDemoAggregate_builder.h"
+#endif
+
+#define SensorDemoAggregate_entity_id 3
+
+typedef struct SensorDemoAggregate {
+    uint64_t id;
+    uint64_t windowStart;
+    uint64_t windowEnd;
+    uint32_t count;
+    float lightIntensityMin;
+    float lightIntensityMax;
+    float lightIntensityAvg;
+    float temperatureMin;
+    float temperatureMax;
+    float temperatureAvg;
+    float humidityMin;
+    float humidityMax;
+    float humidityAvg;
+} SensorDemoAggregate_t;
+
+/* Serializes the object as root of a new buffer; every field is written, so all objects share one vtable. */
+static inline int SensorDemoAggregate_build(flatcc_builder_t *B, const SensorDemoAggregate_t *object)
+{
+    if (SensorDemoAggregate_start_as_root(B)
+        || SensorDemoAggregate_id_force_add(B, object->id)
+        || SensorDemoAggregate_windowStart_force_add(B, object->windowStart)
+        || SensorDemoAggregate_windowEnd_force_add(B, object->windowEnd)
+        || SensorDemoAggregate_count_force_add(B, object->count)
+        || SensorDemoAggregate_lightIntensityMin_force_add(B, object->lightIntensityMin)
+        || SensorDemoAggregate_lightIntensityMax_force_add(B, object->lightIntensityMax)
+        || SensorDemoAggregate_lightIntensityAvg_force_add(B, object->lightIntensityAvg)
+        || SensorDemoAggregate_temperatureMin_force_add(B, object->temperatureMin)
+        || SensorDemoAggregate_temperatureMax_force_add(B, object->temperatureMax)
+        || SensorDemoAggregate_temperatureAvg_force_add(B, object->temperatureAvg)
+        || SensorDemoAggregate_humidityMin_force_add(B, object->humidityMin)
+        || SensorDemoAggregate_humidityMax_force_add(B, object->humidityMax)
+        || SensorDemoAggregate_humidityAvg_force_add(B, object->humidityAvg)
+        || !SensorDemoAggregate_end_as_root(B)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Reads all fields of a serialized object. */
+static inline int SensorDemoAggregate_read(const void *buffer, size_t size, SensorDemoAggregate_t *object)
+{
+    SensorDemoAggregate_table_t t;
+    if (size < sizeof(flatbuffers_uoffset_t) || !(t = SensorDemoAggregate_as_root(buffer))) return -1;
+    object->id = SensorDemoAggregate_id(t);
+    object->windowStart = SensorDemoAggregate_windowStart(t);
+    object->windowEnd = SensorDemoAggregate_windowEnd(t);
+    object->count = SensorDemoAggregate_count(t);
+    object->lightIntensityMin = SensorDemoAggregate_lightIntensityMin(t);
+    object->lightIntensityMax = SensorDemoAggregate_lightIntensityMax(t);
+    object->lightIntensityAvg = SensorDemoAggregate_lightIntensityAvg(t);
+    object->temperatureMin = SensorDemoAggregate_temperatureMin(t);
+    object->temperatureMax = SensorDemoAggregate_temperatureMax(t);
+    object->temperatureAvg = SensorDemoAggregate_temperatureAvg(t);
+    object->humidityMin = SensorDemoAggregate_humidityMin(t);
+    object->humidityMax = SensorDemoAggregate_humidityMax(t);
+    object->humidityAvg = SensorDemoAggregate_humidityAvg(t);
+    return 0;
+}
+
+/* Adds the object to a batch (see obxc_batch()); equal strings and vectors are shared with the batch's other objects. */
+static inline obx_err SensorDemoAggregate_batch_add(OBXC_batch *batch, const SensorDemoAggregate_t *object)
+{
+    flatcc_builder_t *B = obxc_batch_builder(batch);
+    if (B == NULL) return obxc_last_error_code();
+    if (SensorDemoAggregate_start(B)
+        || SensorDemoAggregate_id_force_add(B, object->id)
+        || SensorDemoAggregate_windowStart_force_add(B, object->windowStart)
+        || SensorDemoAggregate_windowEnd_force_add(B, object->windowEnd)
+        || SensorDemoAggregate_count_force_add(B, object->count)
+        || SensorDemoAggregate_lightIntensityMin_force_add(B, object->lightIntensityMin)
+        || SensorDemoAggregate_lightIntensityMax_force_add(B, object->lightIntensityMax)
+        || SensorDemoAggregate_lightIntensityAvg_force_add(B, object->lightIntensityAvg)
+        || SensorDemoAggregate_temperatureMin_force_add(B, object->temperatureMin)
+        || SensorDemoAggregate_temperatureMax_force_add(B, object->temperatureMax)
+        || SensorDemoAggregate_temperatureAvg_force_add(B, object->temperatureAvg)
+        || SensorDemoAggregate_humidityMin_force_add(B, object->humidityMin)
+        || SensorDemoAggregate_humidityMax_force_add(B, object->humidityMax)
+        || SensorDemoAggregate_humidityAvg_force_add(B, object->humidityAvg)) {
+        /* marks the batch as failed, the builder is left inside an unfinished table */
+        return obxc_batch_add(batch, 0);
+    }
+    return obxc_batch_add(batch, SensorDemoAggregate_end(B));
+}
+
+/* obxc_sample_build() callback for samplers buffering SensorDemoAggregate_t objects, see OBXC_sampler_options. */
+static inline int SensorDemoAggregate_sample_build(flatcc_builder_t *B, const void *sample)
+{
+    return SensorDemoAggregate_build(B, (const SensorDemoAggregate_t *) sample);
+}
+
+/* obxc_sample_add() callback for samplers uploading SensorDemoAggregate_t objects in batches (OBXC_UPLOAD_BATCH). */
+static inline obx_err SensorDemoAggregate_sample_add(OBXC_batch *batch, const void *sample)
+{
+    return SensorDemoAggregate_batch_add(batch, (const SensorDemoAggregate_t *) sample);
+}
+
+/* Columns for obxc_bytes_array_project(), extracting a field of all objects; values holds one per object. */
+static inline OBXC_column SensorDemoAggregate_id_column(uint64_t *values)
+{
+    OBXC_column column = {0, sizeof(uint64_t), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_windowStart_column(uint64_t *values)
+{
+    OBXC_column column = {1, sizeof(uint64_t), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_windowEnd_column(uint64_t *values)
+{
+    OBXC_column column = {2, sizeof(uint64_t), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_count_column(uint32_t *values)
+{
+    OBXC_column column = {3, sizeof(uint32_t), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_lightIntensityMin_column(float *values)
+{
+    OBXC_column column = {4, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_lightIntensityMax_column(float *values)
+{
+    OBXC_column column = {5, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_lightIntensityAvg_column(float *values)
+{
+    OBXC_column column = {6, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_temperatureMin_column(float *values)
+{
+    OBXC_column column = {7, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_temperatureMax_column(float *values)
+{
+    OBXC_column column = {8, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_temperatureAvg_column(float *values)
+{
+    OBXC_column column = {9, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_humidityMin_column(float *values)
+{
+    OBXC_column column = {10, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_humidityMax_column(float *values)
+{
+    OBXC_column column = {11, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoAggregate_humidityAvg_column(float *values)
+{
+    OBXC_column column = {12, sizeof(float), values};
+    return column;
+}
+
+/* Fields of SensorDemoAggregate_t samples for aggregators, see obxc_aggregator(), and time series, see obxc_series_encode(). */
+static inline OBXC_field SensorDemoAggregate_id_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, id), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_windowStart_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, windowStart), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_windowEnd_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, windowEnd), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_count_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, count), sizeof(uint32_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_lightIntensityMin_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, lightIntensityMin), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_lightIntensityMax_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, lightIntensityMax), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_lightIntensityAvg_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, lightIntensityAvg), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_temperatureMin_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, temperatureMin), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_temperatureMax_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, temperatureMax), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_temperatureAvg_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, temperatureAvg), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_humidityMin_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, humidityMin), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_humidityMax_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, humidityMax), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoAggregate_humidityAvg_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoAggregate_t, humidityAvg), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+/* Fields for deadband filters on SensorDemoAggregate_t samples, see obxc_deadband(). */
+static inline OBXC_deadband_field SensorDemoAggregate_id_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_id_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_windowStart_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_windowStart_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_windowEnd_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_windowEnd_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_count_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_count_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_lightIntensityMin_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_lightIntensityMin_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_lightIntensityMax_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_lightIntensityMax_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_lightIntensityAvg_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_lightIntensityAvg_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_temperatureMin_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_temperatureMin_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_temperatureMax_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_temperatureMax_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_temperatureAvg_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_temperatureAvg_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_humidityMin_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_humidityMin_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_humidityMax_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_humidityMax_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoAggregate_humidityAvg_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoAggregate_humidityAvg_field(), absolute, relative};
+    return field;
+}
+
+/* Sorted indexes over the uint64 fields, see obxc_index(); the array must outlive the index. */
+static inline OBXC_index *SensorDemoAggregate_id_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 0);
+}
+
+static inline OBXC_index *SensorDemoAggregate_windowStart_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 1);
+}
+
+static inline OBXC_index *SensorDemoAggregate_windowEnd_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 2);
+}
+
+static inline OBXC_box *SensorDemoAggregate_box(OBXC_store *store)
+{
+    return obxc_box(store, SensorDemoAggregate_entity_id);
+}
+
+/* Inserts the object using the box's builder; on success, object->id is set to the ID assigned by the server. */
+static inline obx_err SensorDemoAggregate_put(OBXC_box *box, SensorDemoAggregate_t *object)
+{
+    flatcc_builder_t *B = obxc_box_builder(box);
+    obx_err err;
+    int id;
+    if (B == NULL) return obxc_last_error_code();
+    /* a failed build leaves an unfinished buffer, which obxc_box_put_builder() rejects */
+    SensorDemoAggregate_build(B, object);
+    err = obxc_box_put_builder(box, B, &id);
+    if (err == OBX_SUCCESS) object->id = (uint64_t) id;
+    return err;
+}
+
+/* Builds the template for _encode(), which is reused for all objects; free it using obxc_template_free(). */
+static inline obx_err SensorDemoAggregate_template_init(OBXC_template *tpl, flatcc_builder_t *B)
+{
+    SensorDemoAggregate_t zero = {0};
+    if (SensorDemoAggregate_build(B, &zero)) {
+        return obxc_last_error_set(OBX_ERROR_ILLEGAL_STATE, "SensorDemoAggregate: build failed");
+    }
+    return obxc_template_init(tpl, B);
+}
+
+/* Encodes the object by patching its values into the template's buffer; yields the same bytes as _build(). */
+static inline void SensorDemoAggregate_encode(OBXC_template *tpl, const SensorDemoAggregate_t *object)
+{
+    uint8_t *buf = (uint8_t *) tpl->buffer;
+    flatbuffers_uint64_write_to_pe(buf + tpl->field_pos[0], object->id);
+    flatbuffers_uint64_write_to_pe(buf + tpl->field_pos[1], object->windowStart);
+    flatbuffers_uint64_write_to_pe(buf + tpl->field_pos[2], object->windowEnd);
+    flatbuffers_uint32_write_to_pe(buf + tpl->field_pos[3], object->count);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[4], object->lightIntensityMin);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[5], object->lightIntensityMax);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[6], object->lightIntensityAvg);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[7], object->temperatureMin);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[8], object->temperatureMax);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[9], object->temperatureAvg);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[10], object->humidityMin);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[11], object->humidityMax);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[12], object->humidityAvg);
+}
+
+/* Like _put(), but encodes the object using the template instead of a builder. */
+static inline obx_err SensorDemoAggregate_put_template(OBXC_box *box, OBXC_template *tpl, SensorDemoAggregate_t *object)
+{
+    OBXC_bytes bytes;
+    obx_err err;
+    int id;
+    SensorDemoAggregate_encode(tpl, object);
+    bytes.data = tpl->buffer;
+    bytes.size = tpl->size;
+    err = obxc_box_put(box, &bytes, &id);
+    if (err == OBX_SUCCESS) object->id = (uint64_t) id;
+    return err;
+}
+
+/* Gets the object with the given ID. */
+static inline obx_err SensorDemoAggregate_get(OBXC_box *box, int id, SensorDemoAggregate_t *object)
+{
+    OBXC_bytes bytes;
+    obx_err err = obxc_box_get(box, id, &bytes);
+    if (err != OBX_SUCCESS) return err;
+    if (SensorDemoAggregate_read(bytes.data, bytes.size, object)) {
+        err = obxc_last_error_set(OBX_ERROR_ILLEGAL_RESPONSE, "SensorDemoAggregate: invalid object");
+    }
+    obxc_bytes_free(&bytes);
+    return err;
+}
+
+#endif /* SENSORDEMOAGGREGATE_OBX_H */
@@ -0,0 +1,56 @@
+#ifndef SENSORDEMOAGGREGATE_READER_H
+#define SENSORDEMOAGGREGATE_READER_H
+
+/* Generated by flatcc 0.5.3-pre FlatBuffers schema compiler for C by dvide.com */
+
+#ifndef FLATBUFFERS_COMMON_READER_H
+#include "flatbuffers_common_reader.h"
+#endif
+#include "flatcc/flatcc_flatbuffers.h"
+#ifndef __alignas_is_defined
+#include <stdalign.h>
+#endif
+#include "flatcc/flatcc_prologue.h"
+#ifndef flatbuffers_identifier
+#define flatbuffers_identifier 0
+#endif
+#ifndef flatbuffers_extension
+#define flatbuffers_extension ".bin"
+#endif
+
+
+typedef const struct SensorDemoAggregate_table *SensorDemoAggregate_table_t;
+typedef const flatbuffers_uoffset_t *SensorDemoAggregate_vec_t;
+typedef flatbuffers_uoffset_t *SensorDemoAggregate_mutable_vec_t;
+#ifndef SensorDemoAggregate_identifier
+#define SensorDemoAggregate_identifier flatbuffers_identifier
+#endif
+#define SensorDemoAggregate_type_hash ((flatbuffers_thash_t)0x55495223)
+#define SensorDemoAggregate_type_identifier "\x23\x52\x49\x55"
+
+
+
+struct SensorDemoAggregate_table { uint8_t unused__; };
+
+static inline size_t SensorDemoAggregate_vec_len(SensorDemoAggregate_vec_t vec)
+__flatbuffers_vec_len(vec)
+static inline SensorDemoAggregate_table_t SensorDemoAggregate_vec_at(SensorDemoAggregate_vec_t vec, size_t i)
+__flatbuffers_offset_vec_at(SensorDemoAggregate_table_t, vec, i, 0)
+__flatbuffers_table_as_root(SensorDemoAggregate)
+
+__flatbuffers_define_scalar_field(0, SensorDemoAggregate, id, flatbuffers_uint64, uint64_t, UINT64_C(0))
+__flatbuffers_define_scalar_field(1, SensorDemoAggregate, windowStart, flatbuffers_uint64, uint64_t, UINT64_C(0))
+__flatbuffers_define_scalar_field(2, SensorDemoAggregate, windowEnd, flatbuffers_uint64, uint64_t, UINT64_C(0))
+__flatbuffers_define_scalar_field(3, SensorDemoAggregate, count, flatbuffers_uint32, uint32_t, UINT32_C(0))
+__flatbuffers_define_scalar_field(4, SensorDemoAggregate, lightIntensityMin, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(5, SensorDemoAggregate, lightIntensityMax, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(6, SensorDemoAggregate, lightIntensityAvg, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(7, SensorDemoAggregate, temperatureMin, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(8, SensorDemoAggregate, temperatureMax, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(9, SensorDemoAggregate, temperatureAvg, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(10, SensorDemoAggregate, humidityMin, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(11, SensorDemoAggregate, humidityMax, flatbuffers_float, float, 0.000000f)
+__flatbuffers_define_scalar_field(12, SensorDemoAggregate, humidityAvg, flatbuffers_float, float, 0.000000f)
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* SENSORDEMOAGGREGATE_READER_H */
@@ -0,0 +1,251 @@
+#ifndef SENSORDEMOENTITY_OBX_H
+#define SENSORDEMOENTITY_OBX_H
+
+/* Generated by generate-entity-api.py from SensorDemoEntity.fbs, do not edit. */
+
+#include <stddef.h>
+#include <objectbox.h>
+
+#ifndef SENSORDEMOENTITY_BUILDER_H
+#include "SensorDemoEntity_builder.h"
+#endif
+
+#define SensorDemoEntity_entity_id 2
+
+typedef struct SensorDemoEntity {
+    uint64_t id;
+    float lightIntensity;
+    float temperature;
+    float humidity;
+    uint64_t measuredAt;
+} SensorDemoEntity_t;
+
+/* Serializes the object as root of a new buffer; every field is written, so all objects share one vtable. */
+static inline int SensorDemoEntity_build(flatcc_builder_t *B, const SensorDemoEntity_t *object)
+{
+    if (SensorDemoEntity_start_as_root(B)
+        || SensorDemoEntity_id_force_add(B, object->id)
+        || SensorDemoEntity_measuredAt_force_add(B, object->measuredAt)
+        || SensorDemoEntity_lightIntensity_force_add(B, object->lightIntensity)
+        || SensorDemoEntity_temperature_force_add(B, object->temperature)
+        || SensorDemoEntity_humidity_force_add(B, object->humidity)
+        || !SensorDemoEntity_end_as_root(B)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Reads all fields of a serialized object. */
+static inline int SensorDemoEntity_read(const void *buffer, size_t size, SensorDemoEntity_t *object)
+{
+    SensorDemoEntity_table_t t;
+    if (size < sizeof(flatbuffers_uoffset_t) || !(t = SensorDemoEntity_as_root(buffer))) return -1;
+    object->id = SensorDemoEntity_id(t);
+    object->lightIntensity = SensorDemoEntity_lightIntensity(t);
+    object->temperature = SensorDemoEntity_temperature(t);
+    object->humidity = SensorDemoEntity_humidity(t);
+    object->measuredAt = SensorDemoEntity_measuredAt(t);
+    return 0;
+}
+
+/* Adds the object to a batch (see obxc_batch()); equal strings and vectors are shared with the batch's other objects. */
+static inline obx_err SensorDemoEntity_batch_add(OBXC_batch *batch, const SensorDemoEntity_t *object)
+{
+    flatcc_builder_t *B = obxc_batch_builder(batch);
+    if (B == NULL) return obxc_last_error_code();
+    if (SensorDemoEntity_start(B)
+        || SensorDemoEntity_id_force_add(B, object->id)
+        || SensorDemoEntity_measuredAt_force_add(B, object->measuredAt)
+        || SensorDemoEntity_lightIntensity_force_add(B, object->lightIntensity)
+        || SensorDemoEntity_temperature_force_add(B, object->temperature)
+        || SensorDemoEntity_humidity_force_add(B, object->humidity)) {
+        /* marks the batch as failed, the builder is left inside an unfinished table */
+        return obxc_batch_add(batch, 0);
+    }
+    return obxc_batch_add(batch, SensorDemoEntity_end(B));
+}
+
+/* obxc_sample_build() callback for samplers buffering SensorDemoEntity_t objects, see OBXC_sampler_options. */
+static inline int SensorDemoEntity_sample_build(flatcc_builder_t *B, const void *sample)
+{
+    return SensorDemoEntity_build(B, (const SensorDemoEntity_t *) sample);
+}
+
+/* obxc_sample_add() callback for samplers uploading SensorDemoEntity_t objects in batches (OBXC_UPLOAD_BATCH). */
+static inline obx_err SensorDemoEntity_sample_add(OBXC_batch *batch, const void *sample)
+{
+    return SensorDemoEntity_batch_add(batch, (const SensorDemoEntity_t *) sample);
+}
+
+/* Columns for obxc_bytes_array_project(), extracting a field of all objects; values holds one per object. */
+static inline OBXC_column SensorDemoEntity_id_column(uint64_t *values)
+{
+    OBXC_column column = {0, sizeof(uint64_t), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoEntity_lightIntensity_column(float *values)
+{
+    OBXC_column column = {1, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoEntity_temperature_column(float *values)
+{
+    OBXC_column column = {2, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoEntity_humidity_column(float *values)
+{
+    OBXC_column column = {3, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column SensorDemoEntity_measuredAt_column(uint64_t *values)
+{
+    OBXC_column column = {4, sizeof(uint64_t), values};
+    return column;
+}
+
+/* Fields of SensorDemoEntity_t samples for aggregators, see obxc_aggregator(), and time series, see obxc_series_encode(). */
+static inline OBXC_field SensorDemoEntity_id_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoEntity_t, id), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field SensorDemoEntity_lightIntensity_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoEntity_t, lightIntensity), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoEntity_temperature_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoEntity_t, temperature), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoEntity_humidity_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoEntity_t, humidity), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field SensorDemoEntity_measuredAt_field(void)
+{
+    OBXC_field field = {offsetof(SensorDemoEntity_t, measuredAt), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+/* Fields for deadband filters on SensorDemoEntity_t samples, see obxc_deadband(). */
+static inline OBXC_deadband_field SensorDemoEntity_id_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoEntity_id_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoEntity_lightIntensity_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoEntity_lightIntensity_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoEntity_temperature_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoEntity_temperature_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoEntity_humidity_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoEntity_humidity_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field SensorDemoEntity_measuredAt_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {SensorDemoEntity_measuredAt_field(), absolute, relative};
+    return field;
+}
+
+/* Sorted indexes over the uint64 fields, see obxc_index(); the array must outlive the index. */
+static inline OBXC_index *SensorDemoEntity_id_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 0);
+}
+
+static inline OBXC_index *SensorDemoEntity_measuredAt_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 4);
+}
+
+static inline OBXC_box *SensorDemoEntity_box(OBXC_store *store)
+{
+    return obxc_box(store, SensorDemoEntity_entity_id);
+}
+
+/* Inserts the object using the box's builder; on success, object->id is set to the ID assigned by the server. */
+static inline obx_err SensorDemoEntity_put(OBXC_box *box, SensorDemoEntity_t *object)
+{
+    flatcc_builder_t *B = obxc_box_builder(box);
+    obx_err err;
+    int id;
+    if (B == NULL) return obxc_last_error_code();
+    /* a failed build leaves an unfinished buffer, which obxc_box_put_builder() rejects */
+    SensorDemoEntity_build(B, object);
+    err = obxc_box_put_builder(box, B, &id);
+    if (err == OBX_SUCCESS) object->id = (uint64_t) id;
+    return err;
+}
+
+/* Builds the template for _encode(), which is reused for all objects; free it using obxc_template_free(). */
+static inline obx_err SensorDemoEntity_template_init(OBXC_template *tpl, flatcc_builder_t *B)
+{
+    SensorDemoEntity_t zero = {0};
+    if (SensorDemoEntity_build(B, &zero)) {
+        return obxc_last_error_set(OBX_ERROR_ILLEGAL_STATE, "SensorDemoEntity: build failed");
+    }
+    return obxc_template_init(tpl, B);
+}
+
+/* Encodes the object by patching its values into the template's buffer; yields the same bytes as _build(). */
+static inline void SensorDemoEntity_encode(OBXC_template *tpl, const SensorDemoEntity_t *object)
+{
+    uint8_t *buf = (uint8_t *) tpl->buffer;
+    flatbuffers_uint64_write_to_pe(buf + tpl->field_pos[0], object->id);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[1], object->lightIntensity);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[2], object->temperature);
+    flatbuffers_float_write_to_pe(buf + tpl->field_pos[3], object->humidity);
+    flatbuffers_uint64_write_to_pe(buf + tpl->field_pos[4], object->measuredAt);
+}
+
+/* Like _put(), but encodes the object using the template instead of a builder. */
+static inline obx_err SensorDemoEntity_put_template(OBXC_box *box, OBXC_template *tpl, SensorDemoEntity_t *object)
+{
+    OBXC_bytes bytes;
+    obx_err err;
+    int id;
+    SensorDemoEntity_encode(tpl, object);
+    bytes.data = tpl->buffer;
+    bytes.size = tpl->size;
+    err = obxc_box_put(box, &bytes, &id);
+    if (err == OBX_SUCCESS) object->id = (uint64_t) id;
+    return err;
+}
+
+/* Gets the object with the given ID. */
+static inline obx_err SensorDemoEntity_get(OBXC_box *box, int id, SensorDemoEntity_t *object)
+{
+    OBXC_bytes bytes;
+    obx_err err = obxc_box_get(box, id, &bytes);
+    if (err != OBX_SUCCESS) return err;
+    if (SensorDemoEntity_read(bytes.data, bytes.size, object)) {
+        err = obxc_last_error_set(OBX_ERROR_ILLEGAL_RESPONSE, "SensorDemoEntity: invalid object");
+    }
+    obxc_bytes_free(&bytes);
+    return err;
+}
+
+#endif /* SENSORDEMOENTITY_OBX_H */
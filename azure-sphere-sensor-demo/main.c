@@ -20,14 +20,20 @@
 
 #include "SensorDemoEntity_builder.h"
 #include "SensorDemoEntity_reader.h"
+#include "SensorDemoEntity_obx.h"
+#include "SensorDemoAggregate_builder.h"
+#include "SensorDemoAggregate_reader.h"
+#include "SensorDemoAggregate_obx.h"
 
 #define OBX_TEST_SERVER_DB "test-db"
 #define OBX_TEST_SERVER_IP "192.168.178.54"
 #define OBX_TEST_SERVER_PORT 8181
 
+static OBXC_loop* event_loop = NULL;
 static volatile sig_atomic_t termination_required = false;
 static void termination_handler(int signal_number) {
 	termination_required = true;
+	if (event_loop != NULL) obxc_loop_stop(event_loop);
 }
 
 void register_sigterm_handler() {
@@ -48,28 +54,82 @@ uint64_t get_current_time_ns() {
 	return (uint64_t)t.tv_sec * 1000000000L + (uint64_t)t.tv_nsec;
 }
 
-void transmit_sensor_values(OBXC_store* store, float light_intensity, float temperature, float humidity) {
-	OBXC_bytes mem;
-	int new_id;
-
-	// initialize the flatbuffers structure
-	flatcc_builder_t builder;
-	flatcc_builder_init(&builder);
-	SensorDemoEntity_start_as_root(&builder);
-
-	// set all attributes
-	uint64_t measured_at = get_current_time_ns();
-	SensorDemoEntity_id_add(&builder, -1);
-	SensorDemoEntity_lightIntensity_add(&builder, light_intensity);
-	SensorDemoEntity_temperature_add(&builder, temperature);
-	SensorDemoEntity_humidity_add(&builder, humidity);
-	SensorDemoEntity_measuredAt_add(&builder, measured_at);
-
-	// finish populating the entity's attributes and insert it at the server
-	SensorDemoEntity_end_as_root(&builder);
-	mem.data = flatcc_builder_get_direct_buffer(&builder, &mem.size);
-	obxc_data_insert(store, 2, &mem, &new_id);
-	Log_Debug("inserted new item with %d bytes, it got id %d\n", mem.size, new_id);
+// called by the aggregator once a minute is over: uploads one object with the summary of its samples
+void transmit_window(void* user_data, const OBXC_window* window) {
+	SensorDemoAggregate_t aggregate;
+	aggregate.id = 0;
+	aggregate.windowStart = window->start;
+	aggregate.windowEnd = window->end;
+	aggregate.count = (uint32_t) window->count;
+	aggregate.lightIntensityMin = (float) window->fields[0].min;
+	aggregate.lightIntensityMax = (float) window->fields[0].max;
+	aggregate.lightIntensityAvg = (float) window->fields[0].mean;
+	aggregate.temperatureMin = (float) window->fields[1].min;
+	aggregate.temperatureMax = (float) window->fields[1].max;
+	aggregate.temperatureAvg = (float) window->fields[1].mean;
+	aggregate.humidityMin = (float) window->fields[2].min;
+	aggregate.humidityMax = (float) window->fields[2].max;
+	aggregate.humidityAvg = (float) window->fields[2].mean;
+	obxc_sampler_push((OBXC_sampler*) user_data, &aggregate);
+}
+
+void transmit_sensor_values(OBXC_aggregator* aggregator, OBXC_sampler* raw_sampler, float light_intensity,
+	float temperature, float humidity) {
+	// set all attributes (ID 0 marks a new object, the actual ID is assigned by the server)
+	SensorDemoEntity_t entity;
+	entity.id = 0;
+	entity.lightIntensity = light_intensity;
+	entity.temperature = temperature;
+	entity.humidity = humidity;
+	entity.measuredAt = get_current_time_ns();
+
+	// only updates the current minute's summary; transmit_window() is called when the minute is over
+	obxc_aggregator_add(aggregator, &entity);
+
+	// only copies the values, the sampler uploads them in the background together with the other samples
+	if (raw_sampler != NULL) obxc_sampler_push(raw_sampler, &entity);
+}
+
+typedef struct {
+	void* i2c;
+	void* light_sensor;
+	void* temp_humi_sensor;
+	OBXC_aggregator* aggregator;
+	OBXC_sampler* raw_sampler;
+} sensor_demo;
+
+// called by the event loop at fixed deadlines, so the sampling rate doesn't drift by the time spent reading sensors;
+// the sensors are read asynchronously, i.e. these are the values of the reads started at the previous tick
+void sample_sensors(void* user_data, uint64_t expirations) {
+	sensor_demo* demo = (sensor_demo*) user_data;
+	GroveI2CAsync_CheckTimeouts(demo->i2c);
+	float light_intensity = GroveAD7992_ConvertToMillisVolt(GroveLightSensor_GetValue(demo->light_sensor));
+	float temperature = GroveTempHumiSHT31_GetTemperature(demo->temp_humi_sensor);
+	float humidity = GroveTempHumiSHT31_GetHumidity(demo->temp_humi_sensor);
+	if (!isnan(light_intensity) && !isnan(temperature))
+		transmit_sensor_values(demo->aggregator, demo->raw_sampler, light_intensity, temperature, humidity);
+
+	// the I2C transactions only start here and complete in i2c_ready(), the loop stays free in between
+	GroveLightSensor_ReadAsync(demo->light_sensor, demo->i2c);
+	GroveTempHumiSHT31_ReadAsync(demo->temp_humi_sensor, demo->i2c);
+}
+
+void i2c_ready(void* user_data, int fd, uint32_t events) {
+	GroveI2CAsync_HandleEvents(user_data, (events & OBXC_WATCH_READ) != 0, (events & OBXC_WATCH_WRITE) != 0);
+}
+
+// frames are short and usually fit into the UART's buffer at once; only if not, the loop waits for it to drain
+void i2c_write_interest(void* user_data, int fd, bool want_write) {
+	sensor_demo* demo = (sensor_demo*) user_data;
+	obxc_loop_watch(event_loop, fd, OBXC_WATCH_READ | (want_write ? OBXC_WATCH_WRITE : 0), i2c_ready, demo->i2c);
+}
+
+// logs how punctual sampling is; missed ticks mean a sensor read took longer than the sampling period
+void log_sampling_jitter(void* user_data, uint64_t expirations) {
+	OBXC_timer_stats stats;
+	if (obxc_timer_stats((OBXC_timer*) user_data, &stats) != OBX_SUCCESS) return;
+	Log_Debug("sampled %" PRIu64 " times (%" PRIu64 " missed), lateness: mean %" PRIu64 " us, max %" PRIu64 " us\n",
+		stats.ticks, stats.missed, stats.mean_lateness_ns / 1000, stats.max_lateness_ns / 1000);
 }
 
 int main(int argc, char *argv[]) {
@@ -89,26 +149,115 @@ int main(int argc, char *argv[]) {
 	store_options.model.data = NULL;
 	store_options.model.size = 0;
 
+	// responses may be compressed; uploads are sent as they are, as the per-minute aggregates are far below any
+	// size worth compressing and compressed requests need a server accepting them
+	store_options.accept_encoding = 1;
+	store_options.compress_min_size = 0;
+	store_options.compress_level = 0;
+
 	// create store (make sure to execute `./objectbox-http-server 8181` on the respective server computer beforehand)
 	OBXC_store* store = obxc_store_open(&store_options);
 	if (store == NULL)
 		fail_with_output("unable to construct ObjectBox client store instance");
 
+	// by default, only a summary per minute is uploaded: min/max/avg of each value over the 1200 samples taken;
+	// summaries are sent 10 at a time, or when they're 5 minutes old, and kept for 17 hours without network;
+	// each one is inserted on its own, which any server supports (batch uploads need one providing the endpoint)
+	OBXC_sampler_options aggregate_options;
+	aggregate_options.entity_id = SensorDemoAggregate_entity_id;
+	aggregate_options.sample_size = sizeof(SensorDemoAggregate_t);
+	aggregate_options.upload = OBXC_UPLOAD_OBJECTS;
+	aggregate_options.build = SensorDemoAggregate_sample_build;
+	aggregate_options.add = NULL;
+	aggregate_options.capacity = 1024;
+	aggregate_options.flush_count = 10;
+	aggregate_options.flush_interval_ms = 300000;
+	aggregate_options.overflow = OBXC_OVERFLOW_DROP_OLDEST;
+	aggregate_options.deadband = NULL;
+	OBXC_sampler* aggregate_sampler = obxc_sampler(store, &aggregate_options);
+	if (aggregate_sampler == NULL)
+		fail_with_output("unable to construct ObjectBox client sampler instance");
+
+	OBXC_field time_field = SensorDemoEntity_measuredAt_field();
+	OBXC_field aggregate_fields[] = {
+		SensorDemoEntity_lightIntensity_field(),
+		SensorDemoEntity_temperature_field(),
+		SensorDemoEntity_humidity_field()
+	};
+	uint64_t minute_ns = 60000000000u;
+	OBXC_aggregator* aggregator = obxc_aggregator(&time_field, aggregate_fields, 3, minute_ns, minute_ns,
+		transmit_window, aggregate_sampler);
+	if (aggregator == NULL)
+		fail_with_output("unable to construct ObjectBox client aggregator");
+
+	// raw samples are only uploaded on demand, i.e. when the app is started with "--raw" (see CmdArgs in the manifest)
+	bool send_raw_samples = argc > 1 && strcmp(argv[1], "--raw") == 0;
+
+	// sample at 20 Hz independently of the network: up to 50 samples are sent per upload, at least every 2 seconds;
+	// if the server is unreachable for longer than the buffer lasts (256 samples), the oldest samples are dropped
+	OBXC_sampler* raw_sampler = NULL;
+	OBXC_sampler_options sampler_options;
+	sampler_options.entity_id = SensorDemoEntity_entity_id;
+	sampler_options.sample_size = sizeof(SensorDemoEntity_t);
+	sampler_options.upload = OBXC_UPLOAD_OBJECTS;
+	sampler_options.build = SensorDemoEntity_sample_build;
+	sampler_options.add = NULL;
+	sampler_options.capacity = 256;
+	sampler_options.flush_count = 50;
+	sampler_options.flush_interval_ms = 2000;
+	sampler_options.overflow = OBXC_OVERFLOW_DROP_OLDEST;
+
+	// most readings don't differ from the previous ones: only samples with a noticeable change are sent,
+	// and at least one per minute to show the device is alive
+	OBXC_deadband_field deadband_fields[] = {
+		SensorDemoEntity_lightIntensity_deadband(5.0, 0.02),
+		SensorDemoEntity_temperature_deadband(0.1, 0),
+		SensorDemoEntity_humidity_deadband(0.5, 0)
+	};
+	sampler_options.deadband = NULL;
+	if (send_raw_samples) {
+		sampler_options.deadband = obxc_deadband(deadband_fields, 3, 60000);
+		if (sampler_options.deadband == NULL)
+			fail_with_output("unable to construct ObjectBox client deadband filter");
+		raw_sampler = obxc_sampler(store, &sampler_options);
+		if (raw_sampler == NULL)
+			fail_with_output("unable to construct ObjectBox client sampler instance");
+	}
+
 	// test light sensor (example from https://github.com/Seeed-Studio/MT3620_Grove_Shield#usage-of-the-library-see-example---temp-and-huminidy-sht31)
 	int i2c_fd;
 	GroveShield_Initialize(&i2c_fd, 115200);
-	void* light_sensor = GroveLightSensor_Init(i2c_fd, 0);
-	void* temp_humi_sensor = GroveTempHumiSHT31_Open(i2c_fd);
-	while(1) {
-		GroveTempHumiSHT31_Read(temp_humi_sensor);
-        float light_intensity = GroveAD7992_ConvertToMillisVolt(GroveLightSensor_Read(light_sensor));
-        float temperature = GroveTempHumiSHT31_GetTemperature(temp_humi_sensor);
-        float humidity = GroveTempHumiSHT31_GetHumidity(temp_humi_sensor);
-        transmit_sensor_values(store, light_intensity, temperature, humidity);
-		usleep(500000);
-	}
+	sensor_demo demo;
+	demo.light_sensor = GroveLightSensor_Init(i2c_fd, 0);
+	demo.temp_humi_sensor = GroveTempHumiSHT31_Open(i2c_fd);
+	demo.aggregator = aggregator;
+	demo.raw_sampler = raw_sampler;
+
+	// sample at 20 Hz and report the sampling jitter once a minute; the loop sleeps until the next deadline or the
+	// I2C bridge's reply, uploads run on the samplers' threads
+	event_loop = obxc_loop();
+	if (event_loop == NULL)
+		fail_with_output("unable to construct ObjectBox client event loop");
+	demo.i2c = GroveI2CAsync_Open(i2c_fd, 8, i2c_write_interest, &demo);
+	if (demo.i2c == NULL || obxc_loop_watch(event_loop, i2c_fd, OBXC_WATCH_READ, i2c_ready, demo.i2c) != OBX_SUCCESS)
+		fail_with_output("unable to read the sensors asynchronously");
+	OBXC_timer* sample_timer = obxc_loop_timer(event_loop, 50000000, 0, sample_sensors, &demo);
+	if (sample_timer == NULL || obxc_loop_timer(event_loop, minute_ns, 0, log_sampling_jitter, sample_timer) == NULL)
+		fail_with_output("unable to construct ObjectBox client timer");
+
+	// runs until SIGTERM
+	if (!termination_required) obxc_loop_run(event_loop);
+	OBXC_loop* loop = event_loop;
+	event_loop = NULL;
+	obxc_loop_unwatch(loop, i2c_fd);
+	obxc_loop_close(loop);
+	GroveI2CAsync_Close(demo.i2c);
 
-	// "Unreachable code" because of infinite while loop above - just to illustrate how you would clean up
+	obxc_aggregator_flush(aggregator);
+	obxc_aggregator_close(aggregator);
+	obxc_sampler_close(aggregate_sampler);
+	obxc_sampler_close(raw_sampler);
+	obxc_deadband_close(sampler_options.deadband);
 	obxc_store_close(store);
 	Log_Debug("application exiting...\n");
 
@@ -0,0 +1,323 @@
+#ifndef TESTENTITY_OBX_H
+#define TESTENTITY_OBX_H
+
+/* Generated by generate-entity-api.py from TestEntity.fbs, do not edit. */
+
+#include <stddef.h>
+#include <objectbox.h>
+
+#ifndef TESTENTITY_BUILDER_H
+#include "TestEntity_builder.h"
+#endif
+
+#define TestEntity_entity_id 1
+
+typedef struct TestEntity {
+    uint64_t id;
+    flatbuffers_bool_t simpleBoolean;
+    int8_t simpleByte;
+    int16_t simpleShort;
+    int32_t simpleInt;
+    int64_t simpleLong;
+    float simpleFloat;
+    double simpleDouble;
+    const char *simpleString;
+    const int8_t *simpleByteArray;
+    size_t simpleByteArray_len;
+    uint64_t simpleDate;
+} TestEntity_t;
+
+/* Serializes the object as root of a new buffer; every field is written, so all objects share one vtable. */
+static inline int TestEntity_build(flatcc_builder_t *B, const TestEntity_t *object)
+{
+    if (TestEntity_start_as_root(B)
+        || TestEntity_id_force_add(B, object->id)
+        || TestEntity_simpleLong_force_add(B, object->simpleLong)
+        || TestEntity_simpleDouble_force_add(B, object->simpleDouble)
+        || TestEntity_simpleDate_force_add(B, object->simpleDate)
+        || TestEntity_simpleInt_force_add(B, object->simpleInt)
+        || TestEntity_simpleFloat_force_add(B, object->simpleFloat)
+        || TestEntity_simpleShort_force_add(B, object->simpleShort)
+        || TestEntity_simpleBoolean_force_add(B, object->simpleBoolean)
+        || TestEntity_simpleByte_force_add(B, object->simpleByte)
+        || (object->simpleString && TestEntity_simpleString_create_str(B, object->simpleString))
+        || (object->simpleByteArray && TestEntity_simpleByteArray_create(B, (int8_t *) object->simpleByteArray, object->simpleByteArray_len))
+        || !TestEntity_end_as_root(B)) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Reads all fields of a serialized object; strings and vectors point into the given buffer. */
+static inline int TestEntity_read(const void *buffer, size_t size, TestEntity_t *object)
+{
+    TestEntity_table_t t;
+    flatbuffers_int8_vec_t simpleByteArray;
+    if (size < sizeof(flatbuffers_uoffset_t) || !(t = TestEntity_as_root(buffer))) return -1;
+    object->id = TestEntity_id(t);
+    object->simpleBoolean = TestEntity_simpleBoolean(t);
+    object->simpleByte = TestEntity_simpleByte(t);
+    object->simpleShort = TestEntity_simpleShort(t);
+    object->simpleInt = TestEntity_simpleInt(t);
+    object->simpleLong = TestEntity_simpleLong(t);
+    object->simpleFloat = TestEntity_simpleFloat(t);
+    object->simpleDouble = TestEntity_simpleDouble(t);
+    object->simpleString = TestEntity_simpleString(t);
+    simpleByteArray = TestEntity_simpleByteArray(t);
+    object->simpleByteArray = simpleByteArray;
+    object->simpleByteArray_len = simpleByteArray ? flatbuffers_int8_vec_len(simpleByteArray) : 0;
+    object->simpleDate = TestEntity_simpleDate(t);
+    return 0;
+}
+
+/* Adds the object to a batch (see obxc_batch()); equal strings and vectors are shared with the batch's other objects. */
+static inline obx_err TestEntity_batch_add(OBXC_batch *batch, const TestEntity_t *object)
+{
+    flatcc_builder_t *B = obxc_batch_builder(batch);
+    flatcc_builder_ref_t simpleString = 0;
+    flatcc_builder_ref_t simpleByteArray = 0;
+    if (B == NULL) return obxc_last_error_code();
+    if (object->simpleString && !(simpleString = obxc_batch_string(batch, object->simpleString))) {
+        return obxc_last_error_code();
+    }
+    if (object->simpleByteArray && !(simpleByteArray = obxc_batch_vector(batch, object->simpleByteArray, object->simpleByteArray_len, 1, 1))) {
+        return obxc_last_error_code();
+    }
+    if (TestEntity_start(B)
+        || TestEntity_id_force_add(B, object->id)
+        || TestEntity_simpleLong_force_add(B, object->simpleLong)
+        || TestEntity_simpleDouble_force_add(B, object->simpleDouble)
+        || TestEntity_simpleDate_force_add(B, object->simpleDate)
+        || TestEntity_simpleInt_force_add(B, object->simpleInt)
+        || TestEntity_simpleFloat_force_add(B, object->simpleFloat)
+        || TestEntity_simpleShort_force_add(B, object->simpleShort)
+        || TestEntity_simpleBoolean_force_add(B, object->simpleBoolean)
+        || TestEntity_simpleByte_force_add(B, object->simpleByte)
+        || (simpleString && TestEntity_simpleString_add(B, simpleString))
+        || (simpleByteArray && TestEntity_simpleByteArray_add(B, simpleByteArray))) {
+        /* marks the batch as failed, the builder is left inside an unfinished table */
+        return obxc_batch_add(batch, 0);
+    }
+    return obxc_batch_add(batch, TestEntity_end(B));
+}
+
+/* obxc_sample_build() callback for samplers buffering TestEntity_t objects, see OBXC_sampler_options. */
+static inline int TestEntity_sample_build(flatcc_builder_t *B, const void *sample)
+{
+    return TestEntity_build(B, (const TestEntity_t *) sample);
+}
+
+/* obxc_sample_add() callback for samplers uploading TestEntity_t objects in batches (OBXC_UPLOAD_BATCH). */
+static inline obx_err TestEntity_sample_add(OBXC_batch *batch, const void *sample)
+{
+    return TestEntity_batch_add(batch, (const TestEntity_t *) sample);
+}
+
+/* Columns for obxc_bytes_array_project(), extracting a field of all objects; values holds one per object. */
+static inline OBXC_column TestEntity_id_column(uint64_t *values)
+{
+    OBXC_column column = {0, sizeof(uint64_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleBoolean_column(flatbuffers_bool_t *values)
+{
+    OBXC_column column = {1, sizeof(flatbuffers_bool_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleByte_column(int8_t *values)
+{
+    OBXC_column column = {2, sizeof(int8_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleShort_column(int16_t *values)
+{
+    OBXC_column column = {3, sizeof(int16_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleInt_column(int32_t *values)
+{
+    OBXC_column column = {4, sizeof(int32_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleLong_column(int64_t *values)
+{
+    OBXC_column column = {5, sizeof(int64_t), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleFloat_column(float *values)
+{
+    OBXC_column column = {6, sizeof(float), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleDouble_column(double *values)
+{
+    OBXC_column column = {7, sizeof(double), values};
+    return column;
+}
+
+static inline OBXC_column TestEntity_simpleDate_column(uint64_t *values)
+{
+    OBXC_column column = {10, sizeof(uint64_t), values};
+    return column;
+}
+
+/* Fields of TestEntity_t samples for aggregators, see obxc_aggregator(), and time series, see obxc_series_encode(). */
+static inline OBXC_field TestEntity_id_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, id), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleBoolean_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleBoolean), sizeof(flatbuffers_bool_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleByte_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleByte), sizeof(int8_t), OBXC_VALUE_SIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleShort_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleShort), sizeof(int16_t), OBXC_VALUE_SIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleInt_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleInt), sizeof(int32_t), OBXC_VALUE_SIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleLong_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleLong), sizeof(int64_t), OBXC_VALUE_SIGNED};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleFloat_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleFloat), sizeof(float), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleDouble_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleDouble), sizeof(double), OBXC_VALUE_FLOAT};
+    return field;
+}
+
+static inline OBXC_field TestEntity_simpleDate_field(void)
+{
+    OBXC_field field = {offsetof(TestEntity_t, simpleDate), sizeof(uint64_t), OBXC_VALUE_UNSIGNED};
+    return field;
+}
+
+/* Fields for deadband filters on TestEntity_t samples, see obxc_deadband(). */
+static inline OBXC_deadband_field TestEntity_id_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_id_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleBoolean_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleBoolean_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleByte_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleByte_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleShort_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleShort_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleInt_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleInt_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleLong_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleLong_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleFloat_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleFloat_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleDouble_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleDouble_field(), absolute, relative};
+    return field;
+}
+
+static inline OBXC_deadband_field TestEntity_simpleDate_deadband(double absolute, double relative)
+{
+    OBXC_deadband_field field = {TestEntity_simpleDate_field(), absolute, relative};
+    return field;
+}
+
+/* Sorted indexes over the uint64 fields, see obxc_index(); the array must outlive the index. */
+static inline OBXC_index *TestEntity_id_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 0);
+}
+
+static inline OBXC_index *TestEntity_simpleDate_index(const OBXC_bytes_array *array)
+{
+    return obxc_index(array, 10);
+}
+
+static inline OBXC_box *TestEntity_box(OBXC_store *store)
+{
+    return obxc_box(store, TestEntity_entity_id);
+}
+
+/* Inserts the object using the box's builder; on success, object->id is set to the ID assigned by the server. */
+static inline obx_err TestEntity_put(OBXC_box *box, TestEntity_t *object)
+{
+    flatcc_builder_t *B = obxc_box_builder(box);
+    obx_err err;
+    int id;
+    if (B == NULL) return obxc_last_error_code();
+    /* a failed build leaves an unfinished buffer, which obxc_box_put_builder() rejects */
+    TestEntity_build(B, object);
+    err = obxc_box_put_builder(box, B, &id);
+    if (err == OBX_SUCCESS) object->id = (uint64_t) id;
+    return err;
+}
+
+/* Gets the object with the given ID; its strings and vectors point into bytes, free it using obxc_bytes_free(). */
+static inline obx_err TestEntity_get(OBXC_box *box, int id, TestEntity_t *object, OBXC_bytes *bytes)
+{
+    obx_err err = obxc_box_get(box, id, bytes);
+    if (err != OBX_SUCCESS) return err;
+    if (TestEntity_read(bytes->data, bytes->size, object)) {
+        obxc_bytes_free(bytes);
+        return obxc_last_error_set(OBX_ERROR_ILLEGAL_RESPONSE, "TestEntity: invalid object");
+    }
+    return OBX_SUCCESS;
+}
+
+#endif /* TESTENTITY_OBX_H */
@@ -0,0 +1,52 @@
+#ifndef TESTENTITY_VERIFIER_H
+#define TESTENTITY_VERIFIER_H
+
+/* Generated by flatcc 0.5.3-pre FlatBuffers schema compiler for C by dvide.com */
+
+#ifndef TESTENTITY_READER_H
+#include "TestEntity_reader.h"
+#endif
+#include "flatcc/flatcc_verifier.h"
+#include "flatcc/flatcc_prologue.h"
+
+static int TestEntity_verify_table(flatcc_table_verifier_descriptor_t *td);
+
+static int TestEntity_verify_table(flatcc_table_verifier_descriptor_t *td)
+{
+    int ret;
+    if ((ret = flatcc_verify_field(td, 0, 8, 8) /* id */)) return ret;
+    if ((ret = flatcc_verify_field(td, 1, 1, 1) /* simpleBoolean */)) return ret;
+    if ((ret = flatcc_verify_field(td, 2, 1, 1) /* simpleByte */)) return ret;
+    if ((ret = flatcc_verify_field(td, 3, 2, 2) /* simpleShort */)) return ret;
+    if ((ret = flatcc_verify_field(td, 4, 4, 4) /* simpleInt */)) return ret;
+    if ((ret = flatcc_verify_field(td, 5, 8, 8) /* simpleLong */)) return ret;
+    if ((ret = flatcc_verify_field(td, 6, 4, 4) /* simpleFloat */)) return ret;
+    if ((ret = flatcc_verify_field(td, 7, 8, 8) /* simpleDouble */)) return ret;
+    if ((ret = flatcc_verify_string_field(td, 8, 0) /* simpleString */)) return ret;
+    if ((ret = flatcc_verify_vector_field(td, 9, 0, 1, 1, INT64_C(4294967295)) /* simpleByteArray */)) return ret;
+    if ((ret = flatcc_verify_field(td, 10, 8, 8) /* simpleDate */)) return ret;
+    return flatcc_verify_ok;
+}
+
+static inline int TestEntity_verify_as_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, TestEntity_identifier, &TestEntity_verify_table);
+}
+
+static inline int TestEntity_verify_as_typed_root(const void *buf, size_t bufsiz)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, TestEntity_type_identifier, &TestEntity_verify_table);
+}
+
+static inline int TestEntity_verify_as_root_with_identifier(const void *buf, size_t bufsiz, const char *fid)
+{
+    return flatcc_verify_table_as_root(buf, bufsiz, fid, &TestEntity_verify_table);
+}
+
+static inline int TestEntity_verify_as_root_with_type_hash(const void *buf, size_t bufsiz, flatbuffers_thash_t thash)
+{
+    return flatcc_verify_table_as_typed_root(buf, bufsiz, thash, &TestEntity_verify_table);
+}
+
+#include "flatcc/flatcc_epilogue.h"
+#endif /* TESTENTITY_VERIFIER_H */
@@ -1,10 +1,15 @@
 ﻿#include <signal.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <inttypes.h>
+#include <math.h>
 #include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
 
 #include "applibs_versions.h"
 #include "mt3620_rdb.h"
@@ -14,6 +19,8 @@
 
 #include "TestEntity_builder.h"
 #include "TestEntity_reader.h"
+#include "TestEntity_obx.h"
+#include "TestEntity_verifier.h"
 
 #define OBX_TEST_SERVER_DB "test-db"
 #define OBX_TEST_SERVER_IP "192.168.178.54"
@@ -178,6 +185,39 @@ void test_obxc_data_insert(OBXC_store* store) {
 	Log_Debug("[%s] deleted item %d and made sure that it has really been deleted\n", __FUNCTION__, newId);
 }
 
+void test_obxc_box(OBXC_store* store) {
+	OBXC_bytes mem;
+	uint64_t count, boxCount;
+	int newId;
+
+	const char itemHex[] =
+		"240000000000000000001a00280004002300220020001c00140000000000240000000c001a00"
+		"00000100000000000000a4c0410c1b221c1500000000000000009bffffff9aff990104000000"
+		"150000005465737420656e7469747920666f7220636f756e74000000";
+
+	// the box must yield the same results as the respective obxc_data_* calls
+	OBXC_box* box = obxc_box(store, 1);
+	REQUIRE(box);
+	OBX_REQUIRE(obxc_data_count(store, 1, &count));
+	OBX_REQUIRE(obxc_box_count(box, &boxCount));
+	REQUIRE(count == boxCount);
+	OBX_REQUIRE(obxc_box_get(box, 1, &mem));
+	REQUIRE(compare_bytes_and_hex(&mem, itemHex));
+	Log_Debug("[%s] counted %d items and got item 1 using the box\n", __FUNCTION__, (int)boxCount);
+
+	// consecutive calls reuse the box's URL buffer with IDs of different lengths
+	OBX_REQUIRE(obxc_box_put(box, &mem, &newId));
+	OBX_REQUIRE(obxc_box_update(box, newId, &mem));
+	obxc_bytes_free(&mem);
+	OBX_REQUIRE(obxc_box_get(box, newId, &mem));
+	obxc_bytes_free(&mem);
+	OBX_REQUIRE(obxc_box_delete(box, newId));
+	OBX_REQUIRE_ERROR(obxc_box_delete(box, newId), OBX_ERROR_ILLEGAL_RESPONSE, 404,
+		"Object with the given ID doesn't exist");
+	OBX_REQUIRE(obxc_box_close(box));
+	Log_Debug("[%s] inserted, updated and deleted item %d using the box\n", __FUNCTION__, newId);
+}
+
 void test_flatcc_reader(OBXC_store* store, int id, int simpleBooleanVal, int simpleIntVal, float simpleFloatVal, const char* simpleStringVal, uint64_t simpleDateVal) {
 	OBXC_bytes mem;
 
@@ -236,6 +276,1219 @@ void test_flatcc_writer(OBXC_store* store) {
 	flatcc_builder_clear(&builder);
 }
 
+void test_flatcc_builder_pool(OBXC_store* store) {
+	OBXC_bytes mem;
+	int newId;
+
+	// a released builder is handed out again, keeping the memory of its previous build
+	flatcc_builder_t* builder = obxc_builder_acquire(store);
+	REQUIRE(builder);
+	flatcc_builder_t* other = obxc_builder_acquire(store);
+	REQUIRE(other && other != builder);
+	obxc_builder_release(store, other);
+	obxc_builder_release(store, builder);
+	REQUIRE(obxc_builder_acquire(store) == builder);
+
+	// build and insert an entity using the pooled builder
+	TestEntity_start_as_root(builder);
+	TestEntity_simpleInt_add(builder, 7);
+	TestEntity_simpleString_create_str(builder, "pooled");
+	TestEntity_end_as_root(builder);
+	mem.data = flatcc_builder_get_direct_buffer(builder, &mem.size);
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	obxc_builder_release(store, builder);
+	Log_Debug("[%s] inserted item %d built using a pooled builder\n", __FUNCTION__, newId);
+
+	test_flatcc_reader(store, newId, 0, 7, 0.0f, "pooled", 0);
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+}
+
+void test_flatcc_streamed_insert(OBXC_store* store) {
+	OBXC_bytes mem;
+	int newId;
+	size_t size = 10000;
+	int8_t* byteArray = (int8_t*)malloc(size);
+	REQUIRE(byteArray);
+	for (size_t i = 0; i < size; i++) byteArray[i] = (int8_t)i;
+
+	// the byte array spans several emitter pages, so the buffer is not contiguous inside the builder
+	flatcc_builder_t* builder = obxc_builder_acquire(store);
+	REQUIRE(builder);
+	TestEntity_start_as_root(builder);
+	TestEntity_simpleInt_add(builder, 4711);
+	TestEntity_simpleByteArray_create(builder, byteArray, size);
+	TestEntity_end_as_root(builder);
+	REQUIRE(flatcc_builder_get_direct_buffer(builder, NULL) == NULL);
+
+	// insert it streamed from the pages, then update it the same way
+	OBX_REQUIRE(obxc_data_insert_builder(store, 1, builder, &newId));
+	OBX_REQUIRE(obxc_data_update_builder(store, 1, newId, builder));
+	obxc_builder_release(store, builder);
+	Log_Debug("[%s] inserted and updated item %d with a %d byte array\n", __FUNCTION__, newId, (int)size);
+
+	// the server must have received the complete buffer
+	OBX_REQUIRE(obxc_data_get(store, 1, newId, &mem));
+	TestEntity_table_t entity = TestEntity_as_root(mem.data);
+	REQUIRE(entity && TestEntity_simpleInt(entity) == 4711);
+	flatbuffers_int8_vec_t vec = TestEntity_simpleByteArray(entity);
+	REQUIRE(vec && flatbuffers_int8_vec_len(vec) == size && memcmp(vec, byteArray, size) == 0);
+	obxc_bytes_free(&mem);
+	free(byteArray);
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+}
+
+void test_flatcc_region_builder(OBXC_store* store) {
+	OBXC_bytes mem;
+	int newId;
+	static uint64_t region[2048];
+	static int8_t byteArray[8000];
+	for (size_t i = 0; i < sizeof(byteArray); i++) byteArray[i] = (int8_t)(i * 3);
+
+	// the object exceeds a single emitter page, but is still built contiguously inside the region
+	flatcc_builder_t builder;
+	OBXC_region_emitter emitter;
+	OBX_REQUIRE(obxc_region_builder_init(&builder, &emitter, region, sizeof(region)));
+	TestEntity_start_as_root(&builder);
+	TestEntity_simpleInt_add(&builder, 815);
+	TestEntity_simpleByteArray_create(&builder, byteArray, sizeof(byteArray));
+	TestEntity_end_as_root(&builder);
+	mem.data = obxc_region_builder_buffer(&builder, &mem.size);
+	REQUIRE(mem.data && (uint8_t*)mem.data >= (uint8_t*)region && mem.size > sizeof(byteArray));
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	Log_Debug("[%s] inserted item %d with %d bytes built in place\n", __FUNCTION__, newId, (int)mem.size);
+
+	OBX_REQUIRE(obxc_data_get(store, 1, newId, &mem));
+	TestEntity_table_t entity = TestEntity_as_root(mem.data);
+	REQUIRE(entity && TestEntity_simpleInt(entity) == 815);
+	REQUIRE(memcmp(TestEntity_simpleByteArray(entity), byteArray, sizeof(byteArray)) == 0);
+	obxc_bytes_free(&mem);
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+
+	// an object larger than the region fails cleanly and the builder can be reused afterwards
+	OBX_REQUIRE(obxc_region_builder_reset(&builder));
+	TestEntity_start_as_root(&builder);
+	TestEntity_simpleByteArray_create(&builder, byteArray, sizeof(byteArray));
+	TestEntity_simpleByteArray_create(&builder, byteArray, sizeof(byteArray));
+	TestEntity_simpleByteArray_create(&builder, byteArray, sizeof(byteArray));
+	TestEntity_end_as_root(&builder);
+	REQUIRE(obxc_region_builder_buffer(&builder, &mem.size) == NULL);
+	REQUIRE(obxc_last_error_code() == OBX_ERROR_OUT_OF_SPACE);
+	OBX_REQUIRE_ERROR(obxc_data_insert_builder(store, 1, &builder, &newId), OBX_ERROR_OUT_OF_SPACE, 0, "");
+	OBX_REQUIRE(obxc_region_builder_reset(&builder));
+	TestEntity_start_as_root(&builder);
+	TestEntity_simpleInt_add(&builder, 1);
+	TestEntity_end_as_root(&builder);
+	REQUIRE(obxc_region_builder_buffer(&builder, &mem.size) != NULL);
+	flatcc_builder_clear(&builder);
+	Log_Debug("[%s] building an object exceeding the region reported OBX_ERROR_OUT_OF_SPACE\n", __FUNCTION__);
+}
+
+void test_flatcc_builder_arena(OBXC_store* store) {
+	int newId;
+	static uint64_t arenaMemory[512];
+	static uint64_t region[512];
+
+	// all internal buffers of the builder come from the arena, the buffer itself is built in the region
+	flatcc_builder_t builder;
+	OBXC_builder_arena arena;
+	OBXC_region_emitter emitter;
+	OBX_REQUIRE(obxc_builder_arena_init(&arena, arenaMemory, sizeof(arenaMemory), NULL));
+	OBX_REQUIRE(obxc_region_builder_init(&builder, &emitter, region, sizeof(region)));
+	OBX_REQUIRE(obxc_builder_use_arena(&builder, &arena));
+
+	for (int i = 0; i < 3; i++) {
+		OBX_REQUIRE(obxc_region_builder_reset(&builder));
+		REQUIRE(TestEntity_start_as_root(&builder) == 0);
+		TestEntity_simpleInt_add(&builder, i);
+		TestEntity_simpleString_create_str(&builder, "arena");
+		REQUIRE(TestEntity_end_as_root(&builder));
+		OBX_REQUIRE(obxc_data_insert_builder(store, 1, &builder, &newId));
+		test_flatcc_reader(store, newId, 0, i, 0.0f, "arena", 0);
+		OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+	}
+	REQUIRE(arena.failures == 0);
+	for (int i = 0; i < OBXC_BUILDER_ARENA_SLICES; i++)
+		Log_Debug("[%s] buffer type %d used %d of %d bytes\n", __FUNCTION__, i, (int)arena.high_water[i], (int)arena.slice_size[i]);
+
+	// a builder that allocated on the heap already can't switch to the arena
+	OBX_REQUIRE_ERROR(obxc_builder_use_arena(&builder, &arena), OBX_ERROR_ILLEGAL_STATE, 0, "");
+	flatcc_builder_clear(&builder);
+}
+
+// builds a TestEntity with all scalar fields present, as required for templates
+int test_build_scalar_entity(flatcc_builder_t* builder, int64_t l, int i, double d, float f, int8_t b) {
+	if (TestEntity_start_as_root(builder)
+		|| TestEntity_id_force_add(builder, 0)
+		|| TestEntity_simpleLong_force_add(builder, l)
+		|| TestEntity_simpleDouble_force_add(builder, d)
+		|| TestEntity_simpleDate_force_add(builder, (uint64_t)l)
+		|| TestEntity_simpleInt_force_add(builder, i)
+		|| TestEntity_simpleFloat_force_add(builder, f)
+		|| TestEntity_simpleShort_force_add(builder, (int16_t)i)
+		|| TestEntity_simpleBoolean_force_add(builder, i & 1)
+		|| TestEntity_simpleByte_force_add(builder, b)
+		|| !TestEntity_end_as_root(builder))
+		return -1;
+	return 0;
+}
+
+void test_flatcc_template(OBXC_store* store) {
+	OBXC_template tpl;
+	OBXC_bytes mem;
+	int newId;
+
+	// patching the template must yield exactly the bytes the builder produces for the same values
+	flatcc_builder_t* builder = obxc_builder_acquire(store);
+	REQUIRE(builder && test_build_scalar_entity(builder, 0, 0, 0, 0, 0) == 0);
+	OBX_REQUIRE(obxc_template_init(&tpl, builder));
+	// field positions are indexed by the field ids from TestEntity.fbs, e.g. 4 for simpleInt
+	REQUIRE(tpl.field_count == 11 && tpl.field_pos[4] != 0);
+	for (int n = 1; n < 100; n++) {
+		uint8_t* buf = (uint8_t*)tpl.buffer;
+		flatbuffers_int64_write_to_pe(buf + tpl.field_pos[5], -n * 1000000007LL);
+		flatbuffers_uint64_write_to_pe(buf + tpl.field_pos[10], (uint64_t)(-n * 1000000007LL));
+		flatbuffers_double_write_to_pe(buf + tpl.field_pos[7], n / 3.0);
+		flatbuffers_int32_write_to_pe(buf + tpl.field_pos[4], n * 7);
+		flatbuffers_float_write_to_pe(buf + tpl.field_pos[6], n / 7.0f);
+		flatbuffers_int16_write_to_pe(buf + tpl.field_pos[3], (int16_t)(n * 7));
+		flatbuffers_bool_write_to_pe(buf + tpl.field_pos[1], (n * 7) & 1);
+		flatbuffers_int8_write_to_pe(buf + tpl.field_pos[2], (int8_t)-n);
+
+		REQUIRE(flatcc_builder_reset(builder) == 0);
+		REQUIRE(test_build_scalar_entity(builder, -n * 1000000007LL, n * 7, n / 3.0, n / 7.0f, (int8_t)-n) == 0);
+		mem.data = flatcc_builder_get_direct_buffer(builder, &mem.size);
+		REQUIRE(mem.data && mem.size == tpl.size && memcmp(mem.data, tpl.buffer, tpl.size) == 0);
+	}
+	obxc_builder_release(store, builder);
+	Log_Debug("[%s] template encoding matches the builder output\n", __FUNCTION__);
+
+	// the patched buffer is a regular object for the server
+	mem.data = tpl.buffer;
+	mem.size = tpl.size;
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	OBX_REQUIRE(obxc_data_get(store, 1, newId, &mem));
+	TestEntity_table_t entity = TestEntity_as_root(mem.data);
+	REQUIRE(entity && TestEntity_simpleInt(entity) == 99 * 7 && TestEntity_simpleByte(entity) == -99);
+	obxc_bytes_free(&mem);
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+	obxc_template_free(&tpl);
+}
+
+void test_obxc_batch(OBXC_store* store) {
+	OBXC_bytes mem;
+	obx_id ids[10];
+	const char* names[] = { "device-1", "device-2" };
+
+	// the strings are stored once in the batch, all objects refer to these copies
+	OBXC_batch* batch = obxc_batch(store);
+	REQUIRE(batch);
+	REQUIRE(obxc_batch_string(batch, names[0]) == obxc_batch_string(batch, "device-1"));
+	for (int i = 0; i < 10; i++) {
+		TestEntity_t entity;
+		memset(&entity, 0, sizeof(entity));
+		entity.simpleInt = i;
+		entity.simpleString = names[i % 2];
+		OBX_REQUIRE(TestEntity_batch_add(batch, &entity));
+	}
+	REQUIRE(obxc_batch_count(batch) == 10);
+
+	// a single request inserts all of them, afterwards the batch is empty again
+	OBXC_box* box = TestEntity_box(store);
+	REQUIRE(box);
+	OBX_REQUIRE(obxc_box_put_batch(box, batch, ids));
+	REQUIRE(obxc_batch_count(batch) == 0);
+	Log_Debug("[%s] inserted 10 items with one request, ids %d to %d\n", __FUNCTION__, (int)ids[0], (int)ids[9]);
+
+	// each object is complete on its own on the server
+	for (int i = 0; i < 10; i++) {
+		TestEntity_t read;
+		OBX_REQUIRE(TestEntity_get(box, (int)ids[i], &read, &mem));
+		REQUIRE(read.simpleInt == i && strcmp(read.simpleString, names[i % 2]) == 0);
+		obxc_bytes_free(&mem);
+		OBX_REQUIRE(obxc_box_delete(box, (int)ids[i]));
+	}
+
+	// a repeated string is serialized once: nine more objects referring to it take less than another copy of it
+	static char long_name[1001];
+	memset(long_name, 'x', sizeof(long_name) - 1);
+	TestEntity_t entity;
+	memset(&entity, 0, sizeof(entity));
+	entity.simpleString = long_name;
+	OBX_REQUIRE(TestEntity_batch_add(batch, &entity));
+	size_t single_size = flatcc_builder_get_buffer_size(obxc_batch_builder(batch));
+	for (int i = 1; i < 10; i++) {
+		entity.simpleInt = i;
+		OBX_REQUIRE(TestEntity_batch_add(batch, &entity));
+	}
+	size_t batch_size = flatcc_builder_get_buffer_size(obxc_batch_builder(batch));
+	Log_Debug("[%s] batch of 10 objects sharing a 1000 byte string: %zu bytes, a single one %zu bytes\n",
+		__FUNCTION__, batch_size, single_size);
+	REQUIRE(single_size > 1000 && batch_size - single_size < 1000);
+	OBX_REQUIRE(obxc_batch_clear(batch));
+
+	OBX_REQUIRE(obxc_box_close(box));
+	OBX_REQUIRE(obxc_batch_close(batch));
+}
+
+// a verifier rejecting every object, e.g. one of another table type
+static int reject_verifier(const void* buffer, size_t size) {
+	(void)buffer;
+	(void)size;
+	return flatcc_verify_error_type_field_absent_from_required_union_field;
+}
+
+void test_flatcc_verifier(OBXC_store* store) {
+	OBXC_bytes_array all;
+	OBXC_verify_stats stats;
+	uint64_t count;
+
+	// all objects are verified in chunks on two threads
+	OBXC_box* box = TestEntity_box(store);
+	REQUIRE(box);
+	OBX_REQUIRE(obxc_box_count(box, &count));
+	OBX_REQUIRE(obxc_box_get_all(box, &all));
+	REQUIRE(all.count == count && !all.verified_by);
+	OBX_REQUIRE(obxc_bytes_array_verify(&all, TestEntity_verify_as_root, 2, &stats));
+	REQUIRE(all.verified_by == TestEntity_verify_as_root && stats.objects == count && stats.error == flatcc_verify_ok);
+	Log_Debug("[%s] verified %d items, %d bytes in %d us\n", __FUNCTION__, (int)stats.objects, (int)stats.bytes,
+		(int)(stats.duration_ns / 1000));
+
+	// once verified, the array is trusted without verifying again
+	OBX_REQUIRE(obxc_bytes_array_verify(&all, TestEntity_verify_as_root, 2, &stats));
+	REQUIRE(stats.objects == 0);
+
+	// ... but only by the same verifier, a different one checks all objects again
+	OBX_REQUIRE_ERROR(obxc_bytes_array_verify(&all, reject_verifier, 2, &stats), OBX_ERROR_ILLEGAL_RESPONSE,
+		flatcc_verify_error_type_field_absent_from_required_union_field,
+		"object 0 failed verification: type field absent from required union field");
+	REQUIRE(all.verified_by == TestEntity_verify_as_root && stats.error_index == 0);
+
+	// a truncated object is rejected instead of being read out of bounds
+	OBXC_bytes truncated = all.bytes[0];
+	truncated.size = 8;
+	OBX_REQUIRE(obxc_bytes_verify(all.bytes, TestEntity_verify_as_root));
+	OBX_REQUIRE_ERROR(obxc_bytes_verify(&truncated, TestEntity_verify_as_root), OBX_ERROR_ILLEGAL_RESPONSE,
+		flatcc_verify_error_table_header_out_of_range_or_unaligned,
+		"object 0 failed verification: table header out of range or unaligned");
+	obxc_bytes_array_free(&all);
+	OBX_REQUIRE(obxc_box_close(box));
+}
+
+void test_obxc_data_get_all_aligned(OBXC_store* store) {
+	OBXC_bytes_array all;
+	OBXC_bytes mem;
+
+	// every object starts aligned inside the single allocation, so its 64 bit fields can be read in place
+	OBX_REQUIRE(obxc_data_get_all(store, TestEntity_entity_id, &all));
+	REQUIRE(all.count > 0 && all.baseptr);
+	for (size_t i = 0; i < all.count; i++) {
+		REQUIRE((uintptr_t)all.bytes[i].data % OBXC_BYTES_ALIGN == 0);
+		REQUIRE((char*)all.bytes[i].data >= (char*)all.baseptr);
+		TestEntity_table_t entity = TestEntity_as_root(all.bytes[i].data);
+		REQUIRE(entity);
+
+		// re-framing must not change the objects' contents
+		obx_id id = TestEntity_id(entity);
+		OBX_REQUIRE(obxc_data_get(store, TestEntity_entity_id, (int)id, &mem));
+		REQUIRE(mem.size == all.bytes[i].size && memcmp(mem.data, all.bytes[i].data, mem.size) == 0);
+		obxc_bytes_free(&mem);
+	}
+	Log_Debug("[%s] got %d aligned items\n", __FUNCTION__, (int)all.count);
+	obxc_bytes_array_free(&all);
+}
+
+void test_obxc_projection(OBXC_store* store) {
+	OBXC_bytes_array all;
+
+	// extract two fields of all items into plain arrays at once
+	OBX_REQUIRE(obxc_data_get_all(store, TestEntity_entity_id, &all));
+	REQUIRE(all.count > 0);
+	uint64_t* ids = (uint64_t*)malloc(all.count * sizeof(uint64_t));
+	int32_t* ints = (int32_t*)malloc(all.count * sizeof(int32_t));
+	REQUIRE(ids && ints);
+	OBXC_column columns[] = { TestEntity_id_column(ids), TestEntity_simpleInt_column(ints) };
+	OBX_REQUIRE(obxc_bytes_array_project(&all, columns, 2));
+
+	// the columns hold the same values as the flatcc accessors yield
+	for (size_t i = 0; i < all.count; i++) {
+		TestEntity_table_t entity = TestEntity_as_root(all.bytes[i].data);
+		REQUIRE(ids[i] == TestEntity_id(entity) && ints[i] == TestEntity_simpleInt(entity));
+	}
+	Log_Debug("[%s] projected 2 columns of %d items\n", __FUNCTION__, (int)all.count);
+
+	// a truncated object is rejected instead of being read out of bounds
+	all.bytes[0].size = 8;
+	OBX_REQUIRE_ERROR(obxc_bytes_array_project(&all, columns, 2), OBX_ERROR_ILLEGAL_RESPONSE, 0,
+		"object 0 is out of bounds");
+	free(ids);
+	free(ints);
+	obxc_bytes_array_free(&all);
+}
+
+void test_obxc_column_stats(OBXC_store* store) {
+	// synthetic sensor columns: temperatures around 20 degrees, one reading every 250 ms
+	const size_t count = 4096, rounds = 100;
+	float* temperatures = (float*)malloc(count * sizeof(float));
+	uint64_t* times = (uint64_t*)malloc(count * sizeof(uint64_t));
+	REQUIRE(temperatures && times);
+	for (size_t i = 0; i < count; i++) {
+		temperatures[i] = 20.0f + (float)(i % 97) * 0.01f;
+		times[i] = 1546300800000 + i * 250;
+	}
+
+	OBXC_float_stats stats;
+	uint64_t start = get_current_time_ns();
+	for (size_t r = 0; r < rounds; r++) OBX_REQUIRE(obxc_float_stats(temperatures, count, &stats));
+	uint64_t kernel_ns = get_current_time_ns() - start;
+
+	// the plain loop the kernel replaces
+	float min = 0, max = 0;
+	double sum = 0, sum_squares = 0;
+	start = get_current_time_ns();
+	for (size_t r = 0; r < rounds; r++) {
+		min = max = temperatures[0];
+		sum = sum_squares = 0;
+		for (size_t i = 0; i < count; i++) {
+			float value = temperatures[i];
+			if (value < min) min = value;
+			if (value > max) max = value;
+			sum += value;
+			sum_squares += (double)value * value;
+		}
+	}
+	uint64_t scalar_ns = get_current_time_ns() - start;
+	double mean = sum / count;
+	REQUIRE(stats.count == count && stats.min == min && stats.max == max);
+	REQUIRE(fabs(stats.mean - mean) < 1e-4);
+	REQUIRE(fabs(stats.variance - (sum_squares / count - mean * mean)) < 1e-4);
+	Log_Debug("[%s] %s: %d values in %d us, scalar loop %d us\n", __FUNCTION__, obxc_stats_simd(), (int)count,
+		(int)(kernel_ns / rounds / 1000), (int)(scalar_ns / rounds / 1000));
+
+	size_t above = 0;
+	for (size_t i = 0; i < count; i++) above += temperatures[i] > 20.5f;
+	REQUIRE(obxc_float_count_above(temperatures, count, 20.5f) == above);
+
+	// readings per minute: 240 in each full minute, the remainder in the last one
+	uint64_t first, last;
+	uint32_t per_minute[18];
+	OBX_REQUIRE(obxc_uint64_range(times, count, &first, &last));
+	REQUIRE(first == times[0] && last == times[count - 1]);
+	OBX_REQUIRE(obxc_uint64_buckets(times, count, first, 60000, per_minute, 18));
+	REQUIRE(per_minute[0] == 240 && per_minute[16] == 240 && per_minute[17] == count - 17 * 240);
+	OBX_REQUIRE_ERROR(obxc_uint64_buckets(times, count, first, 0, per_minute, 18), OBX_ERROR_ILLEGAL_ARGUMENT, 0, "");
+
+	free(temperatures);
+	free(times);
+}
+
+void test_obxc_index(OBXC_store* store) {
+	OBXC_bytes_array all;
+	OBX_REQUIRE(obxc_data_get_all(store, TestEntity_entity_id, &all));
+	REQUIRE(all.count > 0);
+	OBXC_index* index = TestEntity_simpleDate_index(&all);
+	REQUIRE(index);
+
+	// the whole key range yields all objects, sorted by their date
+	OBXC_index_range range;
+	OBX_REQUIRE(obxc_index_range(index, 0, UINT64_MAX, &range));
+	REQUIRE(range.count == all.count);
+	for (size_t i = 0; i < range.count; i++) {
+		REQUIRE(range.keys[i] == TestEntity_simpleDate(TestEntity_as_root(range.bytes[i].data)));
+		REQUIRE(i == 0 || range.keys[i - 1] <= range.keys[i]);
+	}
+
+	// a range query finds the same objects as a full scan
+	uint64_t min = range.keys[0], max = range.keys[range.count / 2];
+	size_t scanned = 0;
+	for (size_t i = 0; i < all.count; i++) {
+		uint64_t date = TestEntity_simpleDate(TestEntity_as_root(all.bytes[i].data));
+		scanned += date >= min && date <= max;
+	}
+	OBX_REQUIRE(obxc_index_range(index, min, max, &range));
+	REQUIRE(range.count == scanned);
+	Log_Debug("[%s] %d of %d items are in the first half of the date range\n", __FUNCTION__, (int)range.count,
+		(int)all.count);
+
+	OBX_REQUIRE(obxc_index_range(index, max + 1, min, &range));
+	REQUIRE(range.count == 0);
+	OBX_REQUIRE(obxc_index_close(index));
+	obxc_bytes_array_free(&all);
+}
+
+void test_obxc_sampler(OBXC_store* store) {
+	uint64_t count_before, count_after;
+	OBX_REQUIRE(obxc_data_count(store, TestEntity_entity_id, &count_before));
+
+	// 25 samples are uploaded 10 at a time in the background, the flush waits for the remaining 5; by default each
+	// sample is inserted with a request of its own, batch uploads (which need a server supporting them) take one
+	OBXC_sampler_options options = { .entity_id = TestEntity_entity_id, .sample_size = sizeof(TestEntity_t),
+		.build = TestEntity_sample_build, .add = TestEntity_sample_add, .capacity = 32, .flush_count = 10,
+		.flush_interval_ms = 100, .overflow = OBXC_OVERFLOW_BLOCK };
+	OBXC_sampler_upload uploads[] = { OBXC_UPLOAD_OBJECTS, OBXC_UPLOAD_BATCH };
+	for (int u = 0; u < 2; u++) {
+		options.upload = uploads[u];
+		OBXC_sampler* sampler = obxc_sampler(store, &options);
+		REQUIRE(sampler);
+		for (int i = 0; i < 25; i++) {
+			TestEntity_t sample = { 0 };
+			sample.simpleInt = i;
+			sample.simpleString = "sampled";
+			sample.simpleDate = get_current_time_ns();
+			OBX_REQUIRE(obxc_sampler_push(sampler, &sample));
+		}
+		OBX_REQUIRE(obxc_sampler_flush(sampler));
+
+		OBXC_sampler_stats stats;
+		OBX_REQUIRE(obxc_sampler_stats(sampler, &stats));
+		REQUIRE(stats.pushed == 25 && stats.uploaded == 25 && stats.dropped == 0 && stats.buffered == 0);
+		REQUIRE(stats.failed_requests == 0);
+		REQUIRE(options.upload == OBXC_UPLOAD_BATCH ? stats.requests >= 3 : stats.requests == 25);
+		OBX_REQUIRE(obxc_sampler_close(sampler));
+
+		OBX_REQUIRE(obxc_data_count(store, TestEntity_entity_id, &count_after));
+		REQUIRE(count_after == count_before + 25);
+		count_before = count_after;
+		Log_Debug("[%s] uploaded 25 samples with %d requests\n", __FUNCTION__, (int)stats.requests);
+	}
+
+	// invalid options are rejected: an upload can't be larger than the buffer, and it needs its serializer
+	options.flush_count = 33;
+	REQUIRE(obxc_sampler(store, &options) == NULL);
+	REQUIRE(obxc_last_error_code() == OBX_ERROR_ILLEGAL_ARGUMENT);
+	options.flush_count = 10;
+	options.upload = OBXC_UPLOAD_OBJECTS;
+	options.build = NULL;
+	REQUIRE(obxc_sampler(store, &options) == NULL);
+	REQUIRE(obxc_last_error_code() == OBX_ERROR_ILLEGAL_ARGUMENT);
+}
+
+void test_obxc_deadband(OBXC_store* store) {
+	// simpleFloat must change by more than 0.5, simpleInt by more than 10 %; simpleDate isn't compared at all
+	OBXC_deadband_field fields[] = { TestEntity_simpleFloat_deadband(0.5, 0), TestEntity_simpleInt_deadband(0, 0.1) };
+	OBXC_deadband* deadband = obxc_deadband(fields, 2, 0);
+	REQUIRE(deadband);
+
+	float floats[] = { 20.0f, 20.2f, 20.4f, 20.6f, 20.6f, 20.0f, 20.0f };
+	int32_t ints[] = { 100, 105, 109, 109, 121, 121, 121 };
+	int expected[] = { 1, 0, 0, 1, 1, 1, 0 };
+	int passed = 0;
+	for (int i = 0; i < 7; i++) {
+		TestEntity_t sample = { 0 };
+		sample.simpleFloat = floats[i];
+		sample.simpleInt = ints[i];
+		sample.simpleDate = get_current_time_ns();
+		REQUIRE(obxc_deadband_pass(deadband, &sample) == expected[i]);
+		passed += expected[i];
+	}
+
+	// after a reset, the next sample passes even if unchanged
+	TestEntity_t unchanged = { 0 };
+	unchanged.simpleFloat = 20.0f;
+	unchanged.simpleInt = 121;
+	REQUIRE(obxc_deadband_pass(deadband, &unchanged) == 0);
+	obxc_deadband_reset(deadband);
+	REQUIRE(obxc_deadband_pass(deadband, &unchanged) == 1);
+
+	// a reading becoming NaN (e.g. a failed sensor) passes once, staying NaN doesn't
+	unchanged.simpleFloat = NAN;
+	REQUIRE(obxc_deadband_pass(deadband, &unchanged) == 1);
+	REQUIRE(obxc_deadband_pass(deadband, &unchanged) == 0);
+	unchanged.simpleFloat = 20.0f;
+	REQUIRE(obxc_deadband_pass(deadband, &unchanged) == 1);
+	Log_Debug("[%s] %d of 7 samples passed\n", __FUNCTION__, passed);
+
+	OBX_REQUIRE(obxc_deadband_close(deadband));
+	fields[0].absolute = -1;
+	REQUIRE(obxc_deadband(fields, 2, 0) == NULL);
+	REQUIRE(obxc_last_error_code() == OBX_ERROR_ILLEGAL_ARGUMENT);
+}
+
+typedef struct {
+	int count;
+	OBXC_window windows[8];
+	OBXC_field_summary floats[8];
+} test_windows;
+
+static void test_window_collector(void* user_data, const OBXC_window* window) {
+	test_windows* windows = (test_windows*) user_data;
+	REQUIRE(windows->count < 8);
+	REQUIRE(window->field_count == 2);
+	windows->windows[windows->count] = *window;
+	windows->floats[windows->count] = window->fields[0];
+	windows->count++;
+}
+
+static void test_window_require(const test_windows* windows, int i, uint64_t start, uint64_t end, uint64_t count,
+	double min, double max, double mean) {
+	REQUIRE(windows->windows[i].start == start);
+	REQUIRE(windows->windows[i].end == end);
+	REQUIRE(windows->windows[i].count == count);
+	REQUIRE(windows->floats[i].min == min);
+	REQUIRE(windows->floats[i].max == max);
+	REQUIRE(windows->floats[i].mean == mean);
+}
+
+void test_obxc_aggregator(OBXC_store* store) {
+	// simpleDate is the time, in arbitrary units here; samples at 3, 5, 12, 18 and 35 (i.e. none from 20 to 30)
+	OBXC_field time_field = TestEntity_simpleDate_field();
+	OBXC_field fields[] = { TestEntity_simpleFloat_field(), TestEntity_simpleInt_field() };
+	uint64_t times[] = { 3, 5, 12, 18, 35 };
+	float floats[] = { 1.0f, 3.0f, 5.0f, 7.0f, 9.0f };
+
+	// tumbling windows: each sample belongs to exactly one window, empty windows are skipped
+	test_windows tumbling = { 0 };
+	OBXC_aggregator* aggregator = obxc_aggregator(&time_field, fields, 2, 10, 10, test_window_collector, &tumbling);
+	REQUIRE(aggregator);
+	for (int i = 0; i < 5; i++) {
+		TestEntity_t sample = { 0 };
+		sample.simpleDate = times[i];
+		sample.simpleFloat = floats[i];
+		sample.simpleInt = -(int32_t) i;
+		OBX_REQUIRE(obxc_aggregator_add(aggregator, &sample));
+	}
+	REQUIRE(tumbling.count == 2);
+	test_window_require(&tumbling, 0, 0, 10, 2, 1.0, 3.0, 2.0);
+	test_window_require(&tumbling, 1, 10, 20, 2, 5.0, 7.0, 6.0);
+	REQUIRE(tumbling.windows[1].fields != NULL);
+
+	// a sample for an already emitted window is rejected
+	TestEntity_t late = { 0 };
+	late.simpleDate = 25;
+	OBX_REQUIRE_ERROR(obxc_aggregator_add(aggregator, &late), OBX_ERROR_STD_OUT_OF_RANGE, 0, "");
+
+	// flushing emits the incomplete window of the last sample
+	OBX_REQUIRE(obxc_aggregator_flush(aggregator));
+	REQUIRE(tumbling.count == 3);
+	test_window_require(&tumbling, 2, 30, 40, 1, 9.0, 9.0, 9.0);
+	OBX_REQUIRE(obxc_aggregator_close(aggregator));
+
+	// sliding windows of 20 every 10: every sample is part of two windows
+	test_windows sliding = { 0 };
+	aggregator = obxc_aggregator(&time_field, fields, 2, 20, 10, test_window_collector, &sliding);
+	REQUIRE(aggregator);
+	for (int i = 0; i < 5; i++) {
+		TestEntity_t sample = { 0 };
+		sample.simpleDate = times[i];
+		sample.simpleFloat = floats[i];
+		OBX_REQUIRE(obxc_aggregator_add(aggregator, &sample));
+	}
+	OBX_REQUIRE(obxc_aggregator_flush(aggregator));
+	REQUIRE(sliding.count == 5);
+	test_window_require(&sliding, 0, 0, 10, 2, 1.0, 3.0, 2.0);
+	test_window_require(&sliding, 1, 0, 20, 4, 1.0, 7.0, 4.0);
+	test_window_require(&sliding, 2, 10, 30, 2, 5.0, 7.0, 6.0);
+	test_window_require(&sliding, 3, 20, 40, 1, 9.0, 9.0, 9.0);
+	test_window_require(&sliding, 4, 30, 50, 1, 9.0, 9.0, 9.0);
+	Log_Debug("[%s] %d tumbling and %d sliding windows\n", __FUNCTION__, tumbling.count, sliding.count);
+	OBX_REQUIRE(obxc_aggregator_close(aggregator));
+
+	// the window must be a multiple of the hop
+	REQUIRE(obxc_aggregator(&time_field, fields, 2, 25, 10, test_window_collector, &sliding) == NULL);
+	REQUIRE(obxc_last_error_code() == OBX_ERROR_ILLEGAL_ARGUMENT);
+}
+
+typedef struct {
+	OBXC_loop* loop;
+	OBXC_timer* timer;
+	int fd;
+	int ticks;
+	int reads;
+	OBXC_timer_stats stats;
+} test_loop_state;
+
+static void test_loop_tick(void* user_data, uint64_t expirations) {
+	test_loop_state* state = (test_loop_state*) user_data;
+	state->ticks++;
+
+	// spend part of the period like a slow sensor read would; the following deadlines must not shift by it
+	usleep(3000);
+
+	// signal the watched fd half way through, stop after 20 ticks
+	uint64_t one = 1;
+	if (state->ticks == 10) REQUIRE(write(state->fd, &one, sizeof(one)) == sizeof(one));
+	if (state->ticks == 20) {
+		OBX_REQUIRE(obxc_timer_stats(state->timer, &state->stats));
+		OBX_REQUIRE(obxc_timer_close(state->timer));
+		OBX_REQUIRE(obxc_loop_stop(state->loop));
+	}
+}
+
+static void test_loop_readable(void* user_data, int fd, uint32_t events) {
+	test_loop_state* state = (test_loop_state*) user_data;
+	uint64_t value;
+	REQUIRE(fd == state->fd);
+	REQUIRE(events & OBXC_WATCH_READ);
+	REQUIRE(read(fd, &value, sizeof(value)) == sizeof(value));
+	state->reads++;
+}
+
+void test_obxc_event_loop(OBXC_store* store) {
+	test_loop_state state = { 0 };
+	state.loop = obxc_loop();
+	REQUIRE(state.loop);
+	state.fd = eventfd(0, EFD_NONBLOCK);
+	REQUIRE(state.fd >= 0);
+	OBX_REQUIRE(obxc_loop_watch(state.loop, state.fd, OBXC_WATCH_READ, test_loop_readable, &state));
+
+	// 20 ticks every 10 ms take at least 200 ms; the 3 ms spent in each callback don't add up, but as the scheduler may
+	// delay any tick, the lateness is only logged
+	uint64_t start = get_current_time_ns();
+	state.timer = obxc_loop_timer(state.loop, 10000000, 0, test_loop_tick, &state);
+	REQUIRE(state.timer);
+	OBX_REQUIRE(obxc_loop_run(state.loop));
+	uint64_t elapsed_ms = (get_current_time_ns() - start) / 1000000;
+	REQUIRE(state.ticks == 20);
+	REQUIRE(state.reads == 1);
+	REQUIRE(elapsed_ms >= 200);
+	REQUIRE(state.stats.ticks == 20);
+	Log_Debug("[%s] 20 ticks of 10 ms took %" PRIu64 " ms, lateness: mean %" PRIu64 " us, max %" PRIu64 " us, "
+		"%" PRIu64 " missed\n", __FUNCTION__, elapsed_ms, state.stats.mean_lateness_ns / 1000,
+		state.stats.max_lateness_ns / 1000, state.stats.missed);
+
+	// the loop stopped from a signal handler (or another thread) returns right away if the stop came first
+	OBX_REQUIRE(obxc_loop_stop(state.loop));
+	OBX_REQUIRE(obxc_loop_run(state.loop));
+
+	OBX_REQUIRE(obxc_loop_unwatch(state.loop, state.fd));
+	OBX_REQUIRE_ERROR(obxc_loop_unwatch(state.loop, state.fd), OBX_ERROR_ILLEGAL_ARGUMENT, 0, "");
+	OBX_REQUIRE(obxc_loop_close(state.loop));
+	close(state.fd);
+}
+
+typedef struct {
+	OBXC_ring* ring;
+	OBXC_store* store;
+	atomic_int done;
+	int inserted;
+	uint64_t insert_ns;
+} test_ring_consumer;
+
+// the upload side: inserts each record with its own request, i.e. much slower than the producer
+static void* test_ring_consume(void* arg) {
+	test_ring_consumer* consumer = (test_ring_consumer*) arg;
+	OBXC_box* box = TestEntity_box(consumer->store);
+	TestEntity_t records[8];
+	size_t count;
+	while (true) {
+		int done = atomic_load(&consumer->done);
+		OBX_REQUIRE(obxc_ring_pop(consumer->ring, records, 8, &count));
+		if (count == 0 && done) break;
+		if (count == 0) usleep(1000);
+		for (size_t i = 0; i < count; i++) {
+			uint64_t start = get_current_time_ns();
+			OBX_REQUIRE(TestEntity_put(box, &records[i]));
+			consumer->insert_ns += get_current_time_ns() - start;
+			consumer->inserted++;
+		}
+	}
+	obxc_box_close(box);
+	return NULL;
+}
+
+// acquisition at 1 kHz: pushes produced samples and measures the time each push takes
+static void test_ring_produce(OBXC_ring* ring, int produced, uint64_t* push_sum_ns, uint64_t* push_max_ns) {
+	*push_sum_ns = 0;
+	*push_max_ns = 0;
+	for (int i = 0; i < produced; i++) {
+		TestEntity_t sample = { 0 };
+		sample.simpleInt = i;
+		sample.simpleDate = get_current_time_ns();
+		obx_err err = obxc_ring_push(ring, &sample);
+		uint64_t push_ns = get_current_time_ns() - sample.simpleDate;
+		REQUIRE(err == OBX_SUCCESS || err == OBX_ERROR_OUT_OF_SPACE);
+		*push_sum_ns += push_ns;
+		if (push_ns > *push_max_ns) *push_max_ns = push_ns;
+		usleep(1000);
+	}
+}
+
+void test_obxc_ring(OBXC_store* store) {
+	// FIFO order, drops when full (the capacity is rounded up to 4) and wrapping around
+	OBXC_ring* ring = obxc_ring(sizeof(int), 3);
+	REQUIRE(ring);
+	for (int i = 0; i < 4; i++) OBX_REQUIRE(obxc_ring_push(ring, &i));
+	int five = 5;
+	OBX_REQUIRE_ERROR(obxc_ring_push(ring, &five), OBX_ERROR_OUT_OF_SPACE, 0, "");
+	int values[4];
+	size_t count;
+	OBX_REQUIRE(obxc_ring_pop(ring, values, 3, &count));
+	REQUIRE(count == 3 && values[0] == 0 && values[1] == 1 && values[2] == 2);
+	for (int i = 4; i < 7; i++) OBX_REQUIRE(obxc_ring_push(ring, &i));
+	OBX_REQUIRE(obxc_ring_pop(ring, values, 4, &count));
+	REQUIRE(count == 4 && values[0] == 3 && values[1] == 4 && values[2] == 5 && values[3] == 6);
+	OBX_REQUIRE(obxc_ring_pop(ring, values, 4, &count));
+	REQUIRE(count == 0);
+
+	OBXC_ring_stats stats;
+	OBX_REQUIRE(obxc_ring_stats(ring, &stats));
+	REQUIRE(stats.pushed == 7 && stats.popped == 7 && stats.dropped == 1);
+	REQUIRE(stats.depth == 0 && stats.max_depth == 4 && stats.capacity == 4);
+	OBX_REQUIRE(obxc_ring_close(ring));
+
+	// the baseline: pushing while nothing is uploaded, into a ring large enough to take all samples
+	int produced = 1000;
+	uint64_t base_sum_ns;
+	uint64_t base_max_ns;
+	OBXC_ring* baseline = obxc_ring(sizeof(TestEntity_t), produced);
+	REQUIRE(baseline);
+	test_ring_produce(baseline, produced, &base_sum_ns, &base_max_ns);
+	OBX_REQUIRE(obxc_ring_stats(baseline, &stats));
+	REQUIRE(stats.pushed == (uint64_t) produced && stats.dropped == 0);
+	OBX_REQUIRE(obxc_ring_close(baseline));
+
+	// the same while another thread inserts the records one by one: pushing doesn't wait for the inserts, however
+	// long they take; what doesn't fit into the ring is dropped
+	test_ring_consumer consumer = { 0 };
+	consumer.ring = obxc_ring(sizeof(TestEntity_t), 256);
+	consumer.store = store;
+	REQUIRE(consumer.ring);
+	pthread_t thread;
+	REQUIRE(pthread_create(&thread, NULL, test_ring_consume, &consumer) == 0);
+
+	uint64_t push_sum_ns;
+	uint64_t push_max_ns;
+	test_ring_produce(consumer.ring, produced, &push_sum_ns, &push_max_ns);
+	atomic_store(&consumer.done, 1);
+	REQUIRE(pthread_join(thread, NULL) == 0);
+
+	OBX_REQUIRE(obxc_ring_stats(consumer.ring, &stats));
+	REQUIRE(stats.pushed + stats.dropped == (uint64_t) produced);
+	REQUIRE(stats.popped == stats.pushed && consumer.inserted == (int) stats.pushed);
+	Log_Debug("[%s] push without uploads: mean %d ns, max %d ns\n", __FUNCTION__, (int) (base_sum_ns / produced),
+		(int) base_max_ns);
+	Log_Debug("[%s] push: mean %d ns, max %d ns; insert: mean %d us; %d inserted, %d dropped, max depth %d\n",
+		__FUNCTION__, (int) (push_sum_ns / produced), (int) push_max_ns,
+		consumer.inserted ? (int) (consumer.insert_ns / consumer.inserted / 1000) : 0, consumer.inserted,
+		(int) stats.dropped, (int) stats.max_depth);
+	OBX_REQUIRE(obxc_ring_close(consumer.ring));
+}
+
+static uint32_t test_read_le(const uint8_t* data, int size) {
+	uint32_t value = 0;
+	for (int i = size - 1; i >= 0; i--) value = (value << 8) | data[i];
+	return value;
+}
+
+void test_obxc_trace(OBXC_store* store) {
+	OBX_REQUIRE(obxc_trace_enable(256));
+
+	// the application records the acquisition, the sampler all following stages
+	OBXC_sampler_options options = { .entity_id = TestEntity_entity_id, .sample_size = sizeof(TestEntity_t),
+		.build = TestEntity_sample_build, .capacity = 32, .flush_count = 10, .flush_interval_ms = 100,
+		.overflow = OBXC_OVERFLOW_BLOCK };
+	OBXC_sampler* sampler = obxc_sampler(store, &options);
+	REQUIRE(sampler);
+	for (int i = 0; i < 20; i++) {
+		uint32_t trace_id = obxc_trace_id();
+		REQUIRE(trace_id != 0);
+		obxc_trace(trace_id, OBXC_TRACE_ACQUIRE);
+		TestEntity_t sample = { 0 };
+		sample.simpleInt = i;
+		sample.simpleDate = get_current_time_ns();
+		OBX_REQUIRE(obxc_sampler_push_traced(sampler, &sample, trace_id));
+	}
+	OBX_REQUIRE(obxc_sampler_flush(sampler));
+	OBX_REQUIRE(obxc_sampler_close(sampler));
+
+	// 20 traces with 6 stages each, and every trace's stages in order; see misc/trace-histogram.py for the analysis
+	OBXC_bytes dump;
+	OBX_REQUIRE(obxc_trace_dump(&dump));
+	const uint8_t* data = (const uint8_t*) dump.data;
+	REQUIRE(dump.size == 12 + 20 * 6 * 13);
+	REQUIRE(memcmp(data, "OBXT", 4) == 0 && test_read_le(data + 4, 2) == 1 && test_read_le(data + 6, 2) == 6);
+	REQUIRE(test_read_le(data + 8, 4) == 20 * 6);
+	uint32_t first_id = test_read_le(data + 12, 4);
+	uint64_t last_ns[20] = { 0 };
+	int stages[20] = { 0 };
+	for (int i = 0; i < 20 * 6; i++) {
+		const uint8_t* event = data + 12 + i * 13;
+		uint32_t trace = test_read_le(event, 4) - first_id;
+		uint64_t time_ns = ((uint64_t) test_read_le(event + 9, 4) << 32) | test_read_le(event + 5, 4);
+		REQUIRE(trace < 20);
+		REQUIRE(event[4] == stages[trace]);
+		REQUIRE(time_ns >= last_ns[trace]);
+		stages[trace]++;
+		last_ns[trace] = time_ns;
+	}
+	Log_Debug("[%s] traced 20 samples, dump of %d bytes\n", __FUNCTION__, (int) dump.size);
+	obxc_bytes_free(&dump);
+
+	// disabled tracing hands out no IDs
+	OBX_REQUIRE(obxc_trace_enable(0));
+	REQUIRE(obxc_trace_id() == 0);
+	OBX_REQUIRE_ERROR(obxc_trace_dump(&dump), OBX_ERROR_ILLEGAL_STATE, 0, "");
+}
+
+typedef struct test_reading {
+	int64_t id;
+	uint64_t measuredAt;
+	float lightIntensity;
+	float temperature;
+	float humidity;
+	int16_t rssi;
+	double battery;
+} test_reading;
+
+static void test_series_round_trip(const test_reading* readings, size_t count, const OBXC_field* fields,
+	size_t field_count, test_reading* decoded) {
+	OBXC_bytes block;
+	OBX_REQUIRE(obxc_series_encode(readings, count, sizeof(test_reading), fields, field_count, &block));
+	size_t decoded_count = 0;
+	OBX_REQUIRE(obxc_series_count(block.data, block.size, &decoded_count));
+	REQUIRE(decoded_count == count);
+	memset(decoded, 0, count * sizeof(test_reading));
+	OBX_REQUIRE(obxc_series_decode(block.data, block.size, decoded, count, sizeof(test_reading), fields, field_count,
+		&decoded_count));
+	REQUIRE(decoded_count == count);
+	REQUIRE(count == 0 || memcmp(readings, decoded, count * sizeof(test_reading)) == 0);
+	obxc_bytes_free(&block);
+}
+
+void test_obxc_series(OBXC_store* store) {
+	OBXC_field fields[] = {
+		{ offsetof(test_reading, id), 8, OBXC_VALUE_SIGNED },
+		{ offsetof(test_reading, measuredAt), 8, OBXC_VALUE_UNSIGNED },
+		{ offsetof(test_reading, lightIntensity), 4, OBXC_VALUE_FLOAT },
+		{ offsetof(test_reading, temperature), 4, OBXC_VALUE_FLOAT },
+		{ offsetof(test_reading, humidity), 4, OBXC_VALUE_FLOAT },
+		{ offsetof(test_reading, rssi), 2, OBXC_VALUE_SIGNED },
+		{ offsetof(test_reading, battery), 8, OBXC_VALUE_FLOAT },
+	};
+	size_t field_count = sizeof(fields) / sizeof(fields[0]);
+
+	// a 20 Hz trace as read from the demo's sensors: timestamps jittering by up to 200 us, temperature and humidity
+	// quantized like the SHT31's 16 bit readings, light like the 12 bit ADC, all drifting slowly with some noise
+	size_t count = 20 * 60 * 10;
+	test_reading* readings = (test_reading*) calloc(count, sizeof(test_reading));
+	test_reading* decoded = (test_reading*) calloc(count, sizeof(test_reading));
+	REQUIRE(readings && decoded);
+	uint32_t random = 12345;
+	int temperature_raw = 26000, humidity_raw = 30000, light_raw = 1200;
+	for (size_t i = 0; i < count; i++) {
+		random = random * 1103515245 + 12345;
+		readings[i].id = 1000 + (int64_t) i;
+		readings[i].measuredAt = 1600000000000000000ull + i * 50000000ull + (random >> 8) % 200000;
+		if (i % 50 == 0) temperature_raw += (int) (random >> 28) % 3 - 1;
+		if (i % 80 == 0) humidity_raw += (int) (random >> 26) % 5 - 2;
+		if (i % 10 == 0) light_raw += (int) (random >> 29) % 3 - 1;
+		readings[i].temperature = (float) (temperature_raw + (int) (random >> 30) % 2) * 175 / 0xffff - 45;
+		readings[i].humidity = (float) humidity_raw * 100 / 0xffff;
+		readings[i].lightIntensity = (float) light_raw * 2500 / 4095;
+		readings[i].rssi = (int16_t) (-60 - (int) (random >> 29));
+		readings[i].battery = 3.7 - (double) (i / 1000) * 0.01;
+	}
+	test_series_round_trip(readings, count, fields, field_count, decoded);
+
+	// edge cases: no and a single sample, extreme integers and deltas, NaN payloads, infinities and negative zero
+	test_series_round_trip(readings, 0, fields, field_count, decoded);
+	test_series_round_trip(readings, 1, fields, field_count, decoded);
+	test_reading edge[8];
+	memset(edge, 0, sizeof(edge));
+	uint32_t nan_bits[] = { 0x7fc00000, 0x7fc00001, 0xffffffff, 0x7f800000, 0xff800000, 0x80000000, 0x00000001, 0 };
+	for (int i = 0; i < 8; i++) {
+		edge[i].id = i % 2 ? INT64_MIN : INT64_MAX;
+		edge[i].measuredAt = i % 3 ? UINT64_MAX - (uint64_t) i : (uint64_t) i * i * i * 1000003;
+		edge[i].rssi = (int16_t) (i % 2 ? INT16_MIN : INT16_MAX);
+		memcpy(&edge[i].temperature, nan_bits + i, 4);
+		memcpy(&edge[i].humidity, nan_bits + 7 - i, 4);
+		edge[i].lightIntensity = (float) i;
+		edge[i].battery = i % 2 ? -0.0 : 1e300;
+	}
+	test_series_round_trip(edge, 8, fields, field_count, decoded);
+
+	// decoding needs the same fields and enough room; truncated blocks are detected
+	OBXC_bytes block;
+	OBX_REQUIRE(obxc_series_encode(readings, 100, sizeof(test_reading), fields, field_count, &block));
+	size_t decoded_count = 0;
+	OBX_REQUIRE_ERROR(obxc_series_decode(block.data, block.size, decoded, 100, sizeof(test_reading), fields, 4,
+		&decoded_count), OBX_ERROR_ILLEGAL_ARGUMENT, 0, "");
+	OBX_REQUIRE_ERROR(obxc_series_decode(block.data, block.size, decoded, 99, sizeof(test_reading), fields,
+		field_count, &decoded_count), OBX_ERROR_OUT_OF_SPACE, 0, "");
+	OBX_REQUIRE_ERROR(obxc_series_decode(block.data, block.size / 2, decoded, 100, sizeof(test_reading), fields,
+		field_count, &decoded_count), OBX_ERROR_FILE_CORRUPT, 0, "");
+	obxc_bytes_free(&block);
+
+	// compression and throughput for the fields the demo uploads, compared to their raw 20 bytes per sample
+	OBXC_field demo_fields[] = { fields[1], fields[2], fields[3], fields[4] };
+	uint64_t start = get_current_time_ns();
+	OBX_REQUIRE(obxc_series_encode(readings, count, sizeof(test_reading), demo_fields, 4, &block));
+	uint64_t encode_ns = get_current_time_ns() - start;
+	start = get_current_time_ns();
+	OBX_REQUIRE(obxc_series_decode(block.data, block.size, decoded, count, sizeof(test_reading), demo_fields, 4,
+		&decoded_count));
+	uint64_t decode_ns = get_current_time_ns() - start;
+	REQUIRE(decoded_count == count);
+	size_t raw_size = count * (8 + 3 * 4);
+	Log_Debug("[%s] %d samples: %d bytes instead of %d (%.1fx, %.2f bytes per sample); encode %d, decode %d samples/ms\n",
+		__FUNCTION__, (int) count, (int) block.size, (int) raw_size, (double) raw_size / block.size,
+		(double) block.size / count, (int) (count * 1000000 / (encode_ns + 1)), (int) (count * 1000000 / (decode_ns + 1)));
+	obxc_bytes_free(&block);
+	free(readings);
+	free(decoded);
+}
+
+static const char* test_compression_names[] = { "sensor-hall", "sensor-kitchen", "sensor-garage" };
+static void test_compression_reading(TestEntity_t* entity, int i) {
+	memset(entity, 0, sizeof(TestEntity_t));
+	entity->simpleInt = i;
+	entity->simpleLong = 1000 + i / 10;
+	entity->simpleFloat = 21.5f + (float) (i % 7) * 0.01f;
+	entity->simpleDate = 1600000000000000000ull + (uint64_t) i * 50000000ull;
+	entity->simpleString = test_compression_names[i % 3];
+}
+
+// compressed requests need a server accepting them (e.g. misc/loopback-server.py) and the library built with
+// OBXC_WITH_ZLIB, else they are sent as they are; likewise, responses are only compressed if the server supports it
+void test_obxc_compression(OBXC_store* store) {
+	char base_url[128];
+	snprintf(base_url, 128, "http://%s:%d/api/v2", OBX_TEST_SERVER_IP, OBX_TEST_SERVER_PORT);
+	OBXC_store_options options;
+	memset(&options, 0, sizeof(options));
+	options.base_url = base_url;
+	options.db = OBX_TEST_SERVER_DB;
+	options.user = "";
+	options.pass = "";
+	options.accept_encoding = 1;
+
+	// the same batch of sensor-like readings uploaded without compression and with increasing levels: bytes saved
+	// vs. the CPU time spent on it, which is what counts on an MT3620
+	int levels[] = { -1, 1, 6, 9 };
+	int count = 200;
+	obx_id* ids = (obx_id*) malloc(count * sizeof(obx_id));
+	REQUIRE(ids);
+	for (int l = 0; l < 4; l++) {
+		options.compress_min_size = levels[l] < 0 ? 0 : 1024;
+		options.compress_level = levels[l] < 0 ? 0 : levels[l];
+		OBXC_store* compressing = obxc_store_open(&options);
+		REQUIRE(compressing);
+		OBXC_batch* batch = obxc_batch(compressing);
+		REQUIRE(batch);
+		for (int i = 0; i < count; i++) {
+			TestEntity_t entity;
+			test_compression_reading(&entity, i);
+			OBX_REQUIRE(TestEntity_batch_add(batch, &entity));
+		}
+		OBXC_box* box = TestEntity_box(compressing);
+		REQUIRE(box);
+		uint64_t start = get_current_time_ns();
+		OBX_REQUIRE(obxc_box_put_batch(box, batch, ids));
+		uint64_t put_ns = get_current_time_ns() - start;
+
+		OBXC_transfer_stats stats;
+		OBX_REQUIRE(obxc_store_transfer_stats(compressing, &stats));
+		REQUIRE(stats.sent_bytes <= stats.sent_raw_bytes && (levels[l] >= 0 || stats.compress_ns == 0));
+		Log_Debug("[%s] level %d: put %d bytes as %d (%d%%), compressing took %d us (%d us/KB), put %d ms\n",
+			__FUNCTION__, levels[l], (int) stats.sent_raw_bytes, (int) stats.sent_bytes,
+			(int) (stats.sent_bytes * 100 / stats.sent_raw_bytes), (int) (stats.compress_ns / 1000),
+			(int) (stats.compress_ns / (stats.sent_raw_bytes + 1023) * 1024 / 1000), (int) (put_ns / 1000000));
+
+		for (int i = 0; i < count; i++) OBX_REQUIRE(obxc_box_delete(box, (int) ids[i]));
+		OBX_REQUIRE(obxc_box_close(box));
+		OBX_REQUIRE(obxc_batch_close(batch));
+		OBX_REQUIRE(obxc_store_close(compressing));
+	}
+
+	// levels zlib doesn't know are rejected
+	options.compress_level = 10;
+	REQUIRE(obxc_store_open(&options) == NULL && obxc_last_error_code() == OBX_ERROR_ILLEGAL_ARGUMENT);
+	options.compress_level = 9;
+
+	// objects read back are decompressed transparently
+	OBXC_store* compressing = obxc_store_open(&options);
+	REQUIRE(compressing);
+	OBXC_box* box = TestEntity_box(compressing);
+	REQUIRE(box);
+	for (int i = 0; i < count; i++) {
+		TestEntity_t entity;
+		test_compression_reading(&entity, i);
+		OBX_REQUIRE(TestEntity_put(box, &entity));
+		ids[i] = entity.id;
+	}
+	OBXC_transfer_stats before, after;
+	OBX_REQUIRE(obxc_store_transfer_stats(compressing, &before));
+	OBXC_bytes_array all;
+	OBX_REQUIRE(obxc_data_get_all(compressing, TestEntity_entity_id, &all));
+	REQUIRE(all.count >= (size_t) count);
+	OBX_REQUIRE(obxc_store_transfer_stats(compressing, &after));
+	Log_Debug("[%s] get all: %d objects, received %d bytes as %d\n", __FUNCTION__, (int) all.count,
+		(int) (after.received_raw_bytes - before.received_raw_bytes),
+		(int) (after.received_bytes - before.received_bytes));
+	obxc_bytes_array_free(&all);
+	for (int i = 0; i < count; i++) OBX_REQUIRE(obxc_box_delete(box, (int) ids[i]));
+
+	// a buffer streamed from the builder's pages is compressed while it's sent, never held as a whole
+	size_t size = 10000;
+	int8_t* byteArray = (int8_t*) calloc(size, 1);
+	REQUIRE(byteArray);
+	flatcc_builder_t* builder = obxc_builder_acquire(compressing);
+	REQUIRE(builder);
+	TestEntity_start_as_root(builder);
+	TestEntity_simpleByteArray_create(builder, byteArray, size);
+	TestEntity_end_as_root(builder);
+	int newId;
+	OBX_REQUIRE(obxc_store_transfer_stats(compressing, &before));
+	OBX_REQUIRE(obxc_data_insert_builder(compressing, TestEntity_entity_id, builder, &newId));
+	OBX_REQUIRE(obxc_store_transfer_stats(compressing, &after));
+	obxc_builder_release(compressing, builder);
+	REQUIRE(after.sent_bytes - before.sent_bytes < (after.sent_raw_bytes - before.sent_raw_bytes) / 10);
+	OBXC_bytes mem;
+	OBX_REQUIRE(obxc_data_get(compressing, TestEntity_entity_id, newId, &mem));
+	flatbuffers_int8_vec_t vec = TestEntity_simpleByteArray(TestEntity_as_root(mem.data));
+	REQUIRE(vec && flatbuffers_int8_vec_len(vec) == size && memcmp(vec, byteArray, size) == 0);
+	Log_Debug("[%s] streamed %d bytes as %d\n", __FUNCTION__, (int) (after.sent_raw_bytes - before.sent_raw_bytes),
+		(int) (after.sent_bytes - before.sent_bytes));
+	obxc_bytes_free(&mem);
+	free(byteArray);
+	OBX_REQUIRE(obxc_data_delete(compressing, TestEntity_entity_id, newId));
+
+	OBX_REQUIRE(obxc_box_close(box));
+	OBX_REQUIRE(obxc_store_close(compressing));
+	free(ids);
+}
+
+void test_obxc_data_changes(OBXC_store* store) {
+	OBXC_bytes mem;
+	OBXC_change_array changes;
+	int newId;
+
+	// catch up with all existing changes first, the returned sequence number is the starting point
+	OBX_REQUIRE(obxc_data_changes(store, 1, 0, 0, &changes));
+	uint64_t seq = changes.seq;
+	obxc_change_array_free(&changes);
+	Log_Debug("[%s] change feed is at sequence number %" PRIu64 "\n", __FUNCTION__, seq);
+
+	// insert a copy of item 1, it must be the only change reported after the sequence number
+	OBX_REQUIRE(obxc_data_get(store, 1, 1, &mem));
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	OBX_REQUIRE(obxc_data_changes(store, 1, seq, 0, &changes));
+	REQUIRE(changes.count == 1);
+	REQUIRE(changes.changes[0].type == OBXC_CHANGE_PUT);
+	REQUIRE(changes.changes[0].id == (obx_id) newId);
+	REQUIRE(changes.changes[0].data.size == mem.size);
+	REQUIRE(changes.seq > seq);
+	seq = changes.seq;
+	obxc_change_array_free(&changes);
+	obxc_bytes_free(&mem);
+	Log_Debug("[%s] inserted item %d was reported as put\n", __FUNCTION__, newId);
+
+	// deleting it must be reported as well, without any object data
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+	OBX_REQUIRE(obxc_data_changes(store, 1, seq, 0, &changes));
+	REQUIRE(changes.count == 1);
+	REQUIRE(changes.changes[0].type == OBXC_CHANGE_REMOVE);
+	REQUIRE(changes.changes[0].id == (obx_id) newId);
+	REQUIRE(changes.changes[0].data.size == 0);
+	obxc_change_array_free(&changes);
+	Log_Debug("[%s] deleted item %d was reported as remove\n", __FUNCTION__, newId);
+}
+
+typedef struct {
+	int puts;
+	int removes;
+} test_sync_counts;
+
+static int test_sync_visitor(void* user_data, const OBXC_change* change) {
+	test_sync_counts* counts = (test_sync_counts*)user_data;
+	if (change->type == OBXC_CHANGE_PUT) ++counts->puts;
+	if (change->type == OBXC_CHANGE_REMOVE) ++counts->removes;
+	return 1;
+}
+
+void test_obxc_sync_since(OBXC_store* store) {
+	OBXC_bytes mem;
+	int newId;
+	test_sync_counts counts = { 0, 0 };
+
+	// a full sync from the beginning brings the client up to date
+	uint64_t seq = 0;
+	OBX_REQUIRE(obxc_sync_since(store, 1, &seq, test_sync_visitor, &counts));
+	REQUIRE(counts.puts > 0);
+	Log_Debug("[%s] initial sync visited %d puts and %d removes up to %" PRIu64 "\n", __FUNCTION__, counts.puts,
+		counts.removes, seq);
+
+	// afterwards, only the churn is transferred: one put and its tombstone
+	OBX_REQUIRE(obxc_data_get(store, 1, 1, &mem));
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+	obxc_bytes_free(&mem);
+	counts.puts = counts.removes = 0;
+	OBX_REQUIRE(obxc_sync_since(store, 1, &seq, test_sync_visitor, &counts));
+	REQUIRE(counts.puts == 1 && counts.removes == 1);
+
+	// syncing again without new changes must not visit anything
+	counts.puts = counts.removes = 0;
+	OBX_REQUIRE(obxc_sync_since(store, 1, &seq, test_sync_visitor, &counts));
+	REQUIRE(counts.puts == 0 && counts.removes == 0);
+	Log_Debug("[%s] incremental sync only visited the changes of item %d\n", __FUNCTION__, newId);
+}
+
+static atomic_int test_observer_puts;
+static void test_observer_callback(void* user_data, int entityId, const OBXC_change_array* changes) {
+	for (size_t i = 0; i < changes->count; ++i) {
+		if (changes->changes[i].type == OBXC_CHANGE_PUT) atomic_fetch_add(&test_observer_puts, 1);
+	}
+}
+
+void test_obxc_observe(OBXC_store* store) {
+	OBXC_bytes mem;
+	int newId;
+
+	// give the observer time to fetch its starting sequence number, then insert an item
+	atomic_store(&test_observer_puts, 0);
+	OBXC_observer* observer = obxc_observe(store, 1, test_observer_callback, NULL);
+	REQUIRE(observer);
+	sleep(1);
+	OBX_REQUIRE(obxc_data_get(store, 1, 1, &mem));
+	OBX_REQUIRE(obxc_data_insert(store, 1, &mem, &newId));
+	obxc_bytes_free(&mem);
+
+	// the pending long-poll must deliver the change without waiting for the poll to time out
+	for (int i = 0; i < 20 && atomic_load(&test_observer_puts) == 0; ++i) usleep(100000);
+	REQUIRE(atomic_load(&test_observer_puts) == 1);
+	OBX_REQUIRE(obxc_observer_close(observer));
+	OBX_REQUIRE(obxc_data_delete(store, 1, newId));
+	Log_Debug("[%s] observer got notified about item %d\n", __FUNCTION__, newId);
+}
+
+void test_generated_entity_api(OBXC_store* store) {
+	OBXC_bytes mem;
+	int8_t byteArray[] = { 1, -2, 3 };
+
+	// insert an object from its struct, the server assigns its ID
+	OBXC_box* box = TestEntity_box(store);
+	REQUIRE(box);
+	TestEntity_t entity;
+	memset(&entity, 0, sizeof(entity));
+	entity.simpleBoolean = 1;
+	entity.simpleInt = 42;
+	entity.simpleDouble = 2.718281828;
+	entity.simpleString = "Generated";
+	entity.simpleByteArray = byteArray;
+	entity.simpleByteArray_len = 3;
+	entity.simpleDate = get_current_time_ns();
+	OBX_REQUIRE(TestEntity_put(box, &entity));
+	REQUIRE(entity.id != 0);
+	Log_Debug("[%s] inserted a new item from its struct, it got id %d\n", __FUNCTION__, (int)entity.id);
+
+	// read it back into a struct and compare all fields
+	TestEntity_t read;
+	OBX_REQUIRE(TestEntity_get(box, (int)entity.id, &read, &mem));
+	REQUIRE(read.id == entity.id);
+	REQUIRE(read.simpleBoolean == 1 && read.simpleInt == 42 && read.simpleDouble == entity.simpleDouble);
+	REQUIRE(strcmp(read.simpleString, entity.simpleString) == 0);
+	REQUIRE(read.simpleByteArray_len == 3 && memcmp(read.simpleByteArray, byteArray, 3) == 0);
+	REQUIRE(read.simpleDate == entity.simpleDate);
+	obxc_bytes_free(&mem);
+
+	// a second put reuses the box's builder
+	entity.id = 0;
+	OBX_REQUIRE(TestEntity_put(box, &entity));
+	OBX_REQUIRE(obxc_box_delete(box, (int)read.id));
+	OBX_REQUIRE(obxc_box_delete(box, (int)entity.id));
+	OBX_REQUIRE(obxc_box_close(box));
+	Log_Debug("[%s] read back all fields and deleted the items again\n", __FUNCTION__);
+}
+
 int main(int argc, char *argv[]) {
     Log_Debug("application starting...\n");
 	register_sigterm_handler();
@@ -252,6 +1505,9 @@ int main(int argc, char *argv[]) {
 	store_options.pass = "";
 	store_options.model.data = NULL;
 	store_options.model.size = 0;
+	store_options.accept_encoding = 1;
+	store_options.compress_min_size = 0;
+	store_options.compress_level = 0;
 
 	// create store (make sure to execute `./objectbox-http-server ../path/to/test-db/ 8181` on the respective server computer beforehand)
 	OBXC_store* store = obxc_store_open(&store_options);
@@ -263,10 +1519,34 @@ int main(int argc, char *argv[]) {
 	test_obxc_data_get(store);
 	test_obxc_data_remove_update(store);
 	test_obxc_data_insert(store);
+	test_obxc_box(store);
+	test_obxc_data_changes(store);
+	test_obxc_sync_since(store);
+	test_obxc_observe(store);
 
 	// execute test cases with flatcc
 	test_flatcc_reader(store, 1, 1, -101, 0.0f, "Test entity for count", 1521128273709482148L);
 	test_flatcc_writer(store);
+	test_flatcc_builder_pool(store);
+	test_flatcc_streamed_insert(store);
+	test_flatcc_region_builder(store);
+	test_flatcc_builder_arena(store);
+	test_flatcc_template(store);
+	test_generated_entity_api(store);
+	test_obxc_batch(store);
+	test_flatcc_verifier(store);
+	test_obxc_data_get_all_aligned(store);
+	test_obxc_projection(store);
+	test_obxc_column_stats(store);
+	test_obxc_index(store);
+	test_obxc_sampler(store);
+	test_obxc_deadband(store);
+	test_obxc_aggregator(store);
+	test_obxc_event_loop(store);
+	test_obxc_ring(store);
+	test_obxc_trace(store);
+	test_obxc_series(store);
+	test_obxc_compression(store);
 
 	// eventually close store
 	obxc_store_close(store);
@@ -9,6 +9,8 @@
 
 #include "HAL/GroveUART.h"
 #include "HAL/GroveI2C.h"
+#include "HAL/GroveI2CAsync.h"
+#include "HAL/GroveI2CBatch.h"
 #include "HAL/GroveShield.h"
 
 #include "Common/Delay.h"
@@ -4,6 +4,9 @@
 #include <stdbool.h>
 #include <string.h>
 #include "GroveUART.h"
+#include "GroveI2CBatch.h"
+
+#define BATCH_TIMEOUT_MS		100
 
 ////////////////////////////////////////////////////////////////////////////////
 // SC18IM700
@@ -107,6 +110,11 @@ void SC18IM700_WriteRegBytes(int fd, uint8_t *data, uint8_t dataSize)
 void(*GroveI2C_Write)(int fd, uint8_t address, const uint8_t* data, int dataSize) = SC18IM700_I2cWrite;
 bool(*GroveI2C_Read)(int fd, uint8_t address, uint8_t* data, int dataSize) = SC18IM700_I2cRead;
 
+bool GroveI2C_UsesSC18IM700(void)
+{
+	return GroveI2C_Write == SC18IM700_I2cWrite && GroveI2C_Read == SC18IM700_I2cRead;
+}
+
 void GroveI2C_WriteReg8(int fd, uint8_t address, uint8_t reg, uint8_t val)
 {
 	uint8_t send[2];
@@ -123,12 +131,26 @@ void GroveI2C_WriteBytes(int fd, uint8_t address, uint8_t *data, uint8_t dataSiz
 	GroveI2C_Write(fd, address, send, (int)sizeof(send));
 }
 
-bool GroveI2C_ReadReg8(int fd, uint8_t address, uint8_t reg, uint8_t* val)
+// with the SC18IM700 functions in place, a register read is a single batch: one frame and one reply instead of a
+// write frame, state polls and a read frame
+bool GroveI2C_ReadRegBytes(int fd, uint8_t address, uint8_t reg, uint8_t* data, int dataSize)
 {
+	if (GroveI2C_UsesSC18IM700())
+	{
+		GroveI2CBatch batch;
+		GroveI2CBatch_Init(&batch);
+		GroveI2CBatch_ReadReg(&batch, address, reg, data, dataSize);
+		return GroveI2CBatch_Execute(fd, &batch, BATCH_TIMEOUT_MS);
+	}
+
 	GroveI2C_Write(fd, address, &reg, 1);
+	return GroveI2C_Read(fd, address, data, dataSize);
+}
 
+bool GroveI2C_ReadReg8(int fd, uint8_t address, uint8_t reg, uint8_t* val)
+{
 	uint8_t recv[1];
-	if (!GroveI2C_Read(fd, address, recv, sizeof(recv))) return false;
+	if (!GroveI2C_ReadRegBytes(fd, address, reg, recv, sizeof(recv))) return false;
 
 	*val = recv[0];
 
@@ -137,10 +159,8 @@ bool GroveI2C_ReadReg8(int fd, uint8_t address, uint8_t reg, uint8_t* val)
 
 bool GroveI2C_ReadReg16(int fd, uint8_t address, uint8_t reg, uint16_t* val)
 {
-	GroveI2C_Write(fd, address, &reg, 1);
-
 	uint8_t recv[2];
-	if (!GroveI2C_Read(fd, address, recv, sizeof(recv))) return false;
+	if (!GroveI2C_ReadRegBytes(fd, address, reg, recv, sizeof(recv))) return false;
 
 	*val = (uint16_t)(recv[1] << 8 | recv[0]);
 
@@ -149,10 +169,8 @@ bool GroveI2C_ReadReg16(int fd, uint8_t address, uint8_t reg, uint16_t* val)
 
 bool GroveI2C_ReadReg24BE(int fd, uint8_t address, uint8_t reg, uint32_t* val)
 {
-	GroveI2C_Write(fd, address, &reg, 1);
-
 	uint8_t recv[3];
-	if (!GroveI2C_Read(fd, address, recv, sizeof(recv))) return false;
+	if (!GroveI2C_ReadRegBytes(fd, address, reg, recv, sizeof(recv))) return false;
 
 	*val = (uint32_t)(recv[0] << 16 | recv[1] << 8 | recv[2]);
 
@@ -17,9 +17,13 @@ void SC18IM700_WriteRegBytes(int fd, uint8_t *data, uint8_t dataSize);
 void(*GroveI2C_Write)(int fd, uint8_t address, const uint8_t* data, int dataSize);
 bool(*GroveI2C_Read)(int fd, uint8_t address, uint8_t* data, int dataSize);
 
+// true while GroveI2C_Write and GroveI2C_Read are the SC18IM700 functions, i.e. GroveI2CBatch may be used
+bool GroveI2C_UsesSC18IM700(void);
+
 void GroveI2C_WriteReg8(int fd, uint8_t address, uint8_t reg, uint8_t val);
 void GroveI2C_WriteBytes(int fd, uint8_t address, uint8_t *data, uint8_t dataSize);
 
+bool GroveI2C_ReadRegBytes(int fd, uint8_t address, uint8_t reg, uint8_t* data, int dataSize);
 bool GroveI2C_ReadReg8(int fd, uint8_t address, uint8_t reg, uint8_t* val);
 bool GroveI2C_ReadReg16(int fd, uint8_t address, uint8_t reg, uint16_t* val);
 bool GroveI2C_ReadReg24BE(int fd, uint8_t address, uint8_t reg, uint32_t* val);
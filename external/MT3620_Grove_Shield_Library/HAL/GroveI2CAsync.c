@@ -0,0 +1,301 @@
+#include "GroveI2CAsync.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// write part, read part and the status register query
+#define MAX_FRAME_SIZE			(4 + GROVE_I2C_ASYNC_MAX_DATA + 4 + 3)
+
+#define STATE_REGISTER			0x0A
+
+typedef struct
+{
+	uint8_t Address;
+	uint8_t WriteData[GROVE_I2C_ASYNC_MAX_DATA];
+	int WriteSize;
+	int ReadSize;
+	int TimeoutMs;
+	GroveI2CAsync_Callback Callback;
+	void* UserData;
+}
+GroveI2CAsyncTransaction;
+
+typedef struct
+{
+	int Fd;
+	GroveI2CAsync_WriteInterest WriteInterest;
+	void* UserData;
+	bool WantWrite;
+
+	// ring of queued transactions; the one at QueueHead is in flight if InFlight is set
+	GroveI2CAsyncTransaction* Queue;
+	int QueueSize;
+	int QueueHead;
+	int QueueCount;
+	bool InFlight;
+
+	// frame of the transaction in flight and its reply: the bytes read followed by the I2C state
+	uint8_t Out[MAX_FRAME_SIZE];
+	int OutSize;
+	int OutSent;
+	uint8_t In[GROVE_I2C_ASYNC_MAX_DATA + 1];
+	int InSize;
+	int Expected;
+	struct timespec Deadline;
+}
+GroveI2CAsyncInstance;
+
+static void Flush(GroveI2CAsyncInstance* this);
+
+static void SetWantWrite(GroveI2CAsyncInstance* this, bool wantWrite)
+{
+	if (this->WantWrite == wantWrite) return;
+	this->WantWrite = wantWrite;
+	if (this->WriteInterest != NULL) this->WriteInterest(this->UserData, this->Fd, wantWrite);
+}
+
+static bool DeadlinePassed(const struct timespec* deadline)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+// discards bytes still arriving for a transaction that timed out, so they aren't taken for the next reply
+static void DrainInput(GroveI2CAsyncInstance* this)
+{
+	uint8_t discard[16];
+	while (read(this->Fd, discard, sizeof(discard)) > 0);
+}
+
+static bool IsFinalState(uint8_t state)
+{
+	return state == I2C_OK || state == I2C_NACK_ON_ADDRESS || state == I2C_NACK_ON_DATA || state == I2C_TIME_OUT;
+}
+
+static void AppendStateQuery(GroveI2CAsyncInstance* this)
+{
+	this->Out[this->OutSize++] = 'R';
+	this->Out[this->OutSize++] = STATE_REGISTER;
+	this->Out[this->OutSize++] = 'P';
+}
+
+static void StartNext(GroveI2CAsyncInstance* this)
+{
+	if (this->InFlight || this->QueueCount == 0) return;
+	GroveI2CAsyncTransaction* t = &this->Queue[this->QueueHead];
+
+	DrainInput(this);
+
+	// one frame for the whole transaction: the bridge executes the commands in order and replies with the bytes
+	// read followed by the state register, which tells whether the device acknowledged
+	this->OutSize = 0;
+	this->OutSent = 0;
+	if (t->WriteSize > 0)
+	{
+		this->Out[this->OutSize++] = 'S';
+		this->Out[this->OutSize++] = t->Address & 0xfe;
+		this->Out[this->OutSize++] = (uint8_t)t->WriteSize;
+		memcpy(&this->Out[this->OutSize], t->WriteData, (size_t)t->WriteSize);
+		this->OutSize += t->WriteSize;
+		this->Out[this->OutSize++] = 'P';
+	}
+	if (t->ReadSize > 0)
+	{
+		this->Out[this->OutSize++] = 'S';
+		this->Out[this->OutSize++] = t->Address | 0x01;
+		this->Out[this->OutSize++] = (uint8_t)t->ReadSize;
+		this->Out[this->OutSize++] = 'P';
+	}
+	AppendStateQuery(this);
+
+	this->InSize = 0;
+	this->Expected = t->ReadSize + 1;
+	clock_gettime(CLOCK_MONOTONIC, &this->Deadline);
+	this->Deadline.tv_sec += t->TimeoutMs / 1000;
+	this->Deadline.tv_nsec += (long)(t->TimeoutMs % 1000) * 1000000;
+	if (this->Deadline.tv_nsec >= 1000000000)
+	{
+		this->Deadline.tv_sec++;
+		this->Deadline.tv_nsec -= 1000000000;
+	}
+	this->InFlight = true;
+
+	Flush(this);
+}
+
+static void Complete(GroveI2CAsyncInstance* this, uint8_t state)
+{
+	GroveI2CAsyncTransaction t = this->Queue[this->QueueHead];
+	this->QueueHead = (this->QueueHead + 1) % this->QueueSize;
+	this->QueueCount--;
+	this->InFlight = false;
+	this->OutSize = 0;
+	this->OutSent = 0;
+	SetWantWrite(this, false);
+
+	if (t.Callback != NULL) t.Callback(t.UserData, state, this->In, state == I2C_OK ? t.ReadSize : 0);
+
+	StartNext(this);
+}
+
+static void Flush(GroveI2CAsyncInstance* this)
+{
+	while (this->OutSent < this->OutSize)
+	{
+		ssize_t written = write(this->Fd, &this->Out[this->OutSent], (size_t)(this->OutSize - this->OutSent));
+		if (written < 0)
+		{
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				SetWantWrite(this, true);
+				return;
+			}
+			if (errno == EINTR) continue;
+			Complete(this, I2C_NO_REPLY);
+			return;
+		}
+		this->OutSent += (int)written;
+	}
+	SetWantWrite(this, false);
+}
+
+static bool Enqueue(GroveI2CAsyncInstance* this, uint8_t address, const uint8_t* data, int writeSize, int readSize,
+	int timeoutMs, GroveI2CAsync_Callback callback, void* userData)
+{
+	if (this->QueueCount == this->QueueSize) return false;
+	if (writeSize < 0 || writeSize > GROVE_I2C_ASYNC_MAX_DATA) return false;
+	if (readSize < 0 || readSize > GROVE_I2C_ASYNC_MAX_DATA) return false;
+
+	GroveI2CAsyncTransaction* t = &this->Queue[(this->QueueHead + this->QueueCount) % this->QueueSize];
+	t->Address = address;
+	if (writeSize > 0) memcpy(t->WriteData, data, (size_t)writeSize);
+	t->WriteSize = writeSize;
+	t->ReadSize = readSize;
+	t->TimeoutMs = timeoutMs;
+	t->Callback = callback;
+	t->UserData = userData;
+	this->QueueCount++;
+
+	StartNext(this);
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GroveI2CAsync
+
+void* GroveI2CAsync_Open(int fd, int queueSize, GroveI2CAsync_WriteInterest writeInterest, void* userData)
+{
+	if (queueSize <= 0) return NULL;
+
+	int flags = fcntl(fd, F_GETFL, 0);
+	if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return NULL;
+
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)calloc(1, sizeof(GroveI2CAsyncInstance));
+	if (this == NULL) return NULL;
+	this->Queue = (GroveI2CAsyncTransaction*)calloc((size_t)queueSize, sizeof(GroveI2CAsyncTransaction));
+	if (this->Queue == NULL)
+	{
+		free(this);
+		return NULL;
+	}
+
+	this->Fd = fd;
+	this->WriteInterest = writeInterest;
+	this->UserData = userData;
+	this->QueueSize = queueSize;
+
+	return this;
+}
+
+void GroveI2CAsync_Close(void* inst)
+{
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)inst;
+	if (this == NULL) return;
+
+	free(this->Queue);
+	free(this);
+}
+
+bool GroveI2CAsync_Write(void* inst, uint8_t address, const uint8_t* data, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData)
+{
+	return Enqueue((GroveI2CAsyncInstance*)inst, address, data, dataSize, 0, timeoutMs, callback, userData);
+}
+
+bool GroveI2CAsync_Read(void* inst, uint8_t address, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData)
+{
+	return Enqueue((GroveI2CAsyncInstance*)inst, address, NULL, 0, dataSize, timeoutMs, callback, userData);
+}
+
+bool GroveI2CAsync_ReadReg(void* inst, uint8_t address, uint8_t reg, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData)
+{
+	return Enqueue((GroveI2CAsyncInstance*)inst, address, &reg, 1, dataSize, timeoutMs, callback, userData);
+}
+
+void GroveI2CAsync_HandleEvents(void* inst, bool readable, bool writable)
+{
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)inst;
+
+	if (writable && this->InFlight) Flush(this);
+	if (!readable) return;
+
+	if (!this->InFlight)
+	{
+		DrainInput(this);
+		return;
+	}
+
+	while (this->InFlight && this->InSize < this->Expected)
+	{
+		ssize_t readSize = read(this->Fd, &this->In[this->InSize], (size_t)(this->Expected - this->InSize));
+		if (readSize <= 0) return;
+		this->InSize += (int)readSize;
+		if (this->InSize < this->Expected) continue;
+
+		// the bridge hasn't finished the I2C transfer yet: ask again, the reply replaces the state byte
+		uint8_t state = this->In[this->InSize - 1];
+		if (!IsFinalState(state))
+		{
+			this->InSize--;
+			this->OutSize = 0;
+			this->OutSent = 0;
+			AppendStateQuery(this);
+			Flush(this);
+			continue;
+		}
+		Complete(this, state);
+	}
+}
+
+void GroveI2CAsync_CheckTimeouts(void* inst)
+{
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)inst;
+	if (!this->InFlight || !DeadlinePassed(&this->Deadline)) return;
+
+	// a NACKed read returns only the state, which can't be told from a data byte until no more bytes arrive
+	GroveI2CAsyncTransaction* t = &this->Queue[this->QueueHead];
+	uint8_t state = I2C_NO_REPLY;
+	if (t->ReadSize > 0 && this->InSize == 1 && this->In[0] != I2C_OK && IsFinalState(this->In[0]))
+	{
+		state = this->In[0];
+	}
+	Complete(this, state);
+}
+
+int GroveI2CAsync_Pending(void* inst)
+{
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)inst;
+	return this->QueueCount;
+}
+
+int GroveI2CAsync_Free(void* inst)
+{
+	GroveI2CAsyncInstance* this = (GroveI2CAsyncInstance*)inst;
+	return this->QueueSize - this->QueueCount;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "GroveI2C.h"
+
+// Asynchronous I2C transactions through the SC18IM700 bridge: transactions are queued and sent one at a time over
+// the UART, whose fd is switched to non-blocking mode. Instead of waiting for the reply, the application's event
+// loop calls GroveI2CAsync_HandleEvents when the fd is ready and the transaction completes with its callback.
+// Once opened, the synchronous GroveI2C functions must no longer be used with the same fd.
+
+#define I2C_NO_REPLY					0xFF
+
+#define GROVE_I2C_ASYNC_MAX_DATA		32
+
+// state: I2C_OK, an error reported by the bridge (I2C_NACK_ON_ADDRESS, I2C_NACK_ON_DATA, I2C_TIME_OUT) or
+// I2C_NO_REPLY if the bridge didn't reply within the timeout; data: the bytes read, only valid during the call
+typedef void(*GroveI2CAsync_Callback)(void* userData, uint8_t state, const uint8_t* data, int dataSize);
+
+// called whenever the fd needs (or no longer needs) to be watched for writability, i.e. a frame didn't fit into
+// the UART's send buffer at once
+typedef void(*GroveI2CAsync_WriteInterest)(void* userData, int fd, bool wantWrite);
+
+void* GroveI2CAsync_Open(int fd, int queueSize, GroveI2CAsync_WriteInterest writeInterest, void* userData);
+void GroveI2CAsync_Close(void* inst);
+
+// Queue a transaction; return false if the queue is full or dataSize exceeds GROVE_I2C_ASYNC_MAX_DATA.
+// The callback may be NULL and may queue further transactions, but must not close the instance.
+bool GroveI2CAsync_Write(void* inst, uint8_t address, const uint8_t* data, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData);
+bool GroveI2CAsync_Read(void* inst, uint8_t address, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData);
+bool GroveI2CAsync_ReadReg(void* inst, uint8_t address, uint8_t reg, int dataSize, int timeoutMs,
+	GroveI2CAsync_Callback callback, void* userData);
+
+// To be called by the event loop when the fd is readable (always watched) or writable (see WriteInterest)
+void GroveI2CAsync_HandleEvents(void* inst, bool readable, bool writable);
+
+// To be called periodically, e.g. from a timer: fails the transaction in flight with I2C_NO_REPLY once its timeout
+// is over. A read NACKed by the device returns no data at all, so it is only reported here.
+void GroveI2CAsync_CheckTimeouts(void* inst);
+
+int GroveI2CAsync_Pending(void* inst);
+
+// Free queue slots, e.g. to check that all transactions of a sequence fit before queueing the first one
+int GroveI2CAsync_Free(void* inst);
@@ -0,0 +1,211 @@
+#include "GroveI2CBatch.h"
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "GroveUART.h"
+
+#define STATE_REGISTER			0x0A
+
+static bool IsFinalState(uint8_t state)
+{
+	return state == I2C_OK || state == I2C_NACK_ON_ADDRESS || state == I2C_NACK_ON_DATA || state == I2C_TIME_OUT;
+}
+
+static int64_t NowMs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+// discards bytes left over from an earlier exchange that timed out, so they aren't taken for the reply
+static void DrainInput(int fd)
+{
+	uint8_t discard[16];
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	while (poll(&pfd, 1, 0) > 0 && read(fd, discard, sizeof(discard)) > 0);
+}
+
+// reads until size bytes arrived or the deadline passed; returns the number of bytes read
+static int ReadReply(int fd, uint8_t* data, int size, int64_t deadline)
+{
+	int total = 0;
+	while (total < size)
+	{
+		int64_t remaining = deadline - NowMs();
+		if (remaining <= 0) break;
+
+		struct pollfd pfd = { .fd = fd, .events = POLLIN };
+		int ready = poll(&pfd, 1, (int)remaining);
+		if (ready < 0 && errno == EINTR) continue;
+		if (ready <= 0) break;
+
+		ssize_t readSize = read(fd, &data[total], (size_t)(size - total));
+		if (readSize < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+		if (readSize <= 0) break;
+		total += (int)readSize;
+	}
+	return total;
+}
+
+static bool Append(GroveI2CBatch* batch, const uint8_t* data, int dataSize)
+{
+	if (batch->FrameSize + dataSize > GROVE_I2C_BATCH_MAX_FRAME) return false;
+	memcpy(&batch->Frame[batch->FrameSize], data, (size_t)dataSize);
+	batch->FrameSize += dataSize;
+	return true;
+}
+
+// one op: an optional write part, an optional read part (with a repeated start if both are given) and a state
+// register query, which the bridge answers after the bytes read
+static int AddOp(GroveI2CBatch* batch, uint8_t address, const uint8_t* data, int dataSize, uint8_t* readData,
+	int readSize)
+{
+	if (batch->Overflow) return -1;
+
+	int frameSize = batch->FrameSize;
+	bool ok = batch->OpCount < GROVE_I2C_BATCH_MAX_OPS && dataSize <= 255 && readSize <= 255 &&
+		batch->ReplySize + readSize + 1 <= GROVE_I2C_BATCH_MAX_REPLY;
+	if (ok && (dataSize > 0 || readSize == 0))
+	{
+		uint8_t start[3] = { 'S', (uint8_t)(address & 0xfe), (uint8_t)dataSize };
+		ok = Append(batch, start, sizeof(start)) && (dataSize == 0 || Append(batch, data, dataSize));
+	}
+	if (ok && readSize > 0)
+	{
+		uint8_t start[3] = { 'S', (uint8_t)(address | 0x01), (uint8_t)readSize };
+		ok = Append(batch, start, sizeof(start));
+	}
+	const uint8_t end[4] = { 'P', 'R', STATE_REGISTER, 'P' };
+	ok = ok && Append(batch, end, sizeof(end));
+	if (!ok)
+	{
+		batch->FrameSize = frameSize;
+		batch->Overflow = true;
+		return -1;
+	}
+
+	GroveI2CBatchOp* op = &batch->Ops[batch->OpCount];
+	op->Address = address;
+	op->ReadData = readData;
+	op->ReadSize = readSize;
+	op->State = I2C_NOT_EXECUTED;
+	batch->ReplySize += readSize + 1;
+	return batch->OpCount++;
+}
+
+// Finds where the ops' replies start, from op on at pos: each op returns the bytes read followed by its state, but a
+// read NACKed by the device returns the state only. Prefers complete replies, so a complete reply is taken as is.
+// The last op's state may still be non-final (the bridge hasn't finished the transfer), Execute then queries it again.
+static bool MatchReply(const GroveI2CBatch* batch, const uint8_t* reply, int replySize, int op, int pos, int* starts)
+{
+	if (op == batch->OpCount) return pos == replySize;
+	int readSize = batch->Ops[op].ReadSize;
+	starts[op] = pos;
+
+	int statePos = pos + readSize;
+	bool lastState = op + 1 == batch->OpCount && statePos + 1 == replySize;
+	if (statePos < replySize && (IsFinalState(reply[statePos]) || lastState) &&
+		MatchReply(batch, reply, replySize, op + 1, statePos + 1, starts)) return true;
+
+	// NACKed read: only the error state
+	return readSize > 0 && pos < replySize && reply[pos] != I2C_OK && IsFinalState(reply[pos]) &&
+		MatchReply(batch, reply, replySize, op + 1, pos + 1, starts);
+}
+
+// Assigns the reply to the ops; if it doesn't match the ops (e.g. it's incomplete), they are left unexecuted.
+static void ParseReply(GroveI2CBatch* batch, const uint8_t* reply, int replySize)
+{
+	int starts[GROVE_I2C_BATCH_MAX_OPS];
+	if (!MatchReply(batch, reply, replySize, 0, 0, starts)) return;
+
+	for (int i = 0; i < batch->OpCount; i++)
+	{
+		GroveI2CBatchOp* op = &batch->Ops[i];
+		int end = i + 1 < batch->OpCount ? starts[i + 1] : replySize;
+		if (end - starts[i] == op->ReadSize + 1)
+		{
+			if (op->ReadSize > 0) memcpy(op->ReadData, &reply[starts[i]], (size_t)op->ReadSize);
+			op->State = reply[end - 1];
+		}
+		else
+		{
+			op->State = reply[starts[i]];
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// GroveI2CBatch
+
+void GroveI2CBatch_Init(GroveI2CBatch* batch)
+{
+	batch->FrameSize = 0;
+	batch->OpCount = 0;
+	batch->ReplySize = 0;
+	batch->Overflow = false;
+}
+
+int GroveI2CBatch_Write(GroveI2CBatch* batch, uint8_t address, const uint8_t* data, int dataSize)
+{
+	if (dataSize < 0) return -1;
+	return AddOp(batch, address, data, dataSize, NULL, 0);
+}
+
+int GroveI2CBatch_Read(GroveI2CBatch* batch, uint8_t address, uint8_t* readData, int readSize)
+{
+	if (readSize <= 0) return -1;
+	return AddOp(batch, address, NULL, 0, readData, readSize);
+}
+
+int GroveI2CBatch_WriteRead(GroveI2CBatch* batch, uint8_t address, const uint8_t* data, int dataSize,
+	uint8_t* readData, int readSize)
+{
+	if (dataSize <= 0 || readSize <= 0) return -1;
+	return AddOp(batch, address, data, dataSize, readData, readSize);
+}
+
+int GroveI2CBatch_ReadReg(GroveI2CBatch* batch, uint8_t address, uint8_t reg, uint8_t* readData, int readSize)
+{
+	return GroveI2CBatch_WriteRead(batch, address, &reg, 1, readData, readSize);
+}
+
+bool GroveI2CBatch_Execute(int fd, GroveI2CBatch* batch, int timeoutMs)
+{
+	if (batch->Overflow || batch->OpCount == 0) return false;
+	int64_t deadline = NowMs() + timeoutMs;
+
+	for (int i = 0; i < batch->OpCount; i++) batch->Ops[i].State = I2C_NOT_EXECUTED;
+
+	DrainInput(fd);
+	GroveUART_Write(fd, batch->Frame, batch->FrameSize);
+
+	uint8_t reply[GROVE_I2C_BATCH_MAX_REPLY];
+	int replySize = ReadReply(fd, reply, batch->ReplySize, deadline);
+	ParseReply(batch, reply, replySize);
+
+	// the state is queried right after the last transfer, which may not have finished yet; a short reply used up the
+	// timeout already, so asking again gets a timeout of its own
+	GroveI2CBatchOp* last = &batch->Ops[batch->OpCount - 1];
+	deadline = NowMs() + timeoutMs;
+	while (last->State != I2C_NOT_EXECUTED && !IsFinalState(last->State))
+	{
+		const uint8_t query[3] = { 'R', STATE_REGISTER, 'P' };
+		GroveUART_Write(fd, query, sizeof(query));
+		if (ReadReply(fd, &last->State, 1, deadline) != 1) last->State = I2C_NOT_EXECUTED;
+	}
+
+	for (int i = 0; i < batch->OpCount; i++)
+	{
+		if (batch->Ops[i].State != I2C_OK) return false;
+	}
+	return true;
+}
+
+uint8_t GroveI2CBatch_State(const GroveI2CBatch* batch, int op)
+{
+	if (op < 0 || op >= batch->OpCount) return I2C_NOT_EXECUTED;
+	return batch->Ops[op].State;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "GroveI2C.h"
+
+// Batched I2C transactions through the SC18IM700 bridge: the operations are packed into one frame, written to the
+// UART at once, and the combined reply (the bytes read and the state after each operation) is parsed afterwards.
+// This saves the UART round trip and the state polling of each single GroveI2C call, e.g. a register read costs one
+// round trip instead of a write frame, a state poll and a read frame.
+// A batch lives on the stack: GroveI2CBatch_Init, add operations, GroveI2CBatch_Execute.
+
+#define GROVE_I2C_BATCH_MAX_OPS			16
+#define GROVE_I2C_BATCH_MAX_FRAME		256
+#define GROVE_I2C_BATCH_MAX_REPLY		256
+
+// state of an operation that wasn't executed, or whose reply didn't arrive within the timeout
+#define I2C_NOT_EXECUTED				0x00
+
+typedef struct
+{
+	uint8_t Address;
+	uint8_t* ReadData;
+	int ReadSize;
+	uint8_t State;
+}
+GroveI2CBatchOp;
+
+typedef struct
+{
+	uint8_t Frame[GROVE_I2C_BATCH_MAX_FRAME];
+	int FrameSize;
+	GroveI2CBatchOp Ops[GROVE_I2C_BATCH_MAX_OPS];
+	int OpCount;
+	int ReplySize;
+	bool Overflow;
+}
+GroveI2CBatch;
+
+void GroveI2CBatch_Init(GroveI2CBatch* batch);
+
+// Add an operation; return its index, or -1 if it doesn't fit into the batch (GroveI2CBatch_Execute then fails, too).
+// readData must stay valid until GroveI2CBatch_Execute returns.
+int GroveI2CBatch_Write(GroveI2CBatch* batch, uint8_t address, const uint8_t* data, int dataSize);
+int GroveI2CBatch_Read(GroveI2CBatch* batch, uint8_t address, uint8_t* readData, int readSize);
+// write then read with a repeated start (S addr+W n data S addr+R m P), e.g. to read registers starting at reg
+int GroveI2CBatch_WriteRead(GroveI2CBatch* batch, uint8_t address, const uint8_t* data, int dataSize,
+	uint8_t* readData, int readSize);
+int GroveI2CBatch_ReadReg(GroveI2CBatch* batch, uint8_t address, uint8_t reg, uint8_t* readData, int readSize);
+
+// Send the batch and wait up to timeoutMs for the reply; return true if all operations completed with I2C_OK.
+// A read NACKed by the device returns no data, so the reply stays short: it is parsed once the timeout is over,
+// and if it can't be matched to the operations (e.g. a reply is missing), all of them are left I2C_NOT_EXECUTED.
+// If the last operation's state isn't final yet (its transfer is still running), it is queried again until it is.
+bool GroveI2CBatch_Execute(int fd, GroveI2CBatch* batch, int timeoutMs);
+
+uint8_t GroveI2CBatch_State(const GroveI2CBatch* batch, int op);
@@ -2,7 +2,9 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
 #include "../HAL/GroveI2C.h"
+#include "../HAL/GroveI2CAsync.h"
 
 #include <applibs/gpio.h>
 
@@ -16,11 +18,14 @@
 
 #define REF_VOL  3300
 
+#define ASYNC_TIMEOUT_MS	100
+
 typedef struct
 {
 	int I2cFd;
 	int ConvstFd;
 	int AlertFd;
+	float Value;
 }
 GroveAD7992Instance;
 
@@ -31,6 +36,7 @@ void* GroveAD7992_Open(int i2cFd)
 	this->I2cFd = i2cFd;
 	this->ConvstFd = GPIO_OpenAsOutput(CONVST_PIN, GPIO_OutputMode_PushPull, GPIO_Value_High);
 	this->AlertFd = GPIO_OpenAsInput(ALART_PIN);
+	this->Value = NAN;
 
 	return this;
 }
@@ -62,6 +68,61 @@ float GroveAD7992_Read(void* inst, int channel)
 	return (float)val / 0x0fff;
 }
 
+static void OnChannelSelected(void* userData, uint8_t state, const uint8_t* data, int dataSize)
+{
+	GroveAD7992Instance* this = (GroveAD7992Instance*)userData;
+
+	// Start conversion; the UART round trip to the read is way longer than the conversion takes
+	GPIO_SetValue(this->ConvstFd, GPIO_Value_Low);
+}
+
+static void OnConversionRead(void* userData, uint8_t state, const uint8_t* data, int dataSize)
+{
+	GroveAD7992Instance* this = (GroveAD7992Instance*)userData;
+
+	// Stop conversion
+	GPIO_SetValue(this->ConvstFd, GPIO_Value_High);
+
+	if (state != I2C_OK || dataSize != 2)
+	{
+		this->Value = NAN;
+		return;
+	}
+
+	uint16_t val = (uint16_t)((data[0] & 0x0f) << 8 | data[1]);
+	this->Value = (float)val / 0x0fff;
+}
+
+// Queues the same steps as GroveAD7992_Read; the result is available from GroveAD7992_GetValue once completed,
+// until then (or if the read couldn't be queued) it is NAN
+bool GroveAD7992_ReadAsync(void* inst, void* i2cAsync, int channel)
+{
+	GroveAD7992Instance* this = (GroveAD7992Instance*)inst;
+
+	this->Value = NAN;
+
+	// Both or none: selecting the channel starts the conversion, only the read stops it again
+	if (GroveI2CAsync_Free(i2cAsync) < 2) return false;
+
+	// Select channel
+	uint8_t send[2];
+	send[0] = AD7992_REG_CONFIGURATION;
+	send[1] = (uint8_t)((channel == 0 ? 0x10 : 0x20) | 0x08);
+	if (!GroveI2CAsync_Write(i2cAsync, AD7992_ADDRESS, send, sizeof(send), ASYNC_TIMEOUT_MS, OnChannelSelected, this))
+		return false;
+
+	// Read value
+	return GroveI2CAsync_ReadReg(i2cAsync, AD7992_ADDRESS, AD7992_REG_CONVERSION_RESULT, 2, ASYNC_TIMEOUT_MS,
+		OnConversionRead, this);
+}
+
+float GroveAD7992_GetValue(void* inst)
+{
+	GroveAD7992Instance* this = (GroveAD7992Instance*)inst;
+
+	return this->Value;
+}
+
 float GroveAD7992_ConvertToMillisVolt(float value)
 {
 	return (REF_VOL * value);
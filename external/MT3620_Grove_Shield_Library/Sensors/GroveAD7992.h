@@ -2,7 +2,10 @@
 
 #include "../applibs_versions.h"
 #include <applibs/gpio.h>
+#include <stdbool.h>
 
 void* GroveAD7992_Open(int i2cFd);
 float GroveAD7992_Read(void* inst, int channel);
+bool GroveAD7992_ReadAsync(void* inst, void* i2cAsync, int channel);
+float GroveAD7992_GetValue(void* inst);
 float GroveAD7992_ConvertToMillisVolt(float value);
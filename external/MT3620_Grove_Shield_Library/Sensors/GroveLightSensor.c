@@ -28,3 +28,14 @@ float GroveLightSensor_Read(void* inst)
 	return GroveAD7992_Read(this->inst, this->pinId);
 }
 
+bool GroveLightSensor_ReadAsync(void* inst, void* i2cAsync)
+{
+	GroveLightSensorInstance* this = (GroveLightSensorInstance*)inst;
+	return GroveAD7992_ReadAsync(this->inst, i2cAsync, this->pinId);
+}
+
+float GroveLightSensor_GetValue(void* inst)
+{
+	GroveLightSensorInstance* this = (GroveLightSensorInstance*)inst;
+	return GroveAD7992_GetValue(this->inst);
+}
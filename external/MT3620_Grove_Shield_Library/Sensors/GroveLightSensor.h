@@ -3,5 +3,9 @@
 //WIKI_URL          http://wiki.seeedstudio.com/Grove-Light_Sensor/
 #pragma once
 
+#include <stdbool.h>
+
 void* GroveLightSensor_Init(int i2cFd, int analog_pin);
 float GroveLightSensor_Read(void* inst);
+bool GroveLightSensor_ReadAsync(void* inst, void* i2cAsync);
+float GroveLightSensor_GetValue(void* inst);
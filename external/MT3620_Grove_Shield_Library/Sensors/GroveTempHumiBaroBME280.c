@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "../HAL/GroveI2C.h"
+#include "../HAL/GroveI2CBatch.h"
 
 #define BME280_ADDRESS				(0x76 << 1)
 
@@ -13,6 +14,8 @@
 #define BME280_REG_CONTROL			(0xF4)
 #define BME280_REG_TEMPDATA			(0xFA)
 
+#define BATCH_TIMEOUT_MS			100
+
 typedef struct
 {
 	int I2cFd;
@@ -43,15 +46,28 @@ void GroveTempHumiBaroBME280_Read(void* inst)
 
 	this->Temperature = NAN;
 
-	uint16_t dig_T1;
-	int16_t dig_T2;
-	int16_t dig_T3;
-	if (!GroveI2C_ReadReg16(this->I2cFd, BME280_ADDRESS, BME280_REG_DIG_T1, &dig_T1)) return;
-	if (!GroveI2C_ReadReg16(this->I2cFd, BME280_ADDRESS, BME280_REG_DIG_T2, (uint16_t*)&dig_T2)) return;
-	if (!GroveI2C_ReadReg16(this->I2cFd, BME280_ADDRESS, BME280_REG_DIG_T3, (uint16_t*)&dig_T3)) return;
-
-	int32_t adc_T;
-	if (!GroveI2C_ReadReg24BE(this->I2cFd, BME280_ADDRESS, BME280_REG_TEMPDATA, &adc_T)) return;
+	// the calibration (dig_T1..dig_T3, little endian) and the measurement (big endian), in one UART round trip if
+	// the SC18IM700 functions are in place; other GroveI2C functions read the registers one after the other
+	uint8_t calib[6];
+	uint8_t data[3];
+	if (GroveI2C_UsesSC18IM700())
+	{
+		GroveI2CBatch batch;
+		GroveI2CBatch_Init(&batch);
+		GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, BME280_REG_DIG_T1, calib, sizeof(calib));
+		GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, BME280_REG_TEMPDATA, data, sizeof(data));
+		if (!GroveI2CBatch_Execute(this->I2cFd, &batch, BATCH_TIMEOUT_MS)) return;
+	}
+	else
+	{
+		if (!GroveI2C_ReadRegBytes(this->I2cFd, BME280_ADDRESS, BME280_REG_DIG_T1, calib, sizeof(calib))) return;
+		if (!GroveI2C_ReadRegBytes(this->I2cFd, BME280_ADDRESS, BME280_REG_TEMPDATA, data, sizeof(data))) return;
+	}
+
+	uint16_t dig_T1 = (uint16_t)(calib[1] << 8 | calib[0]);
+	int16_t dig_T2 = (int16_t)(calib[3] << 8 | calib[2]);
+	int16_t dig_T3 = (int16_t)(calib[5] << 8 | calib[4]);
+	int32_t adc_T = (int32_t)(data[0] << 16 | data[1] << 8 | data[2]);
 
 	adc_T >>= 4;
 	int32_t var1 = (((adc_T >> 3) - ((int32_t)(dig_T1 << 1))) * ((int32_t)dig_T2)) >> 11;
@@ -4,6 +4,7 @@
 #include <time.h>
 #include <math.h>
 #include "../HAL/GroveI2C.h"
+#include "../HAL/GroveI2CAsync.h"
 #include "../Common/Delay.h"
 
 
@@ -14,11 +15,14 @@
 #define CMD_SOFT_RESET		(0x30a2)
 #define CMD_SINGLE_HIGH		(0x2400)
 
+#define ASYNC_TIMEOUT_MS	100
+
 typedef struct
 {
 	int I2cFd;
 	float Temperature;
 	float Humidity;
+	bool MeasurementStarted;
 }
 GroveTempHumiSHT31Instance;
 
@@ -55,6 +59,7 @@ void* GroveTempHumiSHT31_Open(int i2cFd)
 	this->I2cFd = i2cFd;
 	this->Temperature = NAN;
 	this->Humidity = NAN;
+	this->MeasurementStarted = false;
 
 	SendCommand(this, CMD_SOFT_RESET);
 	usleep(1000);
@@ -91,6 +96,47 @@ void GroveTempHumiSHT31_Read(void* inst)
 	this->Humidity = (float)SRH * 100 / 0xffff;
 }
 
+static void OnMeasurementRead(void* userData, uint8_t state, const uint8_t* readData, int dataSize)
+{
+	GroveTempHumiSHT31Instance* this = (GroveTempHumiSHT31Instance*)userData;
+
+	this->Temperature = NAN;
+	this->Humidity = NAN;
+
+	if (state != I2C_OK || dataSize != 6) return;
+
+	if (readData[2] != CalcCRC8(&readData[0], 2)) return;
+	if (readData[5] != CalcCRC8(&readData[3], 2)) return;
+
+	uint16_t ST = (uint16_t)(readData[0] << 8 | readData[1]);
+	uint16_t SRH = (uint16_t)(readData[3] << 8 | readData[4]);
+
+	this->Temperature = (float)ST * 175 / 0xffff - 45;
+	this->Humidity = (float)SRH * 100 / 0xffff;
+}
+
+// Fetches the measurement started by the previous call and starts the next one, so nothing waits for the
+// measurement to finish; calls must be at least 20 ms apart. The first call only starts a measurement.
+// Until the fetch completes (or if it couldn't be queued), the values are NAN.
+bool GroveTempHumiSHT31_ReadAsync(void* inst, void* i2cAsync)
+{
+	GroveTempHumiSHT31Instance* this = (GroveTempHumiSHT31Instance*)inst;
+
+	this->Temperature = NAN;
+	this->Humidity = NAN;
+
+	if (this->MeasurementStarted &&
+		!GroveI2CAsync_Read(i2cAsync, SHT31_ADDRESS, 6, ASYNC_TIMEOUT_MS, OnMeasurementRead, this)) return false;
+
+	uint8_t writeData[2];
+	writeData[0] = (uint8_t)(CMD_SINGLE_HIGH >> 8);
+	writeData[1] = (uint8_t)(CMD_SINGLE_HIGH & 0xff);
+	this->MeasurementStarted = GroveI2CAsync_Write(i2cAsync, SHT31_ADDRESS, writeData, sizeof(writeData),
+		ASYNC_TIMEOUT_MS, NULL, NULL);
+
+	return this->MeasurementStarted;
+}
+
 float GroveTempHumiSHT31_GetTemperature(void* inst)
 {
 	GroveTempHumiSHT31Instance* this = (GroveTempHumiSHT31Instance*)inst;
@@ -3,7 +3,10 @@
 //WIKI_URL          http://wiki.seeedstudio.com/Grove-TempAndHumi_Sensor-SHT31/
 
 #pragma once
+#include <stdbool.h>
+
 void* GroveTempHumiSHT31_Open(int i2cFd);
 void GroveTempHumiSHT31_Read(void* inst);
+bool GroveTempHumiSHT31_ReadAsync(void* inst, void* i2cAsync);
 float GroveTempHumiSHT31_GetTemperature(void* inst);
 float GroveTempHumiSHT31_GetHumidity(void* inst);
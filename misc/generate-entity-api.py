@@ -0,0 +1,372 @@
+#!/usr/bin/env python3
+"""Generates typed C wrappers around the ObjectBox client API for the tables of a FlatBuffers schema.
+
+Usage: generate-entity-api.py <schema.fbs> <output dir> <Table>=<entity id> [<Table>=<entity id> ...]
+
+For each given table, <Table>_obx.h is written next to the flatcc generated <Table>_builder.h/_reader.h.
+It contains a plain struct for the table (<Table>_t), converters between the struct and FlatBuffers,
+box based put/get functions, column descriptors to project scalar fields of many objects into arrays,
+sorted index constructors for uint64 fields, sample struct fields and deadband filter fields based on them.
+All fields are always written, so all objects of an entity share one vtable and serialization is a
+straight sequence of stores into the box's reused builder.
+Tables with scalar fields only additionally get a template based encoder: as their layout doesn't depend on
+the values, the buffer is built once and each further object just overwrites the field values in place.
+Of the field attributes, "id: N" (the vtable slot, as with flatc either given for all fields or none) and
+"deprecated" (the slot stays reserved, the field is left out of the struct) are honored; the ones changing the
+field's type (nested_flatbuffer, flexbuffer, hash) are rejected and the others, e.g. "key", ignored.
+"""
+
+import os
+import re
+import sys
+
+# FlatBuffers scalar type -> (C type, flatcc type prefix, size)
+SCALARS = {
+    "bool": ("flatbuffers_bool_t", "flatbuffers_bool", 1),
+    "byte": ("int8_t", "flatbuffers_int8", 1),
+    "ubyte": ("uint8_t", "flatbuffers_uint8", 1),
+    "short": ("int16_t", "flatbuffers_int16", 2),
+    "ushort": ("uint16_t", "flatbuffers_uint16", 2),
+    "int": ("int32_t", "flatbuffers_int32", 4),
+    "uint": ("uint32_t", "flatbuffers_uint32", 4),
+    "long": ("int64_t", "flatbuffers_int64", 8),
+    "ulong": ("uint64_t", "flatbuffers_uint64", 8),
+    "float": ("float", "flatbuffers_float", 4),
+    "double": ("double", "flatbuffers_double", 8),
+}
+
+
+class Field:
+    def __init__(self, name, type_name, field_id, deprecated):
+        self.name = name
+        self.field_id = field_id  # vtable slot
+        self.deprecated = deprecated
+        self.kind = "scalar"
+        if type_name == "string":
+            self.kind = "string"
+        elif type_name.startswith("[") and type_name.endswith("]"):
+            self.kind = "vector"
+            type_name = type_name[1:-1].strip()
+        if self.kind != "string" and type_name not in SCALARS:
+            raise ValueError("unsupported type '%s' of field '%s'" % (type_name, name))
+        if self.kind != "string":
+            self.c_type, self.fb_type, self.size = SCALARS[type_name]
+            # OBXC_value_kind of a scalar member in the sample struct
+            self.value_kind = "OBXC_VALUE_FLOAT" if self.c_type in ("float", "double") else \
+                "OBXC_VALUE_SIGNED" if self.c_type.startswith("int") else "OBXC_VALUE_UNSIGNED"
+
+
+def parse_attributes(text, table, name):
+    """Field attributes relevant for the layout: the explicit vtable slot ("id: N") and "deprecated"; others, e.g.
+    "key", don't change the encoding. Returns (id or None, deprecated)."""
+    field_id, deprecated = None, False
+    for attribute in filter(None, (a.strip() for a in text.split(","))):
+        key, _, value = [part.strip() for part in attribute.partition(":")]
+        if key == "id":
+            field_id = int(value.strip('"'))
+        elif key == "deprecated":
+            deprecated = True
+        elif key in ("nested_flatbuffer", "flexbuffer", "hash"):
+            raise ValueError("unsupported attribute '%s' of field '%s.%s'" % (key, table, name))
+    return field_id, deprecated
+
+
+def parse_tables(schema):
+    """Returns the fields of each table in vtable slot order, including deprecated ones (see Field.deprecated)."""
+    schema = re.sub(r"//[^\n]*", "", schema)
+    tables = {}
+    for match in re.finditer(r"table\s+(\w+)\s*(\([^)]*\))?\s*\{([^}]*)\}", schema):
+        table = match.group(1)
+        fields = []
+        for decl in match.group(3).split(";"):
+            attributes = re.search(r"\(([^)]*)\)", decl)
+            decl = re.sub(r"\([^)]*\)", "", decl).strip()
+            if not decl:
+                continue
+            name, type_name = [part.strip() for part in decl.split(":", 1)]
+            type_name = type_name.split("=")[0].strip()  # default values are not supported by the struct API
+            field_id, deprecated = parse_attributes(attributes.group(1) if attributes else "", table, name)
+            fields.append(Field(name, type_name, field_id, deprecated))
+
+        # like flatc: either all fields have explicit ids, which must be 0..n-1, or none and they count up
+        explicit = [f.field_id for f in fields if f.field_id is not None]
+        if not explicit:
+            for i, f in enumerate(fields):
+                f.field_id = i
+        elif len(explicit) != len(fields) or sorted(explicit) != list(range(len(fields))):
+            raise ValueError("table '%s': either all fields or none need an id, and ids must be 0..%d"
+                             % (table, len(fields) - 1))
+        tables[table] = sorted(fields, key=lambda f: f.field_id)
+    return tables
+
+
+def generate(table, entity_id, fields, schema_name):
+    T = table
+    guard = T.upper() + "_OBX_H"
+    has_refs = any(f.kind != "scalar" for f in fields)
+    out = []
+    w = out.append
+
+    w("#ifndef %s" % guard)
+    w("#define %s" % guard)
+    w("")
+    w("/* Generated by generate-entity-api.py from %s, do not edit. */" % schema_name)
+    w("")
+    w("#include <stddef.h>")
+    w("#include <objectbox.h>")
+    w("")
+    w("#ifndef %s_BUILDER_H" % T.upper())
+    w('#include "%s_builder.h"' % T)
+    w("#endif")
+    w("")
+    w("#define %s_entity_id %d" % (T, entity_id))
+    w("")
+    w("typedef struct %s {" % T)
+    for f in fields:
+        if f.kind == "scalar":
+            w("    %s %s;" % (f.c_type, f.name))
+        elif f.kind == "string":
+            w("    const char *%s;" % f.name)
+        else:
+            w("    const %s *%s;" % (f.c_type, f.name))
+            w("    size_t %s_len;" % f.name)
+    w("} %s_t;" % T)
+    w("")
+
+    # scalars are added largest first like flatcc's own _create() does, which keeps the table free of padding
+    scalars = sorted((f for f in fields if f.kind == "scalar"), key=lambda f: -f.size)
+    w("/* Serializes the object as root of a new buffer; every field is written, so all objects share one vtable. */")
+    w("static inline int %s_build(flatcc_builder_t *B, const %s_t *object)" % (T, T))
+    w("{")
+    w("    if (%s_start_as_root(B)" % T)
+    for f in scalars:
+        w("        || %s_%s_force_add(B, object->%s)" % (T, f.name, f.name))
+    for f in fields:
+        if f.kind == "string":
+            w("        || (object->%s && %s_%s_create_str(B, object->%s))" % (f.name, T, f.name, f.name))
+        elif f.kind == "vector":
+            w("        || (object->%s && %s_%s_create(B, (%s *) object->%s, object->%s_len))"
+              % (f.name, T, f.name, f.c_type, f.name, f.name))
+    w("        || !%s_end_as_root(B)) {" % T)
+    w("        return -1;")
+    w("    }")
+    w("    return 0;")
+    w("}")
+    w("")
+
+    w("/* Reads all fields of a serialized object%s. */"
+      % ("; strings and vectors point into the given buffer" if has_refs else ""))
+    w("static inline int %s_read(const void *buffer, size_t size, %s_t *object)" % (T, T))
+    w("{")
+    w("    %s_table_t t;" % T)
+    for f in fields:
+        if f.kind == "vector":
+            w("    %s_vec_t %s;" % (f.fb_type, f.name))
+    w("    if (size < sizeof(flatbuffers_uoffset_t) || !(t = %s_as_root(buffer))) return -1;" % T)
+    for f in fields:
+        if f.kind == "vector":
+            w("    %s = %s_%s(t);" % (f.name, T, f.name))
+            w("    object->%s = %s;" % (f.name, f.name))
+            w("    object->%s_len = %s ? %s_vec_len(%s) : 0;" % (f.name, f.name, f.fb_type, f.name))
+        else:
+            w("    object->%s = %s_%s(t);" % (f.name, T, f.name))
+    w("    return 0;")
+    w("}")
+    w("")
+
+    w("/* Adds the object to a batch (see obxc_batch()); equal strings and vectors are shared with the batch's other objects. */")
+    w("static inline obx_err %s_batch_add(OBXC_batch *batch, const %s_t *object)" % (T, T))
+    w("{")
+    w("    flatcc_builder_t *B = obxc_batch_builder(batch);")
+    for f in fields:
+        if f.kind != "scalar":
+            w("    flatcc_builder_ref_t %s = 0;" % f.name)
+    w("    if (B == NULL) return obxc_last_error_code();")
+    for f in fields:
+        if f.kind == "string":
+            w("    if (object->%s && !(%s = obxc_batch_string(batch, object->%s))) {" % (f.name, f.name, f.name))
+        elif f.kind == "vector":
+            w("    if (object->%s && !(%s = obxc_batch_vector(batch, object->%s, object->%s_len, %d, %d))) {"
+              % (f.name, f.name, f.name, f.name, f.size, f.size))
+        if f.kind != "scalar":
+            w("        return obxc_last_error_code();")
+            w("    }")
+    conditions = ["%s_start(B)" % T]
+    conditions += ["%s_%s_force_add(B, object->%s)" % (T, f.name, f.name) for f in scalars]
+    conditions += ["(%s && %s_%s_add(B, %s))" % (f.name, T, f.name, f.name) for f in fields if f.kind != "scalar"]
+    w("    if (" + "\n        || ".join(conditions) + ") {")
+    w("        /* marks the batch as failed, the builder is left inside an unfinished table */")
+    w("        return obxc_batch_add(batch, 0);")
+    w("    }")
+    w("    return obxc_batch_add(batch, %s_end(B));" % T)
+    w("}")
+    w("")
+
+    w("/* obxc_sample_build() callback for samplers buffering %s_t objects, see OBXC_sampler_options. */" % T)
+    w("static inline int %s_sample_build(flatcc_builder_t *B, const void *sample)" % T)
+    w("{")
+    w("    return %s_build(B, (const %s_t *) sample);" % (T, T))
+    w("}")
+    w("")
+
+    w("/* obxc_sample_add() callback for samplers uploading %s_t objects in batches (OBXC_UPLOAD_BATCH). */" % T)
+    w("static inline obx_err %s_sample_add(OBXC_batch *batch, const void *sample)" % T)
+    w("{")
+    w("    return %s_batch_add(batch, (const %s_t *) sample);" % (T, T))
+    w("}")
+    w("")
+
+    w("/* Columns for obxc_bytes_array_project(), extracting a field of all objects; values holds one per object. */")
+    for f in fields:
+        if f.kind != "scalar":
+            continue
+        w("static inline OBXC_column %s_%s_column(%s *values)" % (T, f.name, f.c_type))
+        w("{")
+        w("    OBXC_column column = {%d, sizeof(%s), values};" % (f.field_id, f.c_type))
+        w("    return column;")
+        w("}")
+        w("")
+
+    w("/* Fields of %s_t samples for aggregators, see obxc_aggregator(), and time series, see obxc_series_encode(). */"
+      % T)
+    for f in fields:
+        if f.kind != "scalar":
+            continue
+        w("static inline OBXC_field %s_%s_field(void)" % (T, f.name))
+        w("{")
+        w("    OBXC_field field = {offsetof(%s_t, %s), sizeof(%s), %s};" % (T, f.name, f.c_type, f.value_kind))
+        w("    return field;")
+        w("}")
+        w("")
+
+    w("/* Fields for deadband filters on %s_t samples, see obxc_deadband(). */" % T)
+    for f in fields:
+        if f.kind != "scalar":
+            continue
+        w("static inline OBXC_deadband_field %s_%s_deadband(double absolute, double relative)" % (T, f.name))
+        w("{")
+        w("    OBXC_deadband_field field = {%s_%s_field(), absolute, relative};" % (T, f.name))
+        w("    return field;")
+        w("}")
+        w("")
+
+    w("/* Sorted indexes over the uint64 fields, see obxc_index(); the array must outlive the index. */")
+    for f in fields:
+        if f.kind != "scalar" or f.c_type != "uint64_t":
+            continue
+        w("static inline OBXC_index *%s_%s_index(const OBXC_bytes_array *array)" % (T, f.name))
+        w("{")
+        w("    return obxc_index(array, %d);" % f.field_id)
+        w("}")
+        w("")
+
+    w("static inline OBXC_box *%s_box(OBXC_store *store)" % T)
+    w("{")
+    w("    return obxc_box(store, %s_entity_id);" % T)
+    w("}")
+    w("")
+
+    w("/* Inserts the object using the box's builder; on success, object->id is set to the ID assigned by the server. */")
+    w("static inline obx_err %s_put(OBXC_box *box, %s_t *object)" % (T, T))
+    w("{")
+    w("    flatcc_builder_t *B = obxc_box_builder(box);")
+    w("    obx_err err;")
+    w("    int id;")
+    w("    if (B == NULL) return obxc_last_error_code();")
+    w("    /* a failed build leaves an unfinished buffer, which obxc_box_put_builder() rejects */")
+    w("    %s_build(B, object);" % T)
+    w("    err = obxc_box_put_builder(box, B, &id);")
+    w("    if (err == OBX_SUCCESS) object->id = (%s) id;" % next(f.c_type for f in fields if f.name == "id"))
+    w("    return err;")
+    w("}")
+    w("")
+
+    if not has_refs:
+        w("/* Builds the template for _encode(), which is reused for all objects; free it using obxc_template_free(). */")
+        w("static inline obx_err %s_template_init(OBXC_template *tpl, flatcc_builder_t *B)" % T)
+        w("{")
+        w("    %s_t zero = {0};" % T)
+        w("    if (%s_build(B, &zero)) {" % T)
+        w("        return obxc_last_error_set(OBX_ERROR_ILLEGAL_STATE, \"%s: build failed\");" % T)
+        w("    }")
+        w("    return obxc_template_init(tpl, B);")
+        w("}")
+        w("")
+        w("/* Encodes the object by patching its values into the template's buffer; yields the same bytes as _build(). */")
+        w("static inline void %s_encode(OBXC_template *tpl, const %s_t *object)" % (T, T))
+        w("{")
+        w("    uint8_t *buf = (uint8_t *) tpl->buffer;")
+        for f in fields:
+            w("    %s_write_to_pe(buf + tpl->field_pos[%d], object->%s);" % (f.fb_type, f.field_id, f.name))
+        w("}")
+        w("")
+        w("/* Like _put(), but encodes the object using the template instead of a builder. */")
+        w("static inline obx_err %s_put_template(OBXC_box *box, OBXC_template *tpl, %s_t *object)" % (T, T))
+        w("{")
+        w("    OBXC_bytes bytes;")
+        w("    obx_err err;")
+        w("    int id;")
+        w("    %s_encode(tpl, object);" % T)
+        w("    bytes.data = tpl->buffer;")
+        w("    bytes.size = tpl->size;")
+        w("    err = obxc_box_put(box, &bytes, &id);")
+        w("    if (err == OBX_SUCCESS) object->id = (%s) id;" % next(f.c_type for f in fields if f.name == "id"))
+        w("    return err;")
+        w("}")
+        w("")
+
+    if has_refs:
+        w("/* Gets the object with the given ID; its strings and vectors point into bytes, free it using obxc_bytes_free(). */")
+        w("static inline obx_err %s_get(OBXC_box *box, int id, %s_t *object, OBXC_bytes *bytes)" % (T, T))
+        w("{")
+        w("    obx_err err = obxc_box_get(box, id, bytes);")
+        w("    if (err != OBX_SUCCESS) return err;")
+        w("    if (%s_read(bytes->data, bytes->size, object)) {" % T)
+        w("        obxc_bytes_free(bytes);")
+        w("        return obxc_last_error_set(OBX_ERROR_ILLEGAL_RESPONSE, \"%s: invalid object\");" % T)
+        w("    }")
+        w("    return OBX_SUCCESS;")
+        w("}")
+    else:
+        w("/* Gets the object with the given ID. */")
+        w("static inline obx_err %s_get(OBXC_box *box, int id, %s_t *object)" % (T, T))
+        w("{")
+        w("    OBXC_bytes bytes;")
+        w("    obx_err err = obxc_box_get(box, id, &bytes);")
+        w("    if (err != OBX_SUCCESS) return err;")
+        w("    if (%s_read(bytes.data, bytes.size, object)) {" % T)
+        w("        err = obxc_last_error_set(OBX_ERROR_ILLEGAL_RESPONSE, \"%s: invalid object\");" % T)
+        w("    }")
+        w("    obxc_bytes_free(&bytes);")
+        w("    return err;")
+        w("}")
+    w("")
+    w("#endif /* %s */" % guard)
+    return "\n".join(out) + "\n"
+
+
+def main(argv):
+    if len(argv) < 4:
+        sys.exit(__doc__)
+    schema_path, out_dir = argv[1], argv[2]
+    with open(schema_path) as f:
+        try:
+            tables = parse_tables(f.read())
+        except ValueError as e:
+            sys.exit("%s: %s" % (schema_path, e))
+
+    for arg in argv[3:]:
+        table, entity_id = arg.split("=")
+        if table not in tables:
+            sys.exit("table '%s' not found in %s" % (table, schema_path))
+        # flatcc generates no accessors for deprecated fields, they only keep their vtable slot
+        fields = [f for f in tables[table] if not f.deprecated]
+        if not any(f.name == "id" and f.kind == "scalar" for f in fields):
+            sys.exit("table '%s' needs an 'id' field" % table)
+        code = generate(table, int(entity_id), fields, os.path.basename(schema_path))
+        with open(os.path.join(out_dir, table + "_obx.h"), "w", newline="\n") as f:
+            f.write(code)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for the Azure Sphere UART API, so that HAL/GroveUART.c builds; the driver opens the emulator's
+// pseudo terminal itself.
+
+#include <stdint.h>
+
+typedef int UART_Id;
+typedef uint32_t UART_BaudRate_Type;
+
+typedef struct
+{
+	UART_BaudRate_Type baudRate;
+}
+UART_Config;
+
+static inline void UART_InitConfig(UART_Config* config)
+{
+	config->baudRate = 9600;
+}
+
+static inline int UART_Open(UART_Id id, const UART_Config* config)
+{
+	return -1;
+}
@@ -0,0 +1,210 @@
+// Runs GroveI2CBatch against misc/sc18im700-emulator.py on a host: register reads, data bytes equal to the bridge's
+// states, a read NACKed in the middle and at the end of a batch, the time of a BME280 reading with single
+// GroveI2C calls (as before batching) and with GroveTempHumiBaroBME280_Read's batch, and a BME280 reading through
+// replaced GroveI2C functions, which must not be batched.
+//
+// Build from the repository root:
+//   G=external/MT3620_Grove_Shield_Library
+//   SRC="$G/HAL/GroveI2C.c $G/HAL/GroveI2CBatch.c $G/HAL/GroveUART.c $G/Sensors/GroveTempHumiBaroBME280.c"
+//   D=misc/grove-i2c-batch-check
+//   gcc -std=gnu11 -fcommon -I $D -I $G -o grove-i2c-batch-check $D/grove-i2c-batch-check.c $SRC
+// Run:
+//   python3 misc/sc18im700-emulator.py --link /tmp/sc18im700 --baud 115200 &
+//   ./grove-i2c-batch-check /tmp/sc18im700
+// The timings are only meaningful with --baud; with --busy, every batch needs the last state queried again.
+// Exits with 1 if a check failed.
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "HAL/GroveI2C.h"
+#include "HAL/GroveI2CBatch.h"
+#include "Sensors/GroveTempHumiBaroBME280.h"
+
+#define BME280_ADDRESS				(0x76 << 1)
+#define SHT31_ADDRESS				(0x44 << 1)
+#define MISSING_ADDRESS				(0x50 << 1)
+
+#define BME280_REG_DIG_T1			(0x88)
+#define BME280_REG_CHIPID			(0xD0)
+#define BME280_REG_TEMPDATA			(0xFA)
+// config and two unused registers, the emulator stores any value
+#define STATE_VALUED_REG			(0xF5)
+
+#define TIMEOUT_MS					50
+#define TIMING_READINGS				20
+
+static int Failures = 0;
+
+static void Check(const char* name, bool ok)
+{
+	printf("%s: %s\n", ok ? "ok" : "FAILED", name);
+	if (!ok) Failures++;
+}
+
+static void RegisterReads(int fd)
+{
+	uint8_t chipId = 0;
+	uint8_t calib[6] = { 0 };
+	GroveI2CBatch batch;
+	GroveI2CBatch_Init(&batch);
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, BME280_REG_CHIPID, &chipId, sizeof(chipId));
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, BME280_REG_DIG_T1, calib, sizeof(calib));
+	bool ok = GroveI2CBatch_Execute(fd, &batch, TIMEOUT_MS);
+
+	// dig_T1 is 27504, little endian
+	Check("register reads", ok && chipId == 0x60 && calib[0] == 0x70 && calib[1] == 0x6b);
+}
+
+// data bytes can't be told from states by their value, only by their position in the reply
+static void StateValuedData(int fd)
+{
+	const uint8_t write[4] = { STATE_VALUED_REG, I2C_OK, I2C_NACK_ON_ADDRESS, I2C_NACK_ON_DATA };
+	uint8_t data[3] = { 0 };
+	uint8_t second = 0;
+	GroveI2CBatch batch;
+	GroveI2CBatch_Init(&batch);
+	GroveI2CBatch_Write(&batch, BME280_ADDRESS, write, sizeof(write));
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, STATE_VALUED_REG, data, sizeof(data));
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, STATE_VALUED_REG + 1, &second, sizeof(second));
+	bool ok = GroveI2CBatch_Execute(fd, &batch, TIMEOUT_MS);
+
+	Check("data equal to states", ok && memcmp(data, &write[1], sizeof(data)) == 0 && second == I2C_NACK_ON_ADDRESS);
+}
+
+static void NackMidBatch(int fd)
+{
+	uint8_t chipId = 0;
+	uint8_t missing[2];
+	uint8_t data[3] = { 0 };
+	GroveI2CBatch batch;
+	GroveI2CBatch_Init(&batch);
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, BME280_REG_CHIPID, &chipId, sizeof(chipId));
+	GroveI2CBatch_Read(&batch, MISSING_ADDRESS, missing, sizeof(missing));
+	GroveI2CBatch_ReadReg(&batch, BME280_ADDRESS, STATE_VALUED_REG, data, sizeof(data));
+	bool ok = GroveI2CBatch_Execute(fd, &batch, TIMEOUT_MS);
+
+	const uint8_t expected[3] = { I2C_OK, I2C_NACK_ON_ADDRESS, I2C_NACK_ON_DATA };
+	Check("NACK in the middle", !ok && GroveI2CBatch_State(&batch, 0) == I2C_OK &&
+		GroveI2CBatch_State(&batch, 1) == I2C_NACK_ON_ADDRESS && GroveI2CBatch_State(&batch, 2) == I2C_OK &&
+		chipId == 0x60 && memcmp(data, expected, sizeof(data)) == 0);
+}
+
+// the SHT31 NACKs its read until the measurement started by the write is done
+static void NackLastRead(int fd)
+{
+	const uint8_t measure[2] = { 0x24, 0x00 };
+	uint8_t data[6];
+	GroveI2CBatch batch;
+	GroveI2CBatch_Init(&batch);
+	GroveI2CBatch_Write(&batch, SHT31_ADDRESS, measure, sizeof(measure));
+	GroveI2CBatch_Read(&batch, SHT31_ADDRESS, data, sizeof(data));
+	bool ok = GroveI2CBatch_Execute(fd, &batch, TIMEOUT_MS);
+
+	Check("NACK at the end", !ok && GroveI2CBatch_State(&batch, 0) == I2C_OK &&
+		GroveI2CBatch_State(&batch, 1) == I2C_NACK_ON_ADDRESS);
+}
+
+// the register reads of GroveTempHumiBaroBME280_Read as single GroveI2C calls, as they were before batching
+static void ReadBME280Unbatched(int fd)
+{
+	const uint8_t regs[4] = { 0x88, 0x8A, 0x8C, BME280_REG_TEMPDATA };
+	const int sizes[4] = { 2, 2, 2, 3 };
+	uint8_t data[3];
+	for (int i = 0; i < 4; i++)
+	{
+		GroveI2C_Write(fd, BME280_ADDRESS, &regs[i], 1);
+		GroveI2C_Read(fd, BME280_ADDRESS, data, sizes[i]);
+	}
+}
+
+static double NowMs(void)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1000 + (double)now.tv_nsec / 1000000;
+}
+
+static void Timing(int fd)
+{
+	void* bme280 = GroveTempHumiBaroBME280_Open(fd);
+	if (bme280 == NULL)
+	{
+		Check("BME280 open", false);
+		return;
+	}
+
+	double start = NowMs();
+	for (int i = 0; i < TIMING_READINGS; i++) ReadBME280Unbatched(fd);
+	double unbatchedMs = (NowMs() - start) / TIMING_READINGS;
+
+	start = NowMs();
+	for (int i = 0; i < TIMING_READINGS; i++) GroveTempHumiBaroBME280_Read(bme280);
+	double batchedMs = (NowMs() - start) / TIMING_READINGS;
+
+	// the datasheet's example calibration and measurement
+	float temperature = GroveTempHumiBaroBME280_GetTemperature(bme280);
+	Check("BME280 reading", temperature > 25.07f && temperature < 25.09f);
+	printf("BME280 reading: %.2f ms with single GroveI2C calls, %.2f ms batched\n", unbatchedMs, batchedMs);
+}
+
+// stand-ins for other I2C transports, forwarding to the SC18IM700 functions
+static void (*ForwardWrite)(int fd, uint8_t address, const uint8_t* data, int dataSize);
+static bool (*ForwardRead)(int fd, uint8_t address, uint8_t* data, int dataSize);
+static int ForwardedReads = 0;
+
+static void ForwardingWrite(int fd, uint8_t address, const uint8_t* data, int dataSize)
+{
+	ForwardWrite(fd, address, data, dataSize);
+}
+
+static bool CountingRead(int fd, uint8_t address, uint8_t* data, int dataSize)
+{
+	ForwardedReads++;
+	return ForwardRead(fd, address, data, dataSize);
+}
+
+static void ReplacedFunctions(int fd)
+{
+	void* bme280 = GroveTempHumiBaroBME280_Open(fd);
+	ForwardWrite = GroveI2C_Write;
+	ForwardRead = GroveI2C_Read;
+	GroveI2C_Write = ForwardingWrite;
+	GroveI2C_Read = CountingRead;
+
+	bool ok = bme280 != NULL && !GroveI2C_UsesSC18IM700();
+	if (ok) GroveTempHumiBaroBME280_Read(bme280);
+	float temperature = ok ? GroveTempHumiBaroBME280_GetTemperature(bme280) : 0;
+	Check("BME280 reading through replaced functions", ok && ForwardedReads == 2 && temperature > 25.07f &&
+		temperature < 25.09f);
+
+	GroveI2C_Write = ForwardWrite;
+	GroveI2C_Read = ForwardRead;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <emulator terminal>\n", argv[0]);
+		return 2;
+	}
+	int fd = open(argv[1], O_RDWR | O_NOCTTY);
+	if (fd < 0)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+
+	RegisterReads(fd);
+	StateValuedData(fd);
+	NackMidBatch(fd);
+	NackLastRead(fd);
+	Timing(fd);
+	ReplacedFunctions(fd);
+
+	close(fd);
+	return Failures == 0 ? 0 : 1;
+}
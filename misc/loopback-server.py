@@ -0,0 +1,354 @@
+#!/usr/bin/env python3
+"""A stand-in for the ObjectBox HTTP server, e.g. to try HTTP compression or to run benchmarks without the real one.
+
+Usage: loopback-server.py [<port>] [--schema <schema.fbs> <Table>=<entity id>]... [--verbose]
+
+Serves the subset of the REST API under /api/v2 the client library uses for data: sessions, count, get, get all,
+insert, batch insert, update, delete and the change feed (long-polled with "wait"), keeping the objects and their
+changes in memory. Like the real server, it sets the ID property of the objects it stores, and stores each object of
+a batch (a buffer whose root is the vector of the objects' tables, sharing strings and vectors) as a buffer of its
+own; for both, objects are re-encoded, which needs the entity's table: the schemas in misc/ are known (TestEntity=1,
+SensorDemoEntity=2, SensorDemoAggregate=3), others are added with --schema. Objects of other entities are stored as
+they are sent and can't be inserted in batches. Request bodies may be compressed ("Content-Encoding: gzip" or
+"deflate", also with "Transfer-Encoding: chunked"); responses are compressed with gzip or deflate if the client
+accepts it. With --verbose, each request is logged with its body sizes before and after (de)compression.
+"""
+import gzip
+import http.server
+import importlib.util
+import json
+import os
+import re
+import struct
+import sys
+import threading
+import zlib
+
+# responses smaller than this are sent as they are, like most servers do
+MIN_COMPRESS_SIZE = 256
+
+CHANGE_PUT = 1
+CHANGE_REMOVE = 2
+
+
+class Database:
+    def __init__(self):
+        self.entities = {}
+        self.last_id = 0
+        # change log: (sequence number, entity ID, change type, object ID, data); waiters are notified on changes
+        self.changes = []
+        self.seq = 0
+        self.lock = threading.Condition()
+
+    def objects(self, entity_id):
+        return self.entities.setdefault(entity_id, {})
+
+    def record(self, entity_id, change_type, object_id, data):
+        self.seq += 1
+        self.changes.append((self.seq, entity_id, change_type, object_id, data))
+        self.lock.notify_all()
+
+    def insert(self, entity_id, encode):
+        """encode returns the object's data given its new ID."""
+        with self.lock:
+            self.last_id += 1
+            data = encode(self.last_id)
+            self.objects(entity_id)[self.last_id] = data
+            self.record(entity_id, CHANGE_PUT, self.last_id, data)
+            return self.last_id
+
+    def update(self, entity_id, object_id, data):
+        with self.lock:
+            if object_id not in self.objects(entity_id):
+                return False
+            self.objects(entity_id)[object_id] = data
+            self.record(entity_id, CHANGE_PUT, object_id, data)
+            return True
+
+    def delete(self, entity_id, object_id):
+        with self.lock:
+            if self.objects(entity_id).pop(object_id, None) is None:
+                return False
+            self.record(entity_id, CHANGE_REMOVE, object_id, b"")
+            return True
+
+    def changes_since(self, entity_id, since, wait_s):
+        """Changes of the entity after sequence number since, waiting up to wait_s for the first one; returns the
+        sequence number to continue from and the changes."""
+        with self.lock:
+            self.lock.wait_for(lambda: any(c[0] > since and c[1] == entity_id for c in self.changes), wait_s)
+            changes = [c for c in self.changes if c[0] > since and c[1] == entity_id]
+            return (changes[-1][0] if changes else max(since, self.seq)), changes
+
+
+MISC_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_SCHEMAS = [("TestEntity.fbs", "TestEntity", 1), ("SensorDemoEntity.fbs", "SensorDemoEntity", 2),
+                   ("SensorDemoAggregate.fbs", "SensorDemoAggregate", 3)]
+
+# struct formats of the scalar C types of generate-entity-api.py
+SCALAR_FORMATS = {"flatbuffers_bool_t": "B", "int8_t": "b", "uint8_t": "B", "int16_t": "h", "uint16_t": "H",
+                  "int32_t": "i", "uint32_t": "I", "int64_t": "q", "uint64_t": "Q", "float": "f", "double": "d"}
+
+
+def load_generator():
+    """The schema parser of generate-entity-api.py, which supports the same subset of FlatBuffers."""
+    path = os.path.join(MISC_DIR, "generate-entity-api.py")
+    spec = importlib.util.spec_from_file_location("generate_entity_api", path)
+    module = importlib.util.module_from_spec(spec)
+    spec.loader.exec_module(module)
+    return module
+
+
+def align(size, alignment):
+    return (size + alignment - 1) & ~(alignment - 1)
+
+
+class TableCodec:
+    """Reads the fields of a table out of a buffer and encodes them as a buffer of their own."""
+
+    def __init__(self, fields):
+        self.fields = [f for f in fields if not f.deprecated]
+
+    def decode(self, data, table=None):
+        """The values of the table at the given position, by default the buffer's root table."""
+        if table is None:
+            table = struct.unpack_from("<I", data, 0)[0]
+        vtable = table - struct.unpack_from("<i", data, table)[0]
+        vtable_size = struct.unpack_from("<H", data, vtable)[0]
+        values = {}
+        for f in self.fields:
+            entry = 4 + 2 * f.field_id
+            offset = struct.unpack_from("<H", data, vtable + entry)[0] if entry < vtable_size else 0
+            if offset == 0:
+                continue  # absent, i.e. the default value
+            pos = table + offset
+            if f.kind == "scalar":
+                values[f.name] = struct.unpack_from("<" + SCALAR_FORMATS[f.c_type], data, pos)[0]
+            else:
+                pos += struct.unpack_from("<I", data, pos)[0]
+                size = struct.unpack_from("<I", data, pos)[0] * (1 if f.kind == "string" else f.size)
+                values[f.name] = bytes(data[pos + 4:pos + 4 + size])
+        return values
+
+    def encoder(self, values):
+        """For Database.insert(): encodes the values with the given ID."""
+        return lambda object_id: self.encode(dict(values, id=object_id))
+
+    def encode(self, values):
+        """Buffer layout: root offset, vtable, table (scalars sorted by size, then offsets), strings and vectors."""
+        present = [f for f in self.fields if f.name in values]
+        present.sort(key=lambda f: -(f.size if f.kind == "scalar" else 4))
+        field_pos = {}
+        table_size = 4  # the vtable's soffset
+        for f in present:
+            size = f.size if f.kind == "scalar" else 4
+            table_size = align(table_size, size)
+            field_pos[f.name] = table_size
+            table_size += size
+
+        slots = max([f.field_id + 1 for f in present] or [0])
+        vtable = [0] * slots
+        for f in present:
+            vtable[f.field_id] = field_pos[f.name]
+        vtable_size = 4 + 2 * slots
+        table = align(4 + vtable_size, 8)
+
+        data = bytearray(table + table_size)
+        struct.pack_into("<I", data, 0, table)
+        struct.pack_into("<HH%dH" % slots, data, 4, vtable_size, table_size, *vtable)
+        struct.pack_into("<i", data, table, table - 4)
+        for f in present:
+            pos = table + field_pos[f.name]
+            if f.kind == "scalar":
+                struct.pack_into("<" + SCALAR_FORMATS[f.c_type], data, pos, values[f.name])
+                continue
+            content = values[f.name]
+            element_size = 1 if f.kind == "string" else f.size
+            # the length precedes the content, which is aligned to its element size
+            start = align(len(data) + 4, max(element_size, 4)) - 4
+            data += bytes(start - len(data))
+            data += struct.pack("<I", len(content) // element_size) + content
+            if f.kind == "string":
+                data += b"\0"
+            struct.pack_into("<I", data, pos, start - pos)
+        return bytes(data + bytes(align(len(data), 8) - len(data)))
+
+
+def batch_tables(data):
+    """The positions of the objects' tables in a batch, a buffer whose root is a vector of tables."""
+    vector = struct.unpack_from("<I", data, 0)[0]
+    count = struct.unpack_from("<I", data, vector)[0]
+    elements = [vector + 4 + 4 * i for i in range(count)]
+    return [element + struct.unpack_from("<I", data, element)[0] for element in elements]
+
+
+def encode_changes(seq, changes):
+    """64 bit sequence number, then per change its data size, type and object ID followed by the data; terminated by
+    a header with type 0."""
+    body = struct.pack("<Q", seq)
+    for _, _, change_type, object_id, data in changes:
+        body += struct.pack("<IIQ", len(data), change_type, object_id) + data
+    return body + struct.pack("<II", 0, 0)
+
+
+def decode_body(encoding, body):
+    if encoding == "gzip":
+        return gzip.decompress(body)
+    if encoding == "deflate":
+        return zlib.decompress(body)
+    return body
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    db = Database()
+    codecs = {}
+    verbose = False
+
+    def read_body(self):
+        if self.headers.get("Transfer-Encoding", "").strip().lower() == "chunked":
+            body = b""
+            while True:
+                size = int(self.rfile.readline().split(b";")[0], 16)
+                if size == 0:
+                    # skip the trailer, up to the empty line
+                    while self.rfile.readline().strip():
+                        pass
+                    break
+                body += self.rfile.read(size)
+                self.rfile.readline()
+        else:
+            body = self.rfile.read(int(self.headers.get("Content-Length", 0)))
+        self.wire_in = len(body)
+        return decode_body(self.headers.get("Content-Encoding", "").strip(), body)
+
+    def respond(self, code, body=b""):
+        raw_size = len(body)
+        accepted = [e.split(";")[0].strip() for e in self.headers.get("Accept-Encoding", "").split(",")]
+        encoding = None
+        if len(body) >= MIN_COMPRESS_SIZE:
+            if "gzip" in accepted:
+                encoding, body = "gzip", gzip.compress(body)
+            elif "deflate" in accepted:
+                encoding, body = "deflate", zlib.compress(body)
+        self.send_response(code)
+        if encoding:
+            self.send_header("Content-Encoding", encoding)
+        self.send_header("Content-Length", str(len(body)))
+        self.end_headers()
+        self.wfile.write(body)
+        if self.verbose:
+            print("%s %s -> %d: request %d bytes (%d raw), response %d bytes (%d raw)" % (
+                self.command, self.path, code, getattr(self, "wire_in", 0), getattr(self, "raw_in", 0), len(body),
+                raw_size))
+
+    def respond_error(self, code, message):
+        """The error response parsed by the client (parse_error_response() in utilities.c)."""
+        self.respond(code, json.dumps({"error": {"code": code, "message": message}}).encode())
+
+    def route(self):
+        self.wire_in = 0
+        self.raw_in = 0
+        path = self.path.split("?")[0]
+        if not path.startswith("/api/v2/"):
+            return None
+        return path[len("/api/v2/"):]
+
+    def do_GET(self):
+        path = self.route()
+        match = re.fullmatch(r"data/(\d+)/changes", path or "")
+        if match:
+            query = dict(p.partition("=")[::2] for p in self.path.partition("?")[2].split("&"))
+            if "since" not in query:
+                # only the current sequence number, to start observing from
+                return self.respond(200, encode_changes(self.db.seq, []))
+            seq, changes = self.db.changes_since(int(match.group(1)), int(query["since"]),
+                                                 int(query.get("wait", 0)) / 1000.0)
+            return self.respond(200, encode_changes(seq, changes))
+        match = re.fullmatch(r"data/(\d+)/(count|\d+|)", path or "")
+        if not match:
+            return self.respond_error(404, "not found")
+        objects = self.db.objects(int(match.group(1)))
+        if match.group(2) == "count":
+            return self.respond(200, str(len(objects)).encode())
+        if match.group(2) == "":
+            # all objects: each prefixed by its 32 bit size, terminated by size 0
+            body = b"".join(struct.pack("<I", len(o)) + o for o in objects.values()) + struct.pack("<I", 0)
+            return self.respond(200, body)
+        data = objects.get(int(match.group(2)))
+        return self.respond(200, data) if data is not None else self.respond_error(404, "not found")
+
+    def do_POST(self):
+        path = self.route()
+        body = self.read_body()
+        self.raw_in = len(body)
+        if path == "sessions":
+            return self.respond(200, b'"0123456789"')
+        match = re.fullmatch(r"data/(\d+)(/batch)?", path or "")
+        if not match:
+            return self.respond_error(404, "not found")
+        entity_id = int(match.group(1))
+        codec = self.codecs.get(entity_id)
+        try:
+            if match.group(2):
+                if codec is None:
+                    return self.respond_error(400, "no schema for entity %d, can't split the batch" % entity_id)
+                ids = [self.db.insert(entity_id, codec.encoder(codec.decode(body, table)))
+                       for table in batch_tables(body)]
+                return self.respond(200, ",".join(str(i) for i in ids).encode())
+            encode = (lambda object_id: body) if codec is None else codec.encoder(codec.decode(body))
+            return self.respond(200, str(self.db.insert(entity_id, encode)).encode())
+        except struct.error:
+            return self.respond_error(400, "invalid FlatBuffers data")
+
+    def do_PUT(self):
+        path = self.route()
+        body = self.read_body()
+        self.raw_in = len(body)
+        match = re.fullmatch(r"data/(\d+)/(\d+)", path or "")
+        if not match:
+            return self.respond_error(404, "not found")
+        entity_id, object_id = int(match.group(1)), int(match.group(2))
+        codec = self.codecs.get(entity_id)
+        try:
+            data = body if codec is None else codec.encode(dict(codec.decode(body), id=object_id))
+        except struct.error:
+            return self.respond_error(400, "invalid FlatBuffers data")
+        if not self.db.update(entity_id, object_id, data):
+            return self.respond_error(404, "not found")
+        return self.respond(204)
+
+    def do_DELETE(self):
+        path = self.route()
+        match = re.fullmatch(r"data/(\d+)/(\d+)", path or "")
+        if not match or not self.db.delete(int(match.group(1)), int(match.group(2))):
+            return self.respond_error(404, "not found")
+        return self.respond(204)
+
+    def log_message(self, format, *args):
+        pass
+
+
+def main(argv):
+    args = argv[1:]
+    schemas = [(os.path.join(MISC_DIR, path), table, entity_id) for path, table, entity_id in DEFAULT_SCHEMAS]
+    while "--schema" in args:
+        i = args.index("--schema")
+        table, entity_id = args[i + 2].split("=")
+        schemas.append((args[i + 1], table, int(entity_id)))
+        del args[i:i + 3]
+    generator = load_generator()
+    for path, table, entity_id in schemas:
+        with open(path) as f:
+            Handler.codecs[entity_id] = TableCodec(generator.parse_tables(f.read())[table])
+
+    Handler.verbose = "--verbose" in args
+    args = [a for a in args if not a.startswith("--")]
+    port = int(args[0]) if args else 8181
+    server = http.server.ThreadingHTTPServer(("", port), Handler)
+    print("serving on port %d" % port)
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main(sys.argv)
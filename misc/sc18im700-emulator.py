@@ -0,0 +1,247 @@
+#!/usr/bin/env python3
+"""Emulates the SC18IM700 UART to I2C bridge of the Grove shield on a pseudo terminal, to run the Grove library's
+I2C code on a host without the hardware, e.g. GroveI2C, GroveI2CAsync and GroveI2CBatch.
+
+Usage: sc18im700-emulator.py [--link <path>] [--baud <rate>] [--busy] [--verbose]
+
+Prints the path of the pseudo terminal (also symlinked to <path> with --link); open it instead of the UART. The
+bridge commands S (start, also repeated), P (stop), R/W (bridge registers) and I/O (GPIO) are executed on emulated
+devices: the light sensor's AD7992 ADC (0x20), the SHT31 (0x44, its read is NACKed until the measurement is done)
+and the BME280 (0x76); other addresses are NACKed. With --baud, the UART transfer time of each byte is added.
+With --busy, a state register query that ends a chunk right after an acknowledged transfer reads a state that isn't
+final, as if the transfer were still running, until it is queried again.
+Each chunk received (one write() of the host, unless it got split) is logged with --verbose; on exit, the totals
+are printed: chunks received, bytes in and out and I2C transfers.
+"""
+import os
+import signal
+import sys
+import time
+import tty
+
+I2C_OK = 0xF0
+I2C_NACK_ON_ADDRESS = 0xF1
+I2C_NACK_ON_DATA = 0xF2
+I2C_BUSY = 0xF3  # not a final state: the transfer hasn't finished yet
+
+STATE_REGISTER = 0x0A
+
+
+class RegisterDevice:
+    """A device with a register pointer, which is set by the first byte written and incremented by each access."""
+
+    def __init__(self):
+        self.regs = bytearray(256)
+        self.pointer = 0
+
+    def write(self, data):
+        if data:
+            self.pointer = data[0]
+        for b in data[1:]:
+            self.regs[self.pointer] = b
+            self.pointer = (self.pointer + 1) & 0xFF
+        return True
+
+    def read(self, size):
+        data = bytes(self.regs[(self.pointer + i) & 0xFF] for i in range(size))
+        self.pointer = (self.pointer + size) & 0xFF
+        return data
+
+
+class AD7992(RegisterDevice):
+    VALUES = [0x800, 0x400]  # half and quarter of the reference voltage
+
+    def read(self, size):
+        if self.pointer != 0x00:
+            return RegisterDevice.read(self, size)
+        # conversion result: channel ID in the upper bits, 12 bits of value, big endian
+        channel = 1 if self.regs[0x02] & 0x20 else 0
+        value = channel << 12 | self.VALUES[channel]
+        return bytes([value >> 8, value & 0xFF] * size)[:size]
+
+
+class BME280(RegisterDevice):
+    def __init__(self):
+        RegisterDevice.__init__(self)
+        self.regs[0xD0] = 0x60
+        # the example of the datasheet's compensation code: dig_T1..3 and adc_T giving 25.08 degrees
+        self.regs[0x88:0x8E] = (27504).to_bytes(2, "little") + (26435).to_bytes(2, "little") + \
+            (-1000).to_bytes(2, "little", signed=True)
+        self.regs[0xFA:0xFD] = (519888 << 4).to_bytes(3, "big")
+
+
+class SHT31:
+    MEASUREMENT_S = 0.015
+
+    def __init__(self):
+        self.ready_at = None
+
+    @staticmethod
+    def crc8(data):
+        crc = 0xFF
+        for b in data:
+            crc ^= b
+            for _ in range(8):
+                crc = (crc << 1 ^ 0x31) & 0xFF if crc & 0x80 else crc << 1 & 0xFF
+        return crc
+
+    def write(self, data):
+        if bytes(data) == b"\x24\x00":
+            self.ready_at = time.monotonic() + self.MEASUREMENT_S
+        return len(data) == 2
+
+    def read(self, size):
+        if self.ready_at is None or time.monotonic() < self.ready_at:
+            return None
+        self.ready_at = None
+        temperature = bytes([0x66, 0x66])  # 25 degrees
+        humidity = bytes([0x80, 0x00])  # 50 %
+        data = temperature + bytes([self.crc8(temperature)]) + humidity + bytes([self.crc8(humidity)])
+        return data[:size]
+
+
+class Bridge:
+    def __init__(self, fd, baud, busy, verbose):
+        self.fd = fd
+        self.baud = baud
+        self.busy = busy
+        self.busy_pending = False
+        self.verbose = verbose
+        self.devices = {0x20: AD7992(), 0x44: SHT31(), 0x76: BME280()}
+        self.regs = bytearray(16)
+        self.regs[0x00:0x02] = b"\xF0\x02"  # 9600 baud
+        self.regs[STATE_REGISTER] = I2C_OK
+        self.gpio = 0xFF
+        self.pending = b""
+        self.chunks = 0
+        self.bytes_in = 0
+        self.bytes_out = 0
+        self.transfers = 0
+        self.busy_replies = 0
+
+    def next_byte(self):
+        while not self.pending:
+            chunk = os.read(self.fd, 1024)
+            self.chunks += 1
+            self.bytes_in += len(chunk)
+            if self.verbose:
+                print("<- %s" % chunk.hex(" "))
+            self.delay(len(chunk))
+            self.pending = chunk
+        b = self.pending[0]
+        self.pending = self.pending[1:]
+        return b
+
+    def send(self, data):
+        if not data:
+            return
+        self.delay(len(data))
+        os.write(self.fd, data)
+        self.bytes_out += len(data)
+        if self.verbose:
+            print("-> %s" % data.hex(" "))
+
+    def delay(self, size):
+        if self.baud:
+            time.sleep(size * 10.0 / self.baud)
+
+    def transfer(self):
+        """S addr n [data] ... [S addr n [data] ...] P: the parts of one transfer, joined by repeated starts."""
+        reply = b""
+        state = I2C_OK
+        command = ord("S")
+        while command == ord("S"):
+            address = self.next_byte()
+            size = self.next_byte()
+            data = bytes(self.next_byte() for _ in range(size)) if not address & 1 else None
+            device = self.devices.get(address >> 1)
+            self.transfers += 1
+            if state == I2C_OK:
+                if device is None:
+                    state = I2C_NACK_ON_ADDRESS
+                elif address & 1:
+                    read = device.read(size)
+                    if read is None:
+                        state = I2C_NACK_ON_ADDRESS
+                    else:
+                        reply += read
+                elif not device.write(data):
+                    state = I2C_NACK_ON_DATA
+            command = self.next_byte()
+        self.regs[STATE_REGISTER] = state
+        self.busy_pending = self.busy and state == I2C_OK
+        # a NACKed read returns nothing; the data of an earlier part of the same transfer is sent nevertheless
+        self.send(reply)
+
+    def run(self):
+        while True:
+            command = self.next_byte()
+            if command == ord("S"):
+                self.transfer()
+            elif command == ord("R"):
+                reply = b""
+                last = None
+                reg = self.next_byte()
+                while reg != ord("P"):
+                    last = reg & 0x0F
+                    reply += bytes([self.regs[last]])
+                    reg = self.next_byte()
+                # nothing else received after the query: it came right behind the transfer
+                if self.busy_pending and last == STATE_REGISTER and not self.pending:
+                    reply = reply[:-1] + bytes([I2C_BUSY])
+                    self.busy_replies += 1
+                self.busy_pending = False
+                self.send(reply)
+            elif command == ord("W"):
+                reg = self.next_byte()
+                while reg != ord("P"):
+                    self.regs[reg & 0x0F] = self.next_byte()
+                    reg = self.next_byte()
+            elif command == ord("I"):
+                self.next_byte()
+                self.send(bytes([self.gpio]))
+            elif command == ord("O"):
+                self.gpio = self.next_byte()
+                self.next_byte()
+            elif self.verbose:
+                print("ignoring unknown command 0x%02x" % command)
+
+    def print_totals(self):
+        print("%d chunks received, %d bytes in, %d bytes out, %d I2C transfers" % (
+            self.chunks, self.bytes_in, self.bytes_out, self.transfers))
+        if self.busy:
+            print("%d state queries answered busy" % self.busy_replies)
+
+
+def main(argv):
+    args = argv[1:]
+    link = args[args.index("--link") + 1] if "--link" in args else None
+    baud = int(args[args.index("--baud") + 1]) if "--baud" in args else 0
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    path = os.ttyname(slave)
+    if link:
+        if os.path.islink(link):
+            os.remove(link)
+        os.symlink(path, link)
+    print("emulating the SC18IM700 on %s" % path, flush=True)
+
+    bridge = Bridge(master, baud, "--busy" in args, "--verbose" in args)
+    # also when started in the background, where SIGINT is ignored by default
+    signal.signal(signal.SIGINT, signal.default_int_handler)
+    signal.signal(signal.SIGTERM, lambda signum, frame: sys.exit(0))
+    try:
+        bridge.run()
+    except (KeyboardInterrupt, SystemExit, OSError):
+        pass
+    finally:
+        bridge.print_totals()
+        if link and os.path.islink(link):
+            os.remove(link)
+        # held open until here, so reading the master doesn't fail while the host hasn't opened the terminal yet
+        os.close(slave)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Renders latency histograms from a trace dump written by obxc_trace_dump().
+
+Usage: trace-histogram.py <dump file> [<dump file> ...]
+
+Events are grouped by trace ID. For each pair of consecutive stages (e.g. enqueue -> encode) and for the whole way
+from the first recorded stage to commit, the durations of all traces containing both stages are shown as a
+histogram with power-of-two buckets, together with percentiles. Samples whose upload failed end at "response";
+repeated stages of retried uploads count from their last occurrence.
+"""
+import struct
+import sys
+
+STAGES = ["acquire", "enqueue", "encode", "send", "response", "commit"]
+HEADER = struct.Struct("<4sHHI")
+EVENT = struct.Struct("<IBQ")
+BAR_WIDTH = 50
+
+
+def read_dump(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        sys.exit("%s: too short for a trace dump" % path)
+    magic, version, stage_count, count = HEADER.unpack_from(data, 0)
+    if magic != b"OBXT" or version != 1:
+        sys.exit("%s: not a trace dump (version 1)" % path)
+    if len(data) < HEADER.size + count * EVENT.size:
+        sys.exit("%s: truncated, expected %d events" % (path, count))
+    return [EVENT.unpack_from(data, HEADER.size + i * EVENT.size) for i in range(count)]
+
+
+def group_traces(events):
+    traces = {}
+    for trace_id, stage, time_ns in events:
+        if stage < len(STAGES):
+            traces.setdefault(trace_id, {})[stage] = time_ns
+    return traces
+
+
+def percentile(sorted_values, p):
+    return sorted_values[min(len(sorted_values) - 1, int(p / 100.0 * len(sorted_values)))]
+
+
+def format_us(ns):
+    us = ns / 1000.0
+    if us >= 10000:
+        return "%.0f ms" % (us / 1000)
+    if us >= 1000:
+        return "%.1f ms" % (us / 1000)
+    return "%.0f us" % us
+
+
+def print_histogram(title, durations_ns):
+    if not durations_ns:
+        return
+    values = sorted(durations_ns)
+    print("%s: %d traces, p50 %s, p90 %s, p99 %s, max %s" % (
+        title, len(values), format_us(percentile(values, 50)), format_us(percentile(values, 90)),
+        format_us(percentile(values, 99)), format_us(values[-1])))
+
+    # bucket b holds durations below 2^b microseconds
+    buckets = {}
+    for ns in values:
+        us = ns // 1000
+        buckets[us.bit_length()] = buckets.get(us.bit_length(), 0) + 1
+    largest = max(buckets.values())
+    for b in range(min(buckets), max(buckets) + 1):
+        count = buckets.get(b, 0)
+        upper = "%d us" % (1 << b) if b < 14 else "%d ms" % ((1 << b) // 1000)
+        bar = "#" * ((count * BAR_WIDTH + largest - 1) // largest)
+        print("  < %8s %7d %s" % (upper, count, bar))
+    print("")
+
+
+def main(argv):
+    if len(argv) < 2:
+        sys.exit(__doc__)
+    events = []
+    for path in argv[1:]:
+        events += read_dump(path)
+    traces = group_traces(events)
+    print("%d events of %d traces\n" % (len(events), len(traces)))
+
+    for first in range(len(STAGES) - 1):
+        second = first + 1
+        durations = [t[second] - t[first] for t in traces.values()
+                     if first in t and second in t and t[second] >= t[first]]
+        print_histogram("%s -> %s" % (STAGES[first], STAGES[second]), durations)
+
+    commit = STAGES.index("commit")
+    durations = [t[commit] - t[min(t)] for t in traces.values() if commit in t and min(t) != commit]
+    print_histogram("end to end (first stage -> commit)", durations)
+
+
+if __name__ == "__main__":
+    main(sys.argv)
@@ -83,6 +83,9 @@ extern "C" {
 #define OBX_ERROR_ILLEGAL_RESPONSE 10602
 #define OBX_ERROR_CURL_INIT_FAILED 10603
 
+// Client side buffer errors
+#define OBX_ERROR_OUT_OF_SPACE 10701
+
 //----------------------------------------------
 // Common types
 //----------------------------------------------
@@ -103,6 +106,11 @@ typedef struct OBXC_bytes {
     size_t size;
 } OBXC_bytes;
 
+/// Alignment of each object in an OBXC_bytes_array received from the server, enough for all FlatBuffers scalars.
+/// Together with the buffer's internal alignment, this allows to read the objects in place, even on ARM.
+#define OBXC_BYTES_ALIGN 8
+#define OBXC_BYTES_ALIGN_UP(pos) (((pos) + (OBXC_BYTES_ALIGN - 1)) & ~((size_t) OBXC_BYTES_ALIGN - 1))
+
 typedef struct OBXC_bytes_array {
     OBXC_bytes* bytes;
     size_t count;
@@ -110,17 +118,26 @@ typedef struct OBXC_bytes_array {
     // if not NULL, this variable indicates that the entire array's memory is continuous and to free it,
     // only one call to free() is needed
     void* baseptr;
+
+    // set by obxc_bytes_array_verify() to the obxc_verifier all objects passed, so repeated calls with it cost nothing
+    int (*verified_by)(const void* buffer, size_t size);
 } OBXC_bytes_array;
 
 //----------------------------------------------
 // Error info
 //----------------------------------------------
 
+/// The last error of the calling thread: the library's background threads (a sampler's uploads, an observer's
+/// long-polls, verification) don't change it; a failed upload is returned by obxc_sampler_flush() instead.
 obx_err obxc_last_error_code();
 const char* obxc_last_error_message();
 obx_err obxc_last_error_secondary();
 void obxc_last_error_clear();
 
+/// Sets the last error, e.g. for errors detected by code built on top of this API (such as the generated entity
+/// code); the message is copied. Returns code, so it can be used in a return statement.
+obx_err obxc_last_error_set(obx_err code, const char* message);
+
 //----------------------------------------------
 // Store
 //----------------------------------------------
@@ -134,11 +151,112 @@ typedef struct OBXC_store_options {
     const char* user;
     const char* pass;
     OBXC_bytes model;
+
+    /// non-zero: asks the server to compress responses (e.g. of obxc_data_get_all) with any encoding cURL supports,
+    /// usually gzip and deflate; cURL decompresses them transparently
+    int accept_encoding;
+
+    /// request bodies (e.g. batches) of at least this many bytes are sent gzip compressed ("Content-Encoding: gzip"),
+    /// unless compressing doesn't make them smaller; 0 never compresses. Requires a server accepting compressed
+    /// requests and the library built with OBXC_WITH_ZLIB (linking zlib); ignored otherwise.
+    size_t compress_min_size;
+
+    /// 1 (fastest) to 9 (smallest); 0 for zlib's default (6); others are rejected by obxc_store_open()
+    int compress_level;
 } OBXC_store_options;
 
 OBXC_store* obxc_store_open(const OBXC_store_options* options);
 obx_err obxc_store_close(OBXC_store* store);
 
+/// Totals of all requests of a store so far, e.g. to weigh the bytes saved by compression against its CPU time
+typedef struct OBXC_transfer_stats {
+    uint64_t requests;
+
+    /// request bodies before and after compression
+    uint64_t sent_raw_bytes;
+    uint64_t sent_bytes;
+
+    /// response bodies as received and after decompression
+    uint64_t received_bytes;
+    uint64_t received_raw_bytes;
+
+    /// time spent compressing request bodies
+    uint64_t compress_ns;
+} OBXC_transfer_stats;
+
+obx_err obxc_store_transfer_stats(OBXC_store* store, OBXC_transfer_stats* stats);
+
+//----------------------------------------------
+// FlatBuffers builders
+//----------------------------------------------
+
+/// Takes a builder (flatcc_builder_t) from the store's pool, which is safe to use from multiple threads.
+/// Released builders are reset but keep their memory, so building objects does not allocate in steady state.
+struct flatcc_builder* obxc_builder_acquire(OBXC_store* store);
+void obxc_builder_release(OBXC_store* store, struct flatcc_builder* builder);
+
+/// Emitter state of a builder writing into one caller supplied memory region; the fields are internal.
+typedef struct OBXC_region_emitter {
+    uint8_t* start;
+    uint8_t* end;
+    uint8_t* front;
+    uint8_t* back;
+    int full;
+} OBXC_region_emitter;
+
+/// Initializes the builder to build its buffer in place inside the given region (8-byte aligned, e.g. from malloc)
+/// instead of flatcc's page ring, so any buffer up to the region's size is contiguous and needs no copy.
+/// If a buffer doesn't fit, building fails and obxc_region_builder_buffer() reports OBX_ERROR_OUT_OF_SPACE.
+/// The emitter and region must outlive the builder, which is cleaned up using flatcc_builder_clear() as usual.
+obx_err obxc_region_builder_init(struct flatcc_builder* builder, OBXC_region_emitter* emitter, void* region,
+                                 size_t size);
+
+/// Resets the builder and its region to start the next buffer; use instead of flatcc_builder_reset()
+obx_err obxc_region_builder_reset(struct flatcc_builder* builder);
+
+/// Returns the finished buffer inside the region
+void* obxc_region_builder_buffer(struct flatcc_builder* builder, size_t* size);
+
+/// Number of buffers a flatcc builder allocates internally (see flatcc_builder_alloc_type)
+#define OBXC_BUILDER_ARENA_SLICES 8
+
+/// Fixed memory for the internal buffers of builders, split into one slice per buffer type.
+typedef struct OBXC_builder_arena {
+    uint8_t* slice[OBXC_BUILDER_ARENA_SLICES];
+    size_t slice_size[OBXC_BUILDER_ARENA_SLICES];
+
+    /// largest size requested per buffer type, indexed by flatcc_builder_alloc_type; use it to tune slice_sizes
+    size_t high_water[OBXC_BUILDER_ARENA_SLICES];
+
+    /// number of requests which exceeded their slice, making the respective build fail
+    size_t failures;
+} OBXC_builder_arena;
+
+/// Splits memory into slices; slice_sizes (one per flatcc_builder_alloc_type) may be NULL to use a default split.
+obx_err obxc_builder_arena_init(OBXC_builder_arena* arena, void* memory, size_t size, const size_t* slice_sizes);
+
+/// Makes a freshly initialized builder take all its internal buffers from the arena instead of the heap.
+/// An arena must only be used by one builder; it is combinable with a region emitter (see above).
+obx_err obxc_builder_use_arena(struct flatcc_builder* builder, OBXC_builder_arena* arena);
+
+/// Maximum number of fields (vtable entries) of a table encoded using a template
+#define OBXC_TEMPLATE_MAX_FIELDS 64
+
+/// A finished buffer of a table with all fields present; as the layout of such tables doesn't depend on the values,
+/// further objects are encoded by writing their values at field_pos inside the buffer (see generate-entity-api.py).
+typedef struct OBXC_template {
+    void* buffer;
+    size_t size;
+
+    /// position of each field in buffer, indexed by field id; 0 for fields not present
+    uint32_t field_pos[OBXC_TEMPLATE_MAX_FIELDS];
+    size_t field_count;
+} OBXC_template;
+
+/// Copies the finished buffer of the builder and locates its fields; free it using obxc_template_free().
+obx_err obxc_template_init(OBXC_template* tpl, struct flatcc_builder* builder);
+void obxc_template_free(OBXC_template* tpl);
+
 //----------------------------------------------
 // Data insertion and retrieval
 //----------------------------------------------
@@ -150,9 +268,625 @@ obx_err obxc_data_insert(OBXC_store* store, int entityId, const OBXC_bytes* src,
 obx_err obxc_data_update(OBXC_store* store, int entityId, int id, const OBXC_bytes* src);
 obx_err obxc_data_delete(OBXC_store* store, int entityId, int id);
 
+/// Insert/update the finished buffer of a builder (flatcc_builder_t using its default or a region emitter) without
+/// copying it first: buffers larger than one emitter page are streamed to the server page by page.
+obx_err obxc_data_insert_builder(OBXC_store* store, int entityId, struct flatcc_builder* builder, int* id);
+obx_err obxc_data_update_builder(OBXC_store* store, int entityId, int id, struct flatcc_builder* builder);
+
 void obxc_bytes_free(OBXC_bytes* bytes);
 void obxc_bytes_array_free(OBXC_bytes_array* bytes_array);
 
+//----------------------------------------------
+// Verification of received data
+//----------------------------------------------
+
+/// Received objects are used as they come from the server; a truncated or corrupt object can make readers access
+/// memory out of its bounds. Verification is opt-in: call it before reading objects of untrusted origin.
+
+/// A root verifier generated by flatcc (e.g. TestEntity_verify_as_root() from TestEntity_verifier.h);
+/// returns flatcc_verify_ok (0) if the buffer is a valid FlatBuffer of the table type.
+typedef int obxc_verifier(const void* buffer, size_t size);
+
+/// Maximum number of threads obxc_bytes_array_verify() may use
+#define OBXC_VERIFY_MAX_THREADS 8
+
+typedef struct OBXC_verify_stats {
+    /// number and total size of objects verified; size / duration yields the throughput
+    size_t objects;
+    size_t bytes;
+    uint64_t duration_ns;
+
+    /// flatcc_verify_error_* of the first invalid object (see flatcc_verify_error_string()) and its index
+    int error;
+    size_t error_index;
+} OBXC_verify_stats;
+
+/// Fails with OBX_ERROR_ILLEGAL_RESPONSE if the object is invalid; the secondary error code is the flatcc reason.
+obx_err obxc_bytes_verify(const OBXC_bytes* bytes, obxc_verifier* verifier);
+
+/// Verifies all objects, e.g. of obxc_box_get_all(), split into chunks over up to the given number of threads.
+/// On success, the array is marked as verified by this verifier (see verified_by) and further calls with the same
+/// verifier return immediately without verifying again; a different verifier checks all objects again.
+/// stats may be NULL; on failure, it tells the first invalid object as does the last error message.
+obx_err obxc_bytes_array_verify(OBXC_bytes_array* array, obxc_verifier* verifier, size_t threads,
+                                OBXC_verify_stats* stats);
+
+/// Verifies the objects [begin, end) only, e.g. to spread the work over the caller's own threads;
+/// the array isn't modified so different ranges can be verified concurrently.
+obx_err obxc_bytes_array_verify_range(const OBXC_bytes_array* array, size_t begin, size_t end,
+                                      obxc_verifier* verifier, OBXC_verify_stats* stats);
+
+//----------------------------------------------
+// Columnar projection
+//----------------------------------------------
+
+/// A scalar field to be extracted from all objects of an array into a contiguous, typed array (struct of arrays).
+/// Generated entity APIs provide a typed constructor per field, e.g. SensorDemoEntity_temperature_column(float*).
+typedef struct OBXC_column {
+    /// FlatBuffers field id, i.e. the index of the field in its table
+    uint16_t field_id;
+
+    /// element size in bytes: 1, 2, 4 or 8
+    uint8_t size;
+
+    /// one element per object of the array, in the array's order
+    void* values;
+} OBXC_column;
+
+/// Extracts the columns from all objects in a single pass; absent fields yield 0.
+/// Objects of arrays not verified before (see obxc_bytes_array_verify()) are bounds-checked while being read,
+/// an invalid object fails with OBX_ERROR_ILLEGAL_RESPONSE, leaving the columns partially filled. Each field is
+/// checked to lie within its table in any case, the verifier may have been one of another table type.
+obx_err obxc_bytes_array_project(const OBXC_bytes_array* array, const OBXC_column* columns, size_t column_count);
+
+//----------------------------------------------
+// Column statistics
+//----------------------------------------------
+
+/// Kernels over projected columns. They use AVX2 or SSE2 on x86-64 and NEON on ARM if the compiler targets them
+/// (e.g. -mavx2), a scalar loop otherwise; obxc_stats_simd() tells which one was built. Values must not be NaN.
+typedef struct OBXC_float_stats {
+    size_t count;
+    float min;
+    float max;
+    double mean;
+
+    /// population variance, i.e. the mean squared deviation from the mean
+    double variance;
+} OBXC_float_stats;
+
+/// Name of the instruction set used by the kernels: "avx2", "sse2", "neon" or "scalar"
+const char* obxc_stats_simd();
+
+/// Computes all statistics in a single pass; an empty column yields count 0 and zeros otherwise.
+obx_err obxc_float_stats(const float* values, size_t count, OBXC_float_stats* stats);
+
+/// Returns the number of values strictly greater than the threshold
+size_t obxc_float_count_above(const float* values, size_t count, float threshold);
+
+/// Smallest and largest value of a non-empty column, e.g. the time span covered by measuredAt
+obx_err obxc_uint64_range(const uint64_t* values, size_t count, uint64_t* min, uint64_t* max);
+
+/// Counts the values per window [start + i * width, start + (i + 1) * width) for i < bucket_count, e.g. readings per
+/// minute; values outside of all windows are ignored.
+obx_err obxc_uint64_buckets(const uint64_t* values, size_t count, uint64_t start, uint64_t width, uint32_t* counts,
+                            size_t bucket_count);
+
+//----------------------------------------------
+// Sorted index
+//----------------------------------------------
+
+/// In-memory index of an array's objects sorted by a uint64 field, e.g. measuredAt, answering range queries in
+/// O(log n + k) instead of scanning all objects. It holds views of the objects, which are not copied: the array must
+/// outlive the index.
+struct OBXC_index;
+typedef struct OBXC_index OBXC_index;
+
+/// Objects of a range in key order; the pointers refer to the index and remain valid until it is closed.
+typedef struct OBXC_index_range {
+    const OBXC_bytes* bytes;
+
+    /// the objects' keys, e.g. to be passed to obxc_uint64_buckets()
+    const uint64_t* keys;
+    size_t count;
+} OBXC_index_range;
+
+/// Builds an index over the given field (FlatBuffers field id) of all objects; objects with equal keys keep their
+/// order. Fails with OBX_ERROR_ILLEGAL_RESPONSE like obxc_bytes_array_project() if an object is invalid.
+OBXC_index* obxc_index(const OBXC_bytes_array* array, uint16_t field_id);
+obx_err obxc_index_close(OBXC_index* index);
+
+/// Finds the objects with min <= key <= max (both inclusive)
+obx_err obxc_index_range(const OBXC_index* index, uint64_t min, uint64_t max, OBXC_index_range* range);
+
+//----------------------------------------------
+// Box: data operations for a single entity
+//----------------------------------------------
+
+/// A box precomputes its entity's request URL once so that calls only need to append an object ID.
+/// The same box must not be used by multiple threads concurrently.
+struct OBXC_box;
+typedef struct OBXC_box OBXC_box;
+
+OBXC_box* obxc_box(OBXC_store* store, int entityId);
+obx_err obxc_box_close(OBXC_box* box);
+
+obx_err obxc_box_count(OBXC_box* box, uint64_t* count);
+obx_err obxc_box_get(OBXC_box* box, int id, OBXC_bytes* dest);
+obx_err obxc_box_get_all(OBXC_box* box, OBXC_bytes_array* dest);
+obx_err obxc_box_put(OBXC_box* box, const OBXC_bytes* src, int* id);
+obx_err obxc_box_update(OBXC_box* box, int id, const OBXC_bytes* src);
+obx_err obxc_box_delete(OBXC_box* box, int id);
+
+/// FlatBuffers builder (flatcc_builder_t) owned by the box; it is reset on every call, keeping its allocations
+struct flatcc_builder* obxc_box_builder(OBXC_box* box);
+
+/// Inserts/updates the finished buffer of a builder, e.g. the one from obxc_box_builder(); see obxc_data_insert_builder()
+obx_err obxc_box_put_builder(OBXC_box* box, struct flatcc_builder* builder, int* id);
+obx_err obxc_box_update_builder(OBXC_box* box, int id, struct flatcc_builder* builder);
+
+//----------------------------------------------
+// Batches: many objects in one buffer
+//----------------------------------------------
+
+/// Collects objects into a single FlatBuffers buffer whose root is the vector of all objects; identical strings and
+/// vectors are only stored once and referenced by all objects using them. Not thread-safe.
+/// Experimental: uploading a batch needs a server supporting it, see obxc_box_put_batch().
+struct OBXC_batch;
+typedef struct OBXC_batch OBXC_batch;
+
+OBXC_batch* obxc_batch(OBXC_store* store);
+obx_err obxc_batch_close(OBXC_batch* batch);
+
+/// Builder to create the objects with, e.g. <Table>_start(B) ... obxc_batch_add(batch, <Table>_end(B))
+struct flatcc_builder* obxc_batch_builder(OBXC_batch* batch);
+
+/// Return the flatcc_builder_ref_t of a string/vector with the given content, creating it only once per batch;
+/// must be called before starting the table using it. Returns 0 on error.
+uint32_t obxc_batch_string(OBXC_batch* batch, const char* str);
+uint32_t obxc_batch_vector(OBXC_batch* batch, const void* data, size_t count, size_t elem_size, uint16_t align);
+
+/// Adds a finished table, i.e. the ref returned by <Table>_end()
+obx_err obxc_batch_add(OBXC_batch* batch, uint32_t table);
+size_t obxc_batch_count(OBXC_batch* batch);
+
+/// Discards all objects added so far
+obx_err obxc_batch_clear(OBXC_batch* batch);
+
+/// Experimental, depends on the server: inserts all objects of the batch with a single request and starts a new batch;
+/// ids (optional) receives one ID per object. Requires a server providing the /data/<entityId>/batch endpoint, which
+/// the released objectbox-http-server doesn't (only misc/loopback-server.py does yet): it takes the batch's buffer (the
+/// root being the vector of the objects' tables, which may share strings and vectors), stores each table re-encoded
+/// as a buffer of its own and responds with the comma separated IDs in vector order. Other servers answer with an
+/// error; insert the objects one by one there, e.g. using obxc_box_put_builder().
+obx_err obxc_box_put_batch(OBXC_box* box, OBXC_batch* batch, obx_id* ids);
+
+//----------------------------------------------
+// Change feed
+//----------------------------------------------
+
+/// Change types as reported in OBXC_change.type
+#define OBXC_CHANGE_PUT 1
+#define OBXC_CHANGE_REMOVE 2
+
+/// Time the server may hold a change feed request open if there are no new changes yet
+#define OBXC_OBSERVER_WAIT_MS 4000
+
+typedef struct OBXC_change {
+    uint32_t type;
+    obx_id id;
+
+    // serialized object for OBXC_CHANGE_PUT; empty for OBXC_CHANGE_REMOVE
+    OBXC_bytes data;
+} OBXC_change;
+
+typedef struct OBXC_change_array {
+    OBXC_change* changes;
+    size_t count;
+
+    // sequence number of the last change contained; pass it as "since" to continue after these changes
+    uint64_t seq;
+
+    // as in OBXC_bytes_array, all object data lives in this single allocation
+    void* baseptr;
+} OBXC_change_array;
+
+/// Fetches all changes committed after the sequence number "since" (0 to start from the beginning).
+/// If there are none yet, the server keeps the request open for up to wait_ms milliseconds (long-poll).
+obx_err obxc_data_changes(OBXC_store* store, int entityId, uint64_t since, uint32_t wait_ms, OBXC_change_array* dest);
+void obxc_change_array_free(OBXC_change_array* changes);
+
+/// Return non-zero to continue with the next change, zero to stop
+typedef int obxc_change_visitor(void* user_data, const OBXC_change* change);
+
+/// Incremental sync: visits all changes (including removals) committed after *seq_inout until the client caught up.
+/// *seq_inout is advanced after each completely visited batch of changes; persist it to continue from there later.
+obx_err obxc_sync_since(OBXC_store* store, int entityId, uint64_t* seq_inout, obxc_change_visitor* visitor,
+                        void* user_data);
+
+struct OBXC_observer;
+typedef struct OBXC_observer OBXC_observer;
+
+/// Called from the observer's thread; changes are only valid during the call
+typedef void obxc_observer_callback(void* user_data, int entityId, const OBXC_change_array* changes);
+
+/// Starts a background thread long-polling the change feed, beginning with the changes committed after this call.
+/// Note: observers must be closed before their store is closed.
+OBXC_observer* obxc_observe(OBXC_store* store, int entityId, obxc_observer_callback* callback, void* user_data);
+obx_err obxc_observer_close(OBXC_observer* observer);
+
+//----------------------------------------------
+// Sample structs
+//----------------------------------------------
+
+typedef enum OBXC_value_kind {
+    OBXC_VALUE_SIGNED = 0,
+    OBXC_VALUE_UNSIGNED = 1,
+    OBXC_VALUE_FLOAT = 2,
+} OBXC_value_kind;
+
+/// A scalar member of a sample struct (e.g. SensorDemoEntity_t); generated entity APIs provide a constructor per
+/// scalar field, e.g. SensorDemoEntity_temperature_field().
+typedef struct OBXC_field {
+    /// offsetof() the member in the struct
+    size_t offset;
+
+    /// 1, 2, 4 or 8 bytes (4 or 8 for OBXC_VALUE_FLOAT)
+    uint8_t size;
+    OBXC_value_kind kind;
+} OBXC_field;
+
+//----------------------------------------------
+// Deadband filter
+//----------------------------------------------
+
+/// A field of a sample struct (e.g. SensorDemoEntity_t) compared by a deadband filter; generated entity APIs provide
+/// a constructor per scalar field, e.g. SensorDemoEntity_temperature_deadband(absolute, relative).
+typedef struct OBXC_deadband_field {
+    /// the compared member, e.g. SensorDemoEntity_temperature_field()
+    OBXC_field field;
+
+    /// the field changed meaningfully if it differs from the value last passed by more than
+    /// max(absolute, relative * |last value|); both 0: any change is meaningful. A change from or to NaN is
+    /// meaningful, NaN following NaN is not.
+    double absolute;
+    double relative;
+} OBXC_deadband_field;
+
+/// Passes only samples with a meaningful change in at least one of the given fields compared to the sample passed last.
+/// Fields not given (e.g. the time of measurement) are not compared. Not thread-safe.
+struct OBXC_deadband;
+typedef struct OBXC_deadband OBXC_deadband;
+
+/// heartbeat_ms: passes a sample anyway if none has passed for this long, e.g. to tell "unchanged" from "offline";
+/// 0 to disable
+OBXC_deadband* obxc_deadband(const OBXC_deadband_field* fields, size_t field_count, uint32_t heartbeat_ms);
+obx_err obxc_deadband_close(OBXC_deadband* deadband);
+
+/// Returns 1 if the sample should be sent, which makes it the reference for the following samples; 0 otherwise.
+/// The first sample always passes.
+int obxc_deadband_pass(OBXC_deadband* deadband, const void* sample);
+
+/// Forgets the last passed sample, so the next one passes, e.g. after a reconnect
+void obxc_deadband_reset(OBXC_deadband* deadband);
+
+//----------------------------------------------
+// Windowed aggregation
+//----------------------------------------------
+
+typedef struct OBXC_field_summary {
+    double min;
+    double max;
+    double sum;
+    double mean;
+} OBXC_field_summary;
+
+/// Summary of the samples with start <= time < end, emitted once the window is over
+typedef struct OBXC_window {
+    uint64_t start;
+    uint64_t end;
+    uint64_t count;
+
+    /// one per aggregated field, in the order given to obxc_aggregator(); only valid during the callback
+    const OBXC_field_summary* fields;
+    size_t field_count;
+} OBXC_window;
+
+typedef void obxc_window_callback(void* user_data, const OBXC_window* window);
+
+/// Summarizes fields of samples per time window instead of keeping every sample, e.g. one row per minute.
+/// Windows are aligned to multiples of hop in the sample's time unit and are window long: tumbling windows for
+/// hop == window, overlapping (sliding) ones for smaller hops, which window must be a multiple of.
+/// Adding a sample costs O(1); when a window is over, it's combined from window / hop partial summaries and passed to
+/// the callback (called from obxc_aggregator_add/flush). Windows without samples are skipped. Not thread-safe.
+struct OBXC_aggregator;
+typedef struct OBXC_aggregator OBXC_aggregator;
+
+/// time_field: an integer member holding the sample's time, e.g. SensorDemoEntity_measuredAt_field()
+OBXC_aggregator* obxc_aggregator(const OBXC_field* time_field, const OBXC_field* fields, size_t field_count,
+                                 uint64_t window, uint64_t hop, obxc_window_callback* callback, void* user_data);
+obx_err obxc_aggregator_close(OBXC_aggregator* aggregator);
+
+/// Samples must be added in time order: a sample older than the newest hop fails with OBX_ERROR_STD_OUT_OF_RANGE.
+obx_err obxc_aggregator_add(OBXC_aggregator* aggregator, const void* sample);
+
+/// Emits all windows containing samples, including the incomplete ones, and starts over
+obx_err obxc_aggregator_flush(OBXC_aggregator* aggregator);
+
+//----------------------------------------------
+// Time series compression
+//----------------------------------------------
+
+/// Encodes fields of consecutive samples column by column into a compact block ("Gorilla" encoding), free it using
+/// obxc_bytes_free(). Integer fields store the change of their delta (delta-of-delta), i.e. 1 bit per value for
+/// steadily increasing timestamps; float fields store the XOR with the previous value, i.e. 1 bit per unchanged value
+/// and only the differing bits otherwise. Lossless, including NaN payloads; fields not given are not stored.
+/// The server doesn't decode this format: store the block as a byte vector and decode it using obxc_series_decode().
+obx_err obxc_series_encode(const void* samples, size_t count, size_t sample_size, const OBXC_field* fields,
+                           size_t field_count, OBXC_bytes* dest);
+
+/// The number of samples in an encoded block, e.g. to size the array for obxc_series_decode()
+obx_err obxc_series_count(const void* data, size_t size, size_t* count);
+
+/// Decodes a block into an array of capacity samples, setting only the given fields, which must be the ones the block
+/// was encoded with (else OBX_ERROR_ILLEGAL_ARGUMENT). Fails with OBX_ERROR_OUT_OF_SPACE if capacity is too small and
+/// with OBX_ERROR_FILE_CORRUPT for malformed blocks.
+obx_err obxc_series_decode(const void* data, size_t size, void* samples, size_t capacity, size_t sample_size,
+                           const OBXC_field* fields, size_t field_count, size_t* count);
+
+//----------------------------------------------
+// Latency tracing
+//----------------------------------------------
+
+/// Stages of a sample on its way to the server, in order; a sampler records all stages after OBXC_TRACE_ACQUIRE
+typedef enum OBXC_trace_stage {
+    /// the sensor was read (recorded by the application)
+    OBXC_TRACE_ACQUIRE = 0,
+
+    /// the sample was pushed into the sampler
+    OBXC_TRACE_ENQUEUE = 1,
+
+    /// the sample was serialized into the upload's batch
+    OBXC_TRACE_ENCODE = 2,
+
+    /// the request containing the sample was started
+    OBXC_TRACE_SEND = 3,
+
+    /// the request's response arrived, successful or not
+    OBXC_TRACE_RESPONSE = 4,
+
+    /// the server confirmed that the sample is stored
+    OBXC_TRACE_COMMIT = 5,
+} OBXC_trace_stage;
+
+#define OBXC_TRACE_STAGE_COUNT 6
+
+/// Starts (or restarts) collecting trace events in a ring of the given capacity (rounded up to a power of two),
+/// keeping the newest events; 0 stops tracing and frees the ring. Must be called while no thread is tracing.
+obx_err obxc_trace_enable(size_t capacity);
+
+/// A new trace ID to pass along with a sample, 0 if tracing is disabled
+uint32_t obxc_trace_id(void);
+
+/// Records the current time (CLOCK_MONOTONIC) for a stage of the traced sample; does nothing for trace ID 0 or
+/// if tracing is disabled. Lock-free, may be called from any thread; doesn't touch the last error.
+void obxc_trace(uint32_t trace_id, OBXC_trace_stage stage);
+
+/// Copies the collected events into a compact binary dump, free it using obxc_bytes_free(). All numbers are little
+/// endian: a 12 byte header ("OBXT", uint16 version, uint16 stage count, uint32 event count) followed by 13 bytes
+/// per event (uint32 trace ID, uint8 stage, uint64 time in ns). misc/trace-histogram.py renders it as histograms.
+obx_err obxc_trace_dump(OBXC_bytes* dest);
+
+//----------------------------------------------
+// Sampler: buffered uploads of sensor samples
+//----------------------------------------------
+
+/// What obxc_sampler_push() does if the sampler's buffer is full because uploads can't keep up (or fail)
+typedef enum OBXC_overflow {
+    /// discards the oldest buffered sample to make room for the new one
+    OBXC_OVERFLOW_DROP_OLDEST = 0,
+
+    /// discards the new sample; the push returns OBX_ERROR_OUT_OF_SPACE
+    OBXC_OVERFLOW_DROP_NEWEST = 1,
+
+    /// waits until an upload has freed space
+    OBXC_OVERFLOW_BLOCK = 2,
+} OBXC_overflow;
+
+/// Adds one sample to the batch, e.g. the generated <Table>_sample_add()
+typedef obx_err obxc_sample_add(OBXC_batch* batch, const void* sample);
+
+/// Serializes one sample as the root of the builder's buffer, e.g. the generated <Table>_sample_build(); returns 0 on
+/// success
+typedef int obxc_sample_build(struct flatcc_builder* builder, const void* sample);
+
+/// How a sampler sends the samples of an upload to the server
+typedef enum OBXC_sampler_upload {
+    /// one insert request per sample (see obxc_box_put_builder()), which every server supports; uses the build option
+    OBXC_UPLOAD_OBJECTS = 0,
+
+    /// one request for all samples (see obxc_box_put_batch()); experimental, requires a server providing the batch
+    /// endpoint; uses the add option
+    OBXC_UPLOAD_BATCH = 1,
+} OBXC_sampler_upload;
+
+typedef struct OBXC_sampler_options {
+    int entity_id;
+
+    /// size of a sample, e.g. sizeof(SensorDemoEntity_t); samples are copied bytewise, so pointers inside them
+    /// (e.g. strings) must stay valid until the sample is uploaded
+    size_t sample_size;
+
+    /// the serializer matching upload is required, the other one may be NULL
+    OBXC_sampler_upload upload;
+    obxc_sample_build* build;
+    obxc_sample_add* add;
+
+    /// number of samples the buffer holds; it's allocated once when the sampler is created
+    size_t capacity;
+
+    /// uploads as soon as this many samples are buffered (at most capacity); also the maximum per upload
+    size_t flush_count;
+
+    /// uploads once the oldest buffered sample is this old, even if there are less than flush_count; 0 to disable
+    uint32_t flush_interval_ms;
+
+    OBXC_overflow overflow;
+
+    /// optional filter in front of the buffer, must outlive the sampler; samples it doesn't pass are only counted
+    OBXC_deadband* deadband;
+} OBXC_sampler_options;
+
+typedef struct OBXC_sampler_stats {
+    /// all samples passed to obxc_sampler_push(), i.e. uploaded + suppressed + dropped + lost + buffered
+    uint64_t pushed;
+    uint64_t uploaded;
+
+    /// samples filtered out by the deadband
+    uint64_t suppressed;
+
+    /// samples discarded by the overflow policy
+    uint64_t dropped;
+
+    /// samples of failed uploads which couldn't be retried because newer samples took their place
+    uint64_t lost;
+
+    /// requests sent successfully and failed ones: one per upload, or one per sample uploading objects one by one;
+    /// such an upload stops at its first failed request, the samples inserted before it count as uploaded
+    uint64_t requests;
+    uint64_t failed_requests;
+
+    /// samples currently waiting for upload, including the ones of a running request
+    size_t buffered;
+} OBXC_sampler_stats;
+
+/// Buffers samples in a preallocated ring and uploads them in the background (see OBXC_sampler_upload) when
+/// flush_count samples have accumulated or the oldest one is flush_interval_ms old, whichever comes first.
+/// Sampling thus continues at its own rate while a request is running; failed uploads are retried after
+/// flush_interval_ms (or a second) as long as their samples haven't been overwritten.
+/// Note: samplers must be closed before their store is closed.
+struct OBXC_sampler;
+typedef struct OBXC_sampler OBXC_sampler;
+
+OBXC_sampler* obxc_sampler(OBXC_store* store, const OBXC_sampler_options* options);
+
+/// Uploads what is left (one attempt) and stops the background thread
+obx_err obxc_sampler_close(OBXC_sampler* sampler);
+
+/// Copies the sample into the buffer; never waits for the network unless the overflow policy is OBXC_OVERFLOW_BLOCK.
+/// Safe to call from multiple threads.
+obx_err obxc_sampler_push(OBXC_sampler* sampler, const void* sample);
+
+/// Like obxc_sampler_push(), recording the stages of the given trace ID (see obxc_trace_id()); obxc_sampler_push()
+/// itself traces with a new ID while tracing is enabled.
+obx_err obxc_sampler_push_traced(OBXC_sampler* sampler, const void* sample, uint32_t trace_id);
+
+/// Uploads all buffered samples now and waits until they are uploaded; returns the error of a failed upload.
+obx_err obxc_sampler_flush(OBXC_sampler* sampler);
+
+obx_err obxc_sampler_stats(OBXC_sampler* sampler, OBXC_sampler_stats* stats);
+
+//----------------------------------------------
+// SPSC ring: lock-free queue of fixed-size records
+//----------------------------------------------
+
+typedef struct OBXC_ring_stats {
+    /// records accepted by obxc_ring_push() and taken by obxc_ring_pop() since the ring was created (size_t counters)
+    uint64_t pushed;
+    uint64_t popped;
+
+    /// records rejected by obxc_ring_push() because the ring was full
+    uint64_t dropped;
+
+    /// records currently queued and the maximum seen by the consumer so far
+    size_t depth;
+    size_t max_depth;
+    size_t capacity;
+} OBXC_ring_stats;
+
+/// Queue between exactly one producer thread (e.g. reading sensors) and one consumer thread (e.g. inserting the
+/// records via HTTP) without locks: each side only writes its own position (C11 atomics, on separate cache lines), so
+/// the producer never waits for the consumer, however slow it is. When the ring is full, new records are dropped.
+/// Unlike obxc_sampler, threads and uploads are up to the caller.
+struct OBXC_ring;
+typedef struct OBXC_ring OBXC_ring;
+
+/// capacity is rounded up to a power of two; records are copied bytewise
+OBXC_ring* obxc_ring(size_t record_size, size_t capacity);
+obx_err obxc_ring_close(OBXC_ring* ring);
+
+/// Producer only: copies the record into the ring, or drops it and returns OBX_ERROR_OUT_OF_SPACE if the ring is full.
+/// Success doesn't update the last error (see obxc_last_error_code()).
+obx_err obxc_ring_push(OBXC_ring* ring, const void* record);
+
+/// Consumer only: moves up to max_count of the oldest records into records; count receives the number (0 if empty).
+/// Success doesn't update the last error either.
+obx_err obxc_ring_pop(OBXC_ring* ring, void* records, size_t max_count, size_t* count);
+
+/// May be called from any thread
+obx_err obxc_ring_stats(OBXC_ring* ring, OBXC_ring_stats* stats);
+
+//----------------------------------------------
+// Event loop: timers and file descriptors
+//----------------------------------------------
+
+/// Events of watched file descriptors; error and hang-up conditions are always reported (as OBXC_WATCH_READ)
+typedef enum OBXC_watch_events {
+    OBXC_WATCH_READ = 1,
+    OBXC_WATCH_WRITE = 2,
+} OBXC_watch_events;
+
+/// expirations: number of periods since the last call; more than 1 if ticks were missed because the loop was busy
+typedef void obxc_timer_callback(void* user_data, uint64_t expirations);
+
+/// events: the OBXC_watch_events the file descriptor is ready for
+typedef void obxc_watch_callback(void* user_data, int fd, uint32_t events);
+
+/// How punctual a timer's callback is called, measured from the tick's deadline to the start of the callback
+typedef struct OBXC_timer_stats {
+    /// callback invocations
+    uint64_t ticks;
+
+    /// ticks that passed while the loop was busy, i.e. sum of (expirations - 1)
+    uint64_t missed;
+    uint64_t mean_lateness_ns;
+    uint64_t max_lateness_ns;
+} OBXC_timer_stats;
+
+/// Runs callbacks for periodic timers and ready file descriptors (e.g. a UART or curl multi sockets) on one thread,
+/// sleeping in between instead of polling. Timers are kept by the kernel (timerfd) at absolute deadlines of
+/// start + n * period, so periods don't drift by the time spent in callbacks. Linux only (epoll).
+/// All functions except obxc_loop_stop() must be called on the thread running the loop (or before it runs).
+struct OBXC_loop;
+typedef struct OBXC_loop OBXC_loop;
+
+struct OBXC_timer;
+typedef struct OBXC_timer OBXC_timer;
+
+OBXC_loop* obxc_loop(void);
+
+/// Closes the loop's remaining timers and file descriptor watches as well; must not be called while it's running
+obx_err obxc_loop_close(OBXC_loop* loop);
+
+/// Dispatches events until obxc_loop_stop() is called
+obx_err obxc_loop_run(OBXC_loop* loop);
+
+/// Makes obxc_loop_run() return once the pending callbacks are done (right away on its next call if it's not running);
+/// may be called from any thread and from signal handlers
+obx_err obxc_loop_stop(OBXC_loop* loop);
+
+/// Calls the callback every period_ns, the first time after delay_ns (one period if 0); the timer is owned by the
+/// loop and may be closed earlier using obxc_timer_close(), also from within its callback
+OBXC_timer* obxc_loop_timer(OBXC_loop* loop, uint64_t period_ns, uint64_t delay_ns, obxc_timer_callback* callback,
+                            void* user_data);
+obx_err obxc_timer_close(OBXC_timer* timer);
+obx_err obxc_timer_stats(OBXC_timer* timer, OBXC_timer_stats* stats);
+
+/// Calls the callback whenever fd is ready for one of the events (level-triggered); watching an fd again replaces
+/// the events and callback. The fd stays owned by the caller and must be unwatched before it's closed.
+obx_err obxc_loop_watch(OBXC_loop* loop, int fd, uint32_t events, obxc_watch_callback* callback, void* user_data);
+obx_err obxc_loop_unwatch(OBXC_loop* loop, int fd);
+
 #ifdef OBXC_USE_OBX_ALIASES
 #define OBX_bytes OBXC_bytes
 #define OBX_bytes_array OBXC_bytes_array
@@ -161,11 +895,27 @@ void obxc_bytes_array_free(OBXC_bytes_array* bytes_array);
 #define obx_last_error_message obxc_last_error_message
 #define obx_last_error_secondary obxc_last_error_secondary
 #define obx_last_error_clear obxc_last_error_clear
+#define obx_last_error_set obxc_last_error_set
 
 #define OBX_store OBXC_store
 #define OBX_store_options OBXC_store_options
 #define obx_store_open obxc_store_open
 #define obx_store_close obxc_store_close
+#define OBX_transfer_stats OBXC_transfer_stats
+#define obx_store_transfer_stats obxc_store_transfer_stats
+
+#define obx_builder_acquire obxc_builder_acquire
+#define obx_builder_release obxc_builder_release
+#define OBX_region_emitter OBXC_region_emitter
+#define obx_region_builder_init obxc_region_builder_init
+#define obx_region_builder_reset obxc_region_builder_reset
+#define obx_region_builder_buffer obxc_region_builder_buffer
+#define OBX_builder_arena OBXC_builder_arena
+#define obx_builder_arena_init obxc_builder_arena_init
+#define obx_builder_use_arena obxc_builder_use_arena
+#define OBX_template OBXC_template
+#define obx_template_init obxc_template_init
+#define obx_template_free obxc_template_free
 
 #define obx_data_count obxc_data_count
 #define obx_data_get obxc_data_get
@@ -173,9 +923,131 @@ void obxc_bytes_array_free(OBXC_bytes_array* bytes_array);
 #define obx_data_insert obxc_data_insert
 #define obx_data_update obxc_data_update
 #define obx_data_delete obxc_data_delete
+#define obx_data_insert_builder obxc_data_insert_builder
+#define obx_data_update_builder obxc_data_update_builder
 
 #define obx_bytes_free obxc_bytes_free
 #define obx_bytes_array_free obxc_bytes_array_free
+#define obx_verifier obxc_verifier
+#define OBX_verify_stats OBXC_verify_stats
+#define obx_bytes_verify obxc_bytes_verify
+#define obx_bytes_array_verify obxc_bytes_array_verify
+#define obx_bytes_array_verify_range obxc_bytes_array_verify_range
+#define OBX_column OBXC_column
+#define obx_bytes_array_project obxc_bytes_array_project
+#define OBX_float_stats OBXC_float_stats
+#define obx_stats_simd obxc_stats_simd
+#define obx_float_stats obxc_float_stats
+#define obx_float_count_above obxc_float_count_above
+#define obx_uint64_range obxc_uint64_range
+#define obx_uint64_buckets obxc_uint64_buckets
+#define OBX_index OBXC_index
+#define OBX_index_range OBXC_index_range
+#define obx_index obxc_index
+#define obx_index_close obxc_index_close
+#define obx_index_range obxc_index_range
+
+#define OBX_box OBXC_box
+#define obx_box obxc_box
+#define obx_box_close obxc_box_close
+#define obx_box_count obxc_box_count
+#define obx_box_get obxc_box_get
+#define obx_box_get_all obxc_box_get_all
+#define obx_box_put obxc_box_put
+#define obx_box_update obxc_box_update
+#define obx_box_delete obxc_box_delete
+#define obx_box_builder obxc_box_builder
+#define obx_box_put_builder obxc_box_put_builder
+#define obx_box_update_builder obxc_box_update_builder
+#define obx_box_put_batch obxc_box_put_batch
+
+#define OBX_batch OBXC_batch
+#define obx_batch obxc_batch
+#define obx_batch_close obxc_batch_close
+#define obx_batch_builder obxc_batch_builder
+#define obx_batch_string obxc_batch_string
+#define obx_batch_vector obxc_batch_vector
+#define obx_batch_add obxc_batch_add
+#define obx_batch_count obxc_batch_count
+#define obx_batch_clear obxc_batch_clear
+
+#define OBX_change OBXC_change
+#define OBX_change_array OBXC_change_array
+#define obx_data_changes obxc_data_changes
+#define obx_change_array_free obxc_change_array_free
+#define obx_change_visitor obxc_change_visitor
+#define obx_sync_since obxc_sync_since
+
+#define OBX_observer OBXC_observer
+#define obx_observer_callback obxc_observer_callback
+#define obx_observe obxc_observe
+#define obx_observer_close obxc_observer_close
+
+#define OBX_value_kind OBXC_value_kind
+#define OBX_field OBXC_field
+#define OBX_deadband_field OBXC_deadband_field
+#define OBX_deadband OBXC_deadband
+#define obx_deadband obxc_deadband
+#define obx_deadband_close obxc_deadband_close
+#define obx_deadband_pass obxc_deadband_pass
+#define obx_deadband_reset obxc_deadband_reset
+
+#define OBX_field_summary OBXC_field_summary
+#define OBX_window OBXC_window
+#define obx_window_callback obxc_window_callback
+#define OBX_aggregator OBXC_aggregator
+#define obx_aggregator obxc_aggregator
+#define obx_aggregator_close obxc_aggregator_close
+#define obx_aggregator_add obxc_aggregator_add
+#define obx_aggregator_flush obxc_aggregator_flush
+
+#define obx_series_encode obxc_series_encode
+#define obx_series_count obxc_series_count
+#define obx_series_decode obxc_series_decode
+
+#define OBX_trace_stage OBXC_trace_stage
+#define obx_trace_enable obxc_trace_enable
+#define obx_trace_id obxc_trace_id
+#define obx_trace obxc_trace
+#define obx_trace_dump obxc_trace_dump
+
+#define OBX_overflow OBXC_overflow
+#define obx_sample_add obxc_sample_add
+#define obx_sample_build obxc_sample_build
+#define OBX_sampler_upload OBXC_sampler_upload
+#define OBX_sampler_options OBXC_sampler_options
+#define OBX_sampler_stats OBXC_sampler_stats
+#define OBX_sampler OBXC_sampler
+#define obx_sampler obxc_sampler
+#define obx_sampler_close obxc_sampler_close
+#define obx_sampler_push obxc_sampler_push
+#define obx_sampler_push_traced obxc_sampler_push_traced
+#define obx_sampler_flush obxc_sampler_flush
+#define obx_sampler_stats obxc_sampler_stats
+
+#define OBX_ring_stats OBXC_ring_stats
+#define OBX_ring OBXC_ring
+#define obx_ring obxc_ring
+#define obx_ring_close obxc_ring_close
+#define obx_ring_push obxc_ring_push
+#define obx_ring_pop obxc_ring_pop
+#define obx_ring_stats obxc_ring_stats
+
+#define OBX_watch_events OBXC_watch_events
+#define obx_timer_callback obxc_timer_callback
+#define obx_watch_callback obxc_watch_callback
+#define OBX_timer_stats OBXC_timer_stats
+#define OBX_loop OBXC_loop
+#define OBX_timer OBXC_timer
+#define obx_loop obxc_loop
+#define obx_loop_close obxc_loop_close
+#define obx_loop_run obxc_loop_run
+#define obx_loop_stop obxc_loop_stop
+#define obx_loop_timer obxc_loop_timer
+#define obx_timer_close obxc_timer_close
+#define obx_timer_stats obxc_timer_stats
+#define obx_loop_watch obxc_loop_watch
+#define obx_loop_unwatch obxc_loop_unwatch
 #endif
 
 #ifdef __cplusplus
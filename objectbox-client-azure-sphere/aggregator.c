@@ -0,0 +1,197 @@
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+#include "utilities.h"
+
+// per pane and field: minimum, maximum and sum
+#define PANE_STATS 3
+
+// Windows are split into panes of one hop each, so a sample updates only its pane (O(1)) and a window is the
+// combination of its window / hop panes when it closes. Tumbling windows (hop == window) have a single pane.
+struct OBX_aggregator {
+    OBX_field time_field;
+    OBX_field* fields;
+    size_t field_count;
+    uint64_t window;
+    uint64_t hop;
+    obx_window_callback* callback;
+    void* user_data;
+
+    // ring of the panes of the newest window; current is the one samples are added to
+    size_t pane_count;
+    size_t current;
+    uint64_t* pane_samples;
+    double* pane_stats;
+    uint64_t pane_start;
+    int started;
+
+    OBX_field_summary* summaries;
+};
+
+static void pane_reset(OBX_aggregator* aggregator, size_t pane) {
+    aggregator->pane_samples[pane] = 0;
+    double* stats = aggregator->pane_stats + pane * aggregator->field_count * PANE_STATS;
+    for (size_t f = 0; f < aggregator->field_count; ++f, stats += PANE_STATS) {
+        stats[0] = DBL_MAX;
+        stats[1] = -DBL_MAX;
+        stats[2] = 0;
+    }
+}
+
+// emits the window ending with the current pane (if it has any samples) and moves on to the next pane
+static void pane_close(OBX_aggregator* aggregator) {
+    uint64_t count = 0;
+    for (size_t pane = 0; pane < aggregator->pane_count; ++pane) count += aggregator->pane_samples[pane];
+
+    if (count > 0) {
+        for (size_t f = 0; f < aggregator->field_count; ++f) {
+            OBX_field_summary* summary = aggregator->summaries + f;
+            summary->min = DBL_MAX;
+            summary->max = -DBL_MAX;
+            summary->sum = 0;
+            for (size_t pane = 0; pane < aggregator->pane_count; ++pane) {
+                if (aggregator->pane_samples[pane] == 0) continue;
+                const double* stats = aggregator->pane_stats + (pane * aggregator->field_count + f) * PANE_STATS;
+                if (stats[0] < summary->min) summary->min = stats[0];
+                if (stats[1] > summary->max) summary->max = stats[1];
+                summary->sum += stats[2];
+            }
+            summary->mean = summary->sum / (double) count;
+        }
+
+        OBX_window window;
+        window.end = aggregator->pane_start + aggregator->hop;
+        window.start = window.end > aggregator->window ? window.end - aggregator->window : 0;
+        window.count = count;
+        window.fields = aggregator->summaries;
+        window.field_count = aggregator->field_count;
+        aggregator->callback(aggregator->user_data, &window);
+    }
+
+    // the oldest pane drops out of the next window and becomes the current one
+    aggregator->current = (aggregator->current + 1) % aggregator->pane_count;
+    aggregator->pane_start += aggregator->hop;
+    pane_reset(aggregator, aggregator->current);
+}
+
+// reads the time exactly instead of through read_sample_value(), whose double would round nanosecond timestamps
+static int sample_time(const OBX_field* field, const void* sample, uint64_t* time) {
+    *time = read_sample_bits(sample, field->offset, field->size, field->kind);
+
+    // negative times can't be aligned to windows
+    return field->kind != OBXC_VALUE_SIGNED || (int64_t) *time >= 0;
+}
+
+static void aggregator_free(OBX_aggregator* aggregator) {
+    if (aggregator->fields != NULL) free(aggregator->fields);
+    if (aggregator->pane_samples != NULL) free(aggregator->pane_samples);
+    if (aggregator->pane_stats != NULL) free(aggregator->pane_stats);
+    if (aggregator->summaries != NULL) free(aggregator->summaries);
+    free(aggregator);
+}
+
+OBX_aggregator* obx_aggregator(const OBX_field* time_field, const OBX_field* fields, size_t field_count,
+                               uint64_t window, uint64_t hop, obx_window_callback* callback, void* user_data) {
+    // check if parameters are valid
+    int valid = time_field != NULL && time_field->kind != OBXC_VALUE_FLOAT && sample_field_valid(time_field) &&
+                fields != NULL && field_count > 0 && hop > 0 && window >= hop && window % hop == 0 &&
+                callback != NULL;
+    for (size_t f = 0; valid && f < field_count; ++f) valid = sample_field_valid(fields + f);
+    if (!valid) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_aggregator* aggregator = (OBX_aggregator*) calloc(1, sizeof(OBX_aggregator));
+    if (aggregator == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    aggregator->time_field = *time_field;
+    aggregator->field_count = field_count;
+    aggregator->window = window;
+    aggregator->hop = hop;
+    aggregator->callback = callback;
+    aggregator->user_data = user_data;
+    aggregator->pane_count = (size_t) (window / hop);
+
+    aggregator->fields = (OBX_field*) malloc(field_count * sizeof(OBX_field));
+    aggregator->pane_samples = (uint64_t*) malloc(aggregator->pane_count * sizeof(uint64_t));
+    aggregator->pane_stats = (double*) malloc(aggregator->pane_count * field_count * PANE_STATS * sizeof(double));
+    aggregator->summaries = (OBX_field_summary*) malloc(field_count * sizeof(OBX_field_summary));
+    if (aggregator->fields == NULL || aggregator->pane_samples == NULL || aggregator->pane_stats == NULL ||
+        aggregator->summaries == NULL) {
+        aggregator_free(aggregator);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    memcpy(aggregator->fields, fields, field_count * sizeof(OBX_field));
+    for (size_t pane = 0; pane < aggregator->pane_count; ++pane) pane_reset(aggregator, pane);
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return aggregator;
+}
+
+obx_err obx_aggregator_close(OBX_aggregator* aggregator) {
+    if (aggregator != NULL) aggregator_free(aggregator);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_aggregator_add(OBX_aggregator* aggregator, const void* sample) {
+    // check if parameters are valid
+    if (aggregator == NULL || sample == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    uint64_t time;
+    if (!sample_time(&aggregator->time_field, sample, &time)) {
+        return obx_set_last_error_code(OBX_ERROR_STD_OUT_OF_RANGE);
+    }
+
+    if (!aggregator->started) {
+        aggregator->pane_start = time - time % aggregator->hop;
+        aggregator->started = 1;
+    } else if (time < aggregator->pane_start) {
+        // the windows this sample belongs to may have been emitted already
+        return obx_set_last_error_code(OBX_ERROR_STD_OUT_OF_RANGE);
+    }
+
+    // close the panes the sample is past; after a whole window without samples, the remaining panes are all empty
+    for (size_t closed = 0; time - aggregator->pane_start >= aggregator->hop; ++closed) {
+        if (closed == aggregator->pane_count) {
+            aggregator->pane_start = time - time % aggregator->hop;
+            break;
+        }
+        pane_close(aggregator);
+    }
+
+    size_t pane = aggregator->current;
+    aggregator->pane_samples[pane]++;
+    double* stats = aggregator->pane_stats + pane * aggregator->field_count * PANE_STATS;
+    for (size_t f = 0; f < aggregator->field_count; ++f, stats += PANE_STATS) {
+        const OBX_field* field = aggregator->fields + f;
+        double value = read_sample_value(sample, field->offset, field->size, field->kind);
+        if (value < stats[0]) stats[0] = value;
+        if (value > stats[1]) stats[1] = value;
+        stats[2] += value;
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_aggregator_flush(OBX_aggregator* aggregator) {
+    // check if parameters are valid
+    if (aggregator == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // as if time went on by a whole window: all windows containing samples are emitted, including incomplete ones
+    if (aggregator->started) {
+        for (size_t pane = 0; pane < aggregator->pane_count; ++pane) pane_close(aggregator);
+        aggregator->started = 0;
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
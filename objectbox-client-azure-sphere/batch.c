@@ -0,0 +1,250 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "batch.h"
+#include "builder_pool.h"
+#include "error_manager.h"
+#include "objectbox.h"
+#include "obtypes.h"
+
+#define BATCH_INITIAL_SLOTS 64
+#define BATCH_INITIAL_OBJECTS 16
+
+// interned string or vector; its content is kept in the batch's content buffer for comparison
+typedef struct BatchEntry {
+    uint32_t hash;
+    flatcc_builder_ref_t ref;  // 0 for empty slots
+    size_t content_pos;
+    size_t content_len;
+    size_t elem_size;  // 0 for strings
+} BatchEntry;
+
+struct OBX_batch {
+    OBX_store* store;
+    flatcc_builder_t* builder;
+    int failed;
+
+    // table refs of the objects added so far
+    flatcc_builder_ref_t* objects;
+    size_t count;
+    size_t capacity;
+
+    // open addressing hash table of interned strings and vectors
+    BatchEntry* slots;
+    size_t slot_count;
+    size_t used_slots;
+    uint8_t* content;
+    size_t content_size;
+    size_t content_capacity;
+};
+
+// FNV-1a over the content and the element size, so equal bytes of different types are kept apart
+static uint32_t batch_hash(const uint8_t* data, size_t len, size_t elem_size) {
+    uint32_t hash = 2166136261u ^ (uint32_t) elem_size;
+    for (size_t i = 0; i < len; ++i) hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+static int batch_grow_slots(OBX_batch* batch) {
+    size_t slot_count = batch->slot_count * 2;
+    BatchEntry* slots = (BatchEntry*) calloc(slot_count, sizeof(BatchEntry));
+    if (slots == NULL) return -1;
+    for (size_t i = 0; i < batch->slot_count; ++i) {
+        BatchEntry* entry = batch->slots + i;
+        if (entry->ref == 0) continue;
+        size_t pos = entry->hash & (slot_count - 1);
+        while (slots[pos].ref != 0) pos = (pos + 1) & (slot_count - 1);
+        slots[pos] = *entry;
+    }
+    free(batch->slots);
+    batch->slots = slots;
+    batch->slot_count = slot_count;
+    return 0;
+}
+
+static int batch_store_content(OBX_batch* batch, const void* data, size_t len) {
+    if (batch->content_size + len > batch->content_capacity) {
+        size_t capacity = batch->content_capacity * 2;
+        while (capacity < batch->content_size + len) capacity *= 2;
+        uint8_t* content = (uint8_t*) realloc(batch->content, capacity);
+        if (content == NULL) return -1;
+        batch->content = content;
+        batch->content_capacity = capacity;
+    }
+    memcpy(batch->content + batch->content_size, data, len);
+    batch->content_size += len;
+    return 0;
+}
+
+// returns the ref of identical content created before or creates it; elem_size 0 creates a string
+static flatcc_builder_ref_t batch_intern(OBX_batch* batch, const void* data, size_t len, size_t elem_size,
+                                         uint16_t align) {
+    if (batch->failed) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return 0;
+    }
+
+    uint32_t hash = batch_hash((const uint8_t*) data, len, elem_size);
+    size_t pos = hash & (batch->slot_count - 1);
+    for (; batch->slots[pos].ref != 0; pos = (pos + 1) & (batch->slot_count - 1)) {
+        BatchEntry* entry = batch->slots + pos;
+        if (entry->hash == hash && entry->content_len == len && entry->elem_size == elem_size &&
+            memcmp(batch->content + entry->content_pos, data, len) == 0) {
+            obx_set_last_error_code(OBX_SUCCESS);
+            return entry->ref;
+        }
+    }
+
+    // new content: all objects of the batch will refer to this single copy
+    flatcc_builder_ref_t ref =
+        elem_size == 0 ? flatcc_builder_create_string(batch->builder, (const char*) data, len)
+                       : flatcc_builder_create_vector(batch->builder, data, len / elem_size, elem_size, align,
+                                                      FLATBUFFERS_COUNT_MAX(elem_size));
+    if (ref == 0) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return 0;
+    }
+    size_t content_pos = batch->content_size;
+    if (batch_store_content(batch, data, len) != 0) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return 0;
+    }
+
+    BatchEntry* entry = batch->slots + pos;
+    entry->hash = hash;
+    entry->ref = ref;
+    entry->content_pos = content_pos;
+    entry->content_len = len;
+    entry->elem_size = elem_size;
+
+    // keep the load factor below 3/4
+    if (++batch->used_slots * 4 > batch->slot_count * 3 && batch_grow_slots(batch) != 0) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return 0;
+    }
+    obx_set_last_error_code(OBX_SUCCESS);
+    return ref;
+}
+
+obx_err batch_restart(OBX_batch* batch) {
+    batch->count = 0;
+    batch->used_slots = 0;
+    batch->content_size = 0;
+    batch->failed = 0;
+    memset(batch->slots, 0, batch->slot_count * sizeof(BatchEntry));
+    if (flatcc_builder_reset(batch->builder) != 0 || flatcc_builder_start_buffer(batch->builder, 0, 0, 0) != 0) {
+        batch->failed = 1;
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+flatcc_builder_t* batch_finish(OBX_batch* batch) {
+    if (batch->failed || batch->count == 0 || flatcc_builder_get_level(batch->builder) != 1) return NULL;
+
+    // the root is the vector of all objects, so the server can locate each of them as the root of its own buffer
+    flatcc_builder_ref_t root = flatcc_builder_create_offset_vector(batch->builder, batch->objects, batch->count);
+    if (root == 0 || flatcc_builder_end_buffer(batch->builder, root) == 0) {
+        batch->failed = 1;
+        return NULL;
+    }
+    return batch->builder;
+}
+
+OBX_batch* obx_batch(OBX_store* store) {
+    if (store == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_batch* batch = (OBX_batch*) calloc(1, sizeof(OBX_batch));
+    if (batch == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    batch->store = store;
+    batch->capacity = BATCH_INITIAL_OBJECTS;
+    batch->objects = (flatcc_builder_ref_t*) malloc(batch->capacity * sizeof(flatcc_builder_ref_t));
+    batch->slot_count = BATCH_INITIAL_SLOTS;
+    batch->slots = (BatchEntry*) malloc(batch->slot_count * sizeof(BatchEntry));
+    batch->content_capacity = 256;
+    batch->content = (uint8_t*) malloc(batch->content_capacity);
+    batch->builder = builder_pool_acquire(&store->builder_pool);
+    if (batch->objects == NULL || batch->slots == NULL || batch->content == NULL || batch->builder == NULL) {
+        obx_batch_close(batch);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    if (batch_restart(batch) != OBX_SUCCESS) {
+        obx_batch_close(batch);
+        return NULL;
+    }
+    return batch;
+}
+
+obx_err obx_batch_close(OBX_batch* batch) {
+    if (batch != NULL) {
+        if (batch->builder != NULL) builder_pool_release(&batch->store->builder_pool, batch->builder);
+        if (batch->objects != NULL) free(batch->objects);
+        if (batch->slots != NULL) free(batch->slots);
+        if (batch->content != NULL) free(batch->content);
+        free(batch);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+flatcc_builder_t* obx_batch_builder(OBX_batch* batch) {
+    if (batch == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+    obx_set_last_error_code(OBX_SUCCESS);
+    return batch->builder;
+}
+
+uint32_t obx_batch_string(OBX_batch* batch, const char* str) {
+    if (batch == NULL || str == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return 0;
+    }
+    return batch_intern(batch, str, strlen(str), 0, 0);
+}
+
+uint32_t obx_batch_vector(OBX_batch* batch, const void* data, size_t count, size_t elem_size, uint16_t align) {
+    if (batch == NULL || (data == NULL && count > 0) || elem_size == 0 || align == 0) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return 0;
+    }
+    return batch_intern(batch, data, count * elem_size, elem_size, align);
+}
+
+obx_err obx_batch_add(OBX_batch* batch, uint32_t table) {
+    if (batch == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+
+    // a failed table (ref 0) leaves the builder in an undefined state, so the batch can't be sent anymore
+    if (table == 0 || batch->failed) {
+        batch->failed = 1;
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+    }
+
+    if (batch->count == batch->capacity) {
+        flatcc_builder_ref_t* objects =
+            (flatcc_builder_ref_t*) realloc(batch->objects, batch->capacity * 2 * sizeof(flatcc_builder_ref_t));
+        if (objects == NULL) return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        batch->objects = objects;
+        batch->capacity *= 2;
+    }
+    batch->objects[batch->count++] = table;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+size_t obx_batch_count(OBX_batch* batch) { return batch == NULL ? 0 : batch->count; }
+
+obx_err obx_batch_clear(OBX_batch* batch) {
+    if (batch == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    return batch_restart(batch);
+}
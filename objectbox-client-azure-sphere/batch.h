@@ -0,0 +1,13 @@
+#ifndef OBJECTBOX_BATCH_H
+#define OBJECTBOX_BATCH_H
+
+#include "flatcc/flatcc_builder.h"
+#include "objectbox.h"
+
+// ends the batch buffer, its root being the vector of all objects; returns NULL if it's empty or building failed
+flatcc_builder_t* batch_finish(OBXC_batch* batch);
+
+// discards all objects and starts a new batch buffer
+obx_err batch_restart(OBXC_batch* batch);
+
+#endif  // OBJECTBOX_BATCH_H
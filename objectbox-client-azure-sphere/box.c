@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "batch.h"
+#include "builder_pool.h"
+#include "data_operations.h"
+#include "error_manager.h"
+#include "http_utils.h"
+#include "objectbox.h"
+#include "obtypes.h"
+
+// space reserved behind the URL prefix: a 32 bit ID (10 digits), the longest suffix ("count") and '\0'
+#define BOX_URL_RESERVE 24
+
+// writes the decimal ID to dest and returns the number of characters written
+static size_t box_write_id(char* dest, unsigned int id) {
+    char digits[10];
+    size_t len = 0;
+    do {
+        digits[len++] = (char) ('0' + id % 10);
+        id /= 10;
+    } while (id != 0);
+    for (size_t i = 0; i < len; ++i) dest[i] = digits[len - 1 - i];
+    return len;
+}
+
+// completes the box's URL for the current request: "<prefix><id><suffix>", id < 0 to omit it
+static const char* box_url(OBX_box* box, int id, const char* suffix) {
+    char* pos = box->url + box->prefix_len;
+    pos[-1] = '/';  // may have been overwritten by box_url_collection
+    if (id >= 0) pos += box_write_id(pos, (unsigned int) id);
+    while (*suffix) *pos++ = *suffix++;
+    *pos = '\0';
+    return box->url;
+}
+
+// same as box_url, but for requests to the collection itself, i.e. "/data/<entityId>" without a trailing slash
+static const char* box_url_collection(OBX_box* box, const char* suffix) {
+    char* pos = box->url + box->prefix_len - 1;
+    while (*suffix) *pos++ = *suffix++;
+    *pos = '\0';
+    return box->url;
+}
+
+OBX_box* obx_box(OBX_store* store, int entityId) {
+    if (store == NULL || store->http_api == NULL || entityId < 0) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_box* box = (OBX_box*) malloc(sizeof(OBX_box));
+    if (box == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    char path[32];
+    int path_len = snprintf(path, 32, "/data/%d/", entityId);
+    size_t base_len = strlen(store->http_api->url);
+    box->url = (char*) malloc(base_len + path_len + BOX_URL_RESERVE);
+    if (box->url == NULL) {
+        free(box);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    memcpy(box->url, store->http_api->url, base_len);
+    memcpy(box->url + base_len, path, path_len + 1);
+
+    box->store = store;
+    box->entity_id = entityId;
+    box->prefix_len = base_len + path_len;
+    box->builder = NULL;
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return box;
+}
+
+obx_err obx_box_close(OBX_box* box) {
+    if (box != NULL) {
+        if (box->builder != NULL) builder_pool_release(&box->store->builder_pool, box->builder);
+        if (box->url != NULL) free(box->url);
+        free(box);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_box_count(OBX_box* box, uint64_t* count) {
+    // check if parameters are valid
+    if (box == NULL || count == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call = rest_request_url(box->store->http_api, "GET", box_url(box, -1, "count"), NULL, 0);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_count_response(call, count);
+}
+
+obx_err obx_box_get(OBX_box* box, int id, OBX_bytes* dest) {
+    // check if parameters are valid
+    if (box == NULL || id < 0 || dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call = rest_request_url(box->store->http_api, "GET", box_url(box, id, "?fb"), NULL, 0);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_get_response(call, dest);
+}
+
+obx_err obx_box_get_all(OBX_box* box, OBX_bytes_array* dest) {
+    // check if parameters are valid
+    if (box == NULL || dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call = rest_request_url(box->store->http_api, "GET", box_url(box, -1, "?fb"), NULL, 0);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_get_all_response(call, dest);
+}
+
+obx_err obx_box_put(OBX_box* box, const OBX_bytes* src, int* id) {
+    // check if parameters are valid
+    if (box == NULL || src == NULL || src->data == NULL || src->size == 0 || id == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call =
+        rest_request_url(box->store->http_api, "POST", box_url_collection(box, "?fb"), src->data, src->size);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_insert_response(call, id);
+}
+
+obx_err obx_box_update(OBX_box* box, int id, const OBX_bytes* src) {
+    // check if parameters are valid
+    if (box == NULL || id < 0 || src == NULL || src->data == NULL || src->size == 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call = rest_request_url(box->store->http_api, "PUT", box_url(box, id, "?fb"), src->data, src->size);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_no_content_response(call);
+}
+
+obx_err obx_box_delete(OBX_box* box, int id) {
+    // check if parameters are valid
+    if (box == NULL || id < 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    RestCall* call = rest_request_url(box->store->http_api, "DELETE", box_url(box, id, ""), NULL, 0);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_no_content_response(call);
+}
+
+flatcc_builder_t* obx_box_builder(OBX_box* box) {
+    if (box == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    if (box->builder == NULL) {
+        box->builder = builder_pool_acquire(&box->store->builder_pool);
+        if (box->builder == NULL) {
+            obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+            return NULL;
+        }
+    } else if (flatcc_builder_reset(box->builder) != 0) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return box->builder;
+}
+
+obx_err obx_box_put_builder(OBX_box* box, flatcc_builder_t* builder, int* id) {
+    // check if parameters are valid: the builder must hold a completely finished buffer
+    if (box == NULL || id == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    obx_err err = data_builder_check(builder);
+    if (err != OBX_SUCCESS) return obx_set_last_error_code(err);
+
+    RestCall* call = rest_call_create_url(box->store->http_api, "POST", box_url_collection(box, "?fb"));
+    call = data_builder_execute(call, builder);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_insert_response(call, id);
+}
+
+obx_err obx_box_update_builder(OBX_box* box, int id, flatcc_builder_t* builder) {
+    // check if parameters are valid: the builder must hold a completely finished buffer
+    if (box == NULL || id < 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    obx_err err = data_builder_check(builder);
+    if (err != OBX_SUCCESS) return obx_set_last_error_code(err);
+
+    RestCall* call = rest_call_create_url(box->store->http_api, "PUT", box_url(box, id, "?fb"));
+    call = data_builder_execute(call, builder);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+    return data_no_content_response(call);
+}
+
+obx_err obx_box_put_batch(OBX_box* box, OBX_batch* batch, obx_id* ids) {
+    // check if parameters are valid
+    if (box == NULL || batch == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    size_t count = obx_batch_count(batch);
+    flatcc_builder_t* builder = batch_finish(batch);
+    if (builder == NULL) return obx_set_last_error_code(count == 0 ? OBX_ERROR_ILLEGAL_ARGUMENT : OBX_ERROR_ILLEGAL_STATE);
+
+    RestCall* call = rest_call_create_url(box->store->http_api, "POST", box_url(box, -1, "batch?fb"));
+    call = data_builder_execute(call, builder);
+    obx_err err = call == NULL ? OBX_LAST_ERROR_CODE : data_ids_response(call, count, ids);
+
+    // the batch is consumed either way, a failed put must be repeated with a new one
+    if (batch_restart(batch) != OBX_SUCCESS && err == OBX_SUCCESS) err = OBX_LAST_ERROR_CODE;
+    return obx_set_last_error_code(err);
+}
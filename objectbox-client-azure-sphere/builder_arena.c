@@ -0,0 +1,81 @@
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+static_assert(OBXC_BUILDER_ARENA_SLICES == FLATCC_BUILDER_ALLOC_BUFFER_COUNT, "arena slices must match flatcc buffers");
+
+// default share of the arena per buffer type in 16ths, in the order of flatcc_builder_alloc_type:
+// vtable stack, data stack, vtable buffer, patch log, frame stack, hash table, vtable descriptors, user stack
+static const size_t arena_default_shares[OBXC_BUILDER_ARENA_SLICES] = {1, 6, 2, 1, 1, 2, 2, 1};
+
+// like flatcc_builder_default_alloc(), but "reallocating" only changes the size used within the type's fixed slice
+static int arena_alloc(void* alloc_context, flatcc_iovec_t* b, size_t request, int zero_fill, int alloc_type) {
+    OBX_builder_arena* arena = (OBX_builder_arena*) alloc_context;
+
+    // deallocation: the slice simply stays reserved for the next use
+    if (request == 0) {
+        b->iov_base = NULL;
+        b->iov_len = 0;
+        return 0;
+    }
+
+    size_t max = arena->slice_size[alloc_type];
+    if (request > max) {
+        arena->failures++;
+        return -1;
+    }
+    if (arena->high_water[alloc_type] < request) arena->high_water[alloc_type] = request;
+
+    // grow in powers of two as flatcc would, so the high-water marks reflect actual demand
+    size_t n = 32;
+    while (n < request) n *= 2;
+    if (n > max) n = max;
+
+    uint8_t* slice = arena->slice[alloc_type];
+    size_t old_len = b->iov_base == slice ? b->iov_len : 0;
+    if (zero_fill && old_len < n) memset(slice + old_len, 0, n - old_len);
+    b->iov_base = slice;
+    b->iov_len = n;
+    return 0;
+}
+
+obx_err obx_builder_arena_init(OBX_builder_arena* arena, void* memory, size_t size, const size_t* slice_sizes) {
+    // check if parameters are valid
+    if (arena == NULL || memory == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+
+    // slices start 8-byte aligned, the data stack holds scalars of up to that size
+    uint8_t* pos = (uint8_t*) memory;
+    size_t left = size;
+    for (int i = 0; i < OBXC_BUILDER_ARENA_SLICES; ++i) {
+        size_t slice_size = slice_sizes != NULL ? slice_sizes[i] : size / 16 * arena_default_shares[i];
+        slice_size &= ~(size_t) 7;
+        if (slice_size > left) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        arena->slice[i] = pos;
+        arena->slice_size[i] = slice_size;
+        arena->high_water[i] = 0;
+        pos += slice_size;
+        left -= slice_size;
+    }
+    arena->failures = 0;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_builder_use_arena(flatcc_builder_t* builder, OBX_builder_arena* arena) {
+    // check if parameters are valid
+    if (builder == NULL || arena == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+
+    // buffers already allocated by the previous allocator can't be moved into the arena
+    for (int i = 0; i < FLATCC_BUILDER_ALLOC_BUFFER_COUNT; ++i) {
+        if (builder->buffers[i].iov_base != NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+    }
+
+    builder->alloc = arena_alloc;
+    builder->alloc_context = arena;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
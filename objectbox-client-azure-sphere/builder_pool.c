@@ -0,0 +1,69 @@
+#include <stdlib.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "builder_pool.h"
+#include "error_manager.h"
+#include "objectbox.h"
+#include "obtypes.h"
+
+int builder_pool_init(BuilderPool* pool) {
+    pool->idle_count = 0;
+    return pthread_mutex_init(&pool->mutex, NULL);
+}
+
+flatcc_builder_t* builder_pool_acquire(BuilderPool* pool) {
+    flatcc_builder_t* builder = NULL;
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->idle_count > 0) builder = pool->idle[--pool->idle_count];
+    pthread_mutex_unlock(&pool->mutex);
+    if (builder != NULL) return builder;
+
+    // pool is empty: start a cold builder, which becomes warm once it is released
+    builder = (flatcc_builder_t*) malloc(sizeof(flatcc_builder_t));
+    if (builder == NULL || flatcc_builder_init(builder) != 0) {
+        free(builder);
+        return NULL;
+    }
+    return builder;
+}
+
+void builder_pool_release(BuilderPool* pool, flatcc_builder_t* builder) {
+    // reset without reducing the buffers so the next build starts with all the capacity needed before
+    if (flatcc_builder_custom_reset(builder, 0, 0) == 0) {
+        pthread_mutex_lock(&pool->mutex);
+        if (pool->idle_count < BUILDER_POOL_SIZE) {
+            pool->idle[pool->idle_count++] = builder;
+            builder = NULL;
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    if (builder != NULL) {
+        flatcc_builder_clear(builder);
+        free(builder);
+    }
+}
+
+void builder_pool_close(BuilderPool* pool) {
+    while (pool->idle_count > 0) {
+        flatcc_builder_t* builder = pool->idle[--pool->idle_count];
+        flatcc_builder_clear(builder);
+        free(builder);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+}
+
+flatcc_builder_t* obx_builder_acquire(OBX_store* store) {
+    if (store == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    flatcc_builder_t* builder = builder_pool_acquire(&store->builder_pool);
+    obx_set_last_error_code(builder == NULL ? OBX_ERROR_ALLOCATION : OBX_SUCCESS);
+    return builder;
+}
+
+void obx_builder_release(OBX_store* store, flatcc_builder_t* builder) {
+    if (store != NULL && builder != NULL) builder_pool_release(&store->builder_pool, builder);
+}
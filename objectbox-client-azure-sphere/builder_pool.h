@@ -0,0 +1,22 @@
+#ifndef OBJECTBOX_BUILDER_POOL_H
+#define OBJECTBOX_BUILDER_POOL_H
+
+#include <pthread.h>
+
+#include "flatcc/flatcc_builder.h"
+
+// number of idle builders kept per store; further released builders are deallocated
+#define BUILDER_POOL_SIZE 4
+
+typedef struct BuilderPool {
+    pthread_mutex_t mutex;
+    flatcc_builder_t* idle[BUILDER_POOL_SIZE];
+    size_t idle_count;
+} BuilderPool;
+
+int builder_pool_init(BuilderPool* pool);
+flatcc_builder_t* builder_pool_acquire(BuilderPool* pool);
+void builder_pool_release(BuilderPool* pool, flatcc_builder_t* builder);
+void builder_pool_close(BuilderPool* pool);
+
+#endif  // OBJECTBOX_BUILDER_POOL_H
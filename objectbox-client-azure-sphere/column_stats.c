@@ -0,0 +1,314 @@
+#include <float.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define STATS_SIMD "avx2"
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define STATS_SIMD "sse2"
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define STATS_SIMD "neon"
+#else
+#define STATS_SIMD "scalar"
+#endif
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// values per block accumulated in float lanes before the sums are added up in double precision; small enough to keep
+// the float sums exact to a few digits, large enough to make the double additions negligible
+#define STATS_BLOCK 1024
+
+// min/max and the sums of (value - pivot) and its square over one block; the sums are relative to a pivot close to
+// the mean so that the variance doesn't suffer from cancellation
+typedef struct FloatBlock {
+    float min;
+    float max;
+    float sum;
+    float sum_squares;
+} FloatBlock;
+
+static void float_block_scalar(const float* values, size_t count, float pivot, FloatBlock* block) {
+    for (size_t i = 0; i < count; ++i) {
+        float value = values[i], delta = value - pivot;
+        if (value < block->min) block->min = value;
+        if (value > block->max) block->max = value;
+        block->sum += delta;
+        block->sum_squares += delta * delta;
+    }
+}
+
+#if defined(__AVX2__)
+
+static inline float hsum256(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+static void float_block(const float* values, size_t count, float pivot, FloatBlock* block) {
+    size_t i = 0;
+    if (count >= 8) {
+        __m256 min = _mm256_set1_ps(block->min), max = _mm256_set1_ps(block->max);
+        __m256 sum = _mm256_setzero_ps(), sum_squares = _mm256_setzero_ps(), p = _mm256_set1_ps(pivot);
+        for (; i + 8 <= count; i += 8) {
+            __m256 v = _mm256_loadu_ps(values + i), delta = _mm256_sub_ps(v, p);
+            min = _mm256_min_ps(min, v);
+            max = _mm256_max_ps(max, v);
+            sum = _mm256_add_ps(sum, delta);
+            sum_squares = _mm256_add_ps(sum_squares, _mm256_mul_ps(delta, delta));
+        }
+        float lanes[8];
+        _mm256_storeu_ps(lanes, min);
+        for (int l = 0; l < 8; ++l) block->min = lanes[l] < block->min ? lanes[l] : block->min;
+        _mm256_storeu_ps(lanes, max);
+        for (int l = 0; l < 8; ++l) block->max = lanes[l] > block->max ? lanes[l] : block->max;
+        block->sum += hsum256(sum);
+        block->sum_squares += hsum256(sum_squares);
+    }
+    float_block_scalar(values + i, count - i, pivot, block);
+}
+
+static size_t float_count_above(const float* values, size_t count, float threshold) {
+    size_t i = 0, result = 0;
+    __m256 t = _mm256_set1_ps(threshold);
+    while (i + 8 <= count) {
+        // matching lanes are all ones (-1), subtracting them counts up; flushed before a lane could overflow
+        __m256i counts = _mm256_setzero_si256();
+        size_t end = count - i > UINT32_MAX ? i + ((size_t) UINT32_MAX & ~(size_t) 7) : count;
+        for (; i + 8 <= end; i += 8) {
+            __m256 mask = _mm256_cmp_ps(_mm256_loadu_ps(values + i), t, _CMP_GT_OQ);
+            counts = _mm256_sub_epi32(counts, _mm256_castps_si256(mask));
+        }
+        uint32_t lanes[8];
+        _mm256_storeu_si256((__m256i*) lanes, counts);
+        for (int l = 0; l < 8; ++l) result += lanes[l];
+    }
+    for (; i < count; ++i) result += values[i] > threshold;
+    return result;
+}
+
+static void uint64_range(const uint64_t* values, size_t count, uint64_t* min_out, uint64_t* max_out) {
+    uint64_t min = UINT64_MAX, max = 0;
+    size_t i = 0;
+    if (count >= 4) {
+        // AVX2 only compares signed 64 bit integers: flipping the sign bit maps the unsigned order onto it
+        const __m256i flip = _mm256_set1_epi64x((long long) 0x8000000000000000ull);
+        __m256i vmin = _mm256_set1_epi64x((long long) (UINT64_MAX ^ 0x8000000000000000ull));
+        __m256i vmax = _mm256_set1_epi64x((long long) 0x8000000000000000ull);
+        for (; i + 4 <= count; i += 4) {
+            __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (values + i)), flip);
+            vmin = _mm256_blendv_epi8(vmin, v, _mm256_cmpgt_epi64(vmin, v));
+            vmax = _mm256_blendv_epi8(vmax, v, _mm256_cmpgt_epi64(v, vmax));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i*) lanes, _mm256_xor_si256(vmin, flip));
+        for (int l = 0; l < 4; ++l) min = lanes[l] < min ? lanes[l] : min;
+        _mm256_storeu_si256((__m256i*) lanes, _mm256_xor_si256(vmax, flip));
+        for (int l = 0; l < 4; ++l) max = lanes[l] > max ? lanes[l] : max;
+    }
+    for (; i < count; ++i) {
+        if (values[i] < min) min = values[i];
+        if (values[i] > max) max = values[i];
+    }
+    *min_out = min;
+    *max_out = max;
+}
+
+#elif defined(__SSE2__)
+
+static inline float hsum128(__m128 v) {
+    v = _mm_add_ps(v, _mm_movehl_ps(v, v));
+    v = _mm_add_ss(v, _mm_shuffle_ps(v, v, 1));
+    return _mm_cvtss_f32(v);
+}
+
+static void float_block(const float* values, size_t count, float pivot, FloatBlock* block) {
+    size_t i = 0;
+    if (count >= 4) {
+        __m128 min = _mm_set1_ps(block->min), max = _mm_set1_ps(block->max);
+        __m128 sum = _mm_setzero_ps(), sum_squares = _mm_setzero_ps(), p = _mm_set1_ps(pivot);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_loadu_ps(values + i), delta = _mm_sub_ps(v, p);
+            min = _mm_min_ps(min, v);
+            max = _mm_max_ps(max, v);
+            sum = _mm_add_ps(sum, delta);
+            sum_squares = _mm_add_ps(sum_squares, _mm_mul_ps(delta, delta));
+        }
+        float lanes[4];
+        _mm_storeu_ps(lanes, min);
+        for (int l = 0; l < 4; ++l) block->min = lanes[l] < block->min ? lanes[l] : block->min;
+        _mm_storeu_ps(lanes, max);
+        for (int l = 0; l < 4; ++l) block->max = lanes[l] > block->max ? lanes[l] : block->max;
+        block->sum += hsum128(sum);
+        block->sum_squares += hsum128(sum_squares);
+    }
+    float_block_scalar(values + i, count - i, pivot, block);
+}
+
+static size_t float_count_above(const float* values, size_t count, float threshold) {
+    size_t i = 0, result = 0;
+    __m128 t = _mm_set1_ps(threshold);
+    while (i + 4 <= count) {
+        // same counting scheme as with AVX2
+        __m128i counts = _mm_setzero_si128();
+        size_t end = count - i > UINT32_MAX ? i + ((size_t) UINT32_MAX & ~(size_t) 3) : count;
+        for (; i + 4 <= end; i += 4) {
+            __m128 mask = _mm_cmpgt_ps(_mm_loadu_ps(values + i), t);
+            counts = _mm_sub_epi32(counts, _mm_castps_si128(mask));
+        }
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i*) lanes, counts);
+        result += (size_t) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    for (; i < count; ++i) result += values[i] > threshold;
+    return result;
+}
+
+// SSE2 has no 64 bit compares; the scalar loop is as fast
+#define STATS_SCALAR_UINT64
+
+#elif defined(__ARM_NEON)
+
+static void float_block(const float* values, size_t count, float pivot, FloatBlock* block) {
+    size_t i = 0;
+    if (count >= 4) {
+        float32x4_t min = vdupq_n_f32(block->min), max = vdupq_n_f32(block->max);
+        float32x4_t sum = vdupq_n_f32(0), sum_squares = vdupq_n_f32(0), p = vdupq_n_f32(pivot);
+        for (; i + 4 <= count; i += 4) {
+            float32x4_t v = vld1q_f32(values + i), delta = vsubq_f32(v, p);
+            min = vminq_f32(min, v);
+            max = vmaxq_f32(max, v);
+            sum = vaddq_f32(sum, delta);
+            sum_squares = vmlaq_f32(sum_squares, delta, delta);
+        }
+        float lanes[4];
+        vst1q_f32(lanes, min);
+        for (int l = 0; l < 4; ++l) block->min = lanes[l] < block->min ? lanes[l] : block->min;
+        vst1q_f32(lanes, max);
+        for (int l = 0; l < 4; ++l) block->max = lanes[l] > block->max ? lanes[l] : block->max;
+        vst1q_f32(lanes, sum);
+        block->sum += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        vst1q_f32(lanes, sum_squares);
+        block->sum_squares += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+    float_block_scalar(values + i, count - i, pivot, block);
+}
+
+static size_t float_count_above(const float* values, size_t count, float threshold) {
+    size_t i = 0, result = 0;
+    float32x4_t t = vdupq_n_f32(threshold);
+    while (i + 4 <= count) {
+        // same counting scheme as with AVX2
+        uint32x4_t counts = vdupq_n_u32(0);
+        size_t end = count - i > UINT32_MAX ? i + ((size_t) UINT32_MAX & ~(size_t) 3) : count;
+        for (; i + 4 <= end; i += 4) counts = vsubq_u32(counts, vcgtq_f32(vld1q_f32(values + i), t));
+        uint32_t lanes[4];
+        vst1q_u32(lanes, counts);
+        result += (size_t) lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    for (; i < count; ++i) result += values[i] > threshold;
+    return result;
+}
+
+// 64 bit vector compares are only available on AArch64, which Azure Sphere's Cortex-A7 is not
+#define STATS_SCALAR_UINT64
+
+#else
+
+static void float_block(const float* values, size_t count, float pivot, FloatBlock* block) {
+    float_block_scalar(values, count, pivot, block);
+}
+
+static size_t float_count_above(const float* values, size_t count, float threshold) {
+    size_t result = 0;
+    for (size_t i = 0; i < count; ++i) result += values[i] > threshold;
+    return result;
+}
+
+#define STATS_SCALAR_UINT64
+
+#endif
+
+#ifdef STATS_SCALAR_UINT64
+static void uint64_range(const uint64_t* values, size_t count, uint64_t* min_out, uint64_t* max_out) {
+    uint64_t min = UINT64_MAX, max = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] < min) min = values[i];
+        if (values[i] > max) max = values[i];
+    }
+    *min_out = min;
+    *max_out = max;
+}
+#endif
+
+const char* obx_stats_simd() { return STATS_SIMD; }
+
+obx_err obx_float_stats(const float* values, size_t count, OBX_float_stats* stats) {
+    // check if parameters are valid
+    if ((values == NULL && count > 0) || stats == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    memset(stats, 0, sizeof(OBX_float_stats));
+    stats->count = count;
+    if (count == 0) return obx_set_last_error_code(OBX_SUCCESS);
+
+    // the first value serves as pivot, sensor readings usually don't spread far from it
+    FloatBlock block = {FLT_MAX, -FLT_MAX, 0, 0};
+    float pivot = values[0];
+    double sum = 0, sum_squares = 0;
+    for (size_t i = 0; i < count; i += STATS_BLOCK) {
+        block.sum = 0;
+        block.sum_squares = 0;
+        float_block(values + i, count - i < STATS_BLOCK ? count - i : STATS_BLOCK, pivot, &block);
+        sum += block.sum;
+        sum_squares += block.sum_squares;
+    }
+
+    double mean_delta = sum / (double) count;
+    stats->min = block.min;
+    stats->max = block.max;
+    stats->mean = pivot + mean_delta;
+    stats->variance = sum_squares / (double) count - mean_delta * mean_delta;
+    if (stats->variance < 0) stats->variance = 0;  // rounding with all values (nearly) equal
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+size_t obx_float_count_above(const float* values, size_t count, float threshold) {
+    if (values == NULL) return 0;
+    return float_count_above(values, count, threshold);
+}
+
+obx_err obx_uint64_range(const uint64_t* values, size_t count, uint64_t* min, uint64_t* max) {
+    // check if parameters are valid
+    if (values == NULL || count == 0 || min == NULL || max == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    uint64_range(values, count, min, max);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_uint64_buckets(const uint64_t* values, size_t count, uint64_t start, uint64_t width, uint32_t* counts,
+                           size_t bucket_count) {
+    // check if parameters are valid
+    if ((values == NULL && count > 0) || width == 0 || counts == NULL || bucket_count == 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // a scatter by computed index; vector units don't help with this, but avoiding the division for values outside
+    // the window does
+    uint64_t span = bucket_count > UINT64_MAX / width ? UINT64_MAX : width * bucket_count;
+    memset(counts, 0, bucket_count * sizeof(uint32_t));
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t offset = values[i] - start;
+        if (values[i] >= start && offset < span) counts[offset / width]++;
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
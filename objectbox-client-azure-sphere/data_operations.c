@@ -3,10 +3,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "flatcc/flatcc_emitter.h"
+
 #define OBXC_USE_OBX_ALIASES
+#include "data_operations.h"
 #include "error_manager.h"
 #include "objectbox.h"
 #include "obtypes.h"
+#include "region_emitter.h"
 #include "utilities.h"
 
 #define OBX_CONSTRUCT_REST_PATH(FMTSTRING, ...) \
@@ -29,14 +33,82 @@
     RestCall* call = RESTFUNC(store->http_api, path, DATA, SIZE); \
     OBX_CHECK_REST_CALL
 
-obx_err obx_data_count(OBX_store* store, int entityId, uint64_t* count) {
-    // check if parameters are valid
-    if (store == NULL || store->http_api == NULL || entityId < 0 || count == NULL) {
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+// position inside the emitter's page ring while a buffer is being uploaded
+typedef struct EmitterStream {
+    const flatcc_emitter_page_t* page;
+    const uint8_t* cursor;
+    size_t page_left;
+    size_t left;
+} EmitterStream;
+
+// cURL read callback: copies the next bytes of the buffer from the emitter pages into cURL's send buffer
+static size_t emitter_stream_read(char* dest, size_t size, size_t nitems, void* ctx) {
+    EmitterStream* stream = (EmitterStream*) ctx;
+    size_t max = size * nitems, written = 0;
+    while (written < max && stream->left > 0) {
+        if (stream->page_left == 0) {
+            stream->page = stream->page->next;
+            stream->cursor = stream->page->page;
+            stream->page_left = stream->left < FLATCC_EMITTER_PAGE_SIZE ? stream->left : FLATCC_EMITTER_PAGE_SIZE;
+        }
+        size_t len = max - written < stream->page_left ? max - written : stream->page_left;
+        memcpy(dest + written, stream->cursor, len);
+        stream->cursor += len;
+        stream->page_left -= len;
+        stream->left -= len;
+        written += len;
     }
+    return written;
+}
 
-    // do rest call and parse response as unsigned long long
-    OBX_REST_CALL(rest_get, "/data/%d/count", entityId);
+obx_err data_builder_check(flatcc_builder_t* builder) {
+    if (builder == NULL) return OBX_ERROR_ILLEGAL_ARGUMENT;
+
+    // a region that was too small leaves an unfinished buffer behind, report the actual cause
+    OBX_region_emitter* region = region_emitter_of(builder);
+    if (region != NULL && region->full) return OBX_ERROR_OUT_OF_SPACE;
+
+    // apart from regions, only the default emitter's pages can be sent
+    if ((region == NULL && !builder->is_default_emitter) || flatcc_builder_get_level(builder) != 0 ||
+        flatcc_builder_get_buffer_size(builder) == 0) {
+        return OBX_ERROR_ILLEGAL_ARGUMENT;
+    }
+    return OBX_SUCCESS;
+}
+
+RestCall* data_builder_execute(RestCall* call, flatcc_builder_t* builder) {
+    if (call == NULL) return NULL;
+
+    // region buffers and small ones fitting into a single page are passed as they are
+    size_t size;
+    void* data = region_emitter_of(builder) != NULL ? obx_region_builder_buffer(builder, &size)
+                                                    : flatcc_builder_get_direct_buffer(builder, &size);
+    if (data != NULL) {
+        if (request_payload(call->request, data, size) != 0) {
+            rest_call_close(call);
+            return NULL;
+        }
+        rest_call_execute(call);
+        return call;
+    }
+
+    // larger ones are sent page by page, front to back, without assembling them in a separate allocation first
+    const flatcc_emitter_t* emitter = &builder->default_emit_context;
+    EmitterStream stream;
+    stream.page = emitter->front;
+    stream.cursor = emitter->front_cursor;
+    stream.page_left = FLATCC_EMITTER_PAGE_SIZE - emitter->front_left;
+    stream.left = emitter->used;
+    if (request_payload_stream(call->request, emitter_stream_read, &stream, emitter->used) != 0) {
+        rest_call_close(call);
+        return NULL;
+    }
+    rest_call_execute(call);
+    return call;
+}
+
+obx_err data_count_response(RestCall* call, uint64_t* count) {
+    // parse response as unsigned long long
     Memory* resp_mem = rest_call_response(call);
     if (resp_mem == NULL || !safe_uint64_parse(resp_mem->buf, resp_mem->size, count)) {
         if (resp_mem != NULL) parse_error_response(resp_mem);
@@ -48,14 +120,8 @@ obx_err obx_data_count(OBX_store* store, int entityId, uint64_t* count) {
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
-obx_err obx_data_get(OBX_store* store, int entityId, int id, OBX_bytes* dest) {
-    // check if parameters are valid
-    if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0 || dest == NULL) {
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
-    }
-
-    // do rest call and move data to given buffer
-    OBX_REST_CALL(rest_get, "/data/%d/%d?fb", entityId, id);
+obx_err data_get_response(RestCall* call, OBX_bytes* dest) {
+    // move data to given buffer
     Memory* resp_mem = rest_call_response(call);
     if (parse_error_response(resp_mem)) {
         rest_call_close(call);
@@ -67,14 +133,9 @@ obx_err obx_data_get(OBX_store* store, int entityId, int id, OBX_bytes* dest) {
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
-obx_err obx_data_get_all(OBX_store* store, int entityId, OBX_bytes_array* dest) {
-    // check if parameters are valid
-    if (store == NULL || store->http_api == NULL || entityId < 0 || dest == NULL) {
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
-    }
-
-    // do rest call
-    OBX_REST_CALL(rest_get, "/data/%d/?fb", entityId);
+// re-frames the entries of a get_all response in place so that each object starts at an OBXC_BYTES_ALIGN boundary;
+// objects are only ever moved towards the end, so moving them back to front never overwrites one not yet moved
+obx_err data_get_all_response(RestCall* call, OBX_bytes_array* dest) {
     Memory* resp_mem = rest_call_response(call);
     if (parse_error_response(resp_mem)) {
         rest_call_close(call);
@@ -82,44 +143,66 @@ obx_err obx_data_get_all(OBX_store* store, int entityId, OBX_bytes_array* dest)
     }
 
     // find number of entries first: entry consists of 32 bit size and this much data, last entry is indicated by size=0
-    char* curr_ptr = resp_mem->buf;
-    int chunk_idx = 0, i = 0, curr_size;
-    while (i < resp_mem->size && (curr_size = *((uint32_t*) curr_ptr)) != 0) {
-        ++chunk_idx;
-        curr_ptr += curr_size + 4;  // +4 to skip the 32 bit size as well
+    size_t pos = 0, count = 0, framed_size = 0;
+    uint32_t entry_size;
+    while (pos + 4 <= resp_mem->size && (entry_size = read_uint32_le(resp_mem->buf + pos)) != 0) {
+        if (resp_mem->size - pos - 4 < entry_size) break;
+        size_t framed_pos = pos + 4 > framed_size ? pos + 4 : framed_size;
+        framed_size = OBXC_BYTES_ALIGN_UP(framed_pos) + entry_size;
+        pos += 4 + entry_size;  // +4 to skip the 32 bit size as well
+        ++count;
     }
-    if (curr_size != 0) {
+    if (pos + 4 > resp_mem->size || entry_size != 0) {
         rest_call_close(call);
         return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
     }
-    dest->count = chunk_idx;
-    dest->bytes = (OBX_bytes*) malloc(chunk_idx * sizeof(OBX_bytes));
 
-    // re-iterate through the data to populate the entries with pointers to data
-    chunk_idx = 0;
-    curr_ptr = resp_mem->buf;
-    while ((curr_size = *((uint32_t*) curr_ptr)) != 0) {
-        dest->bytes[chunk_idx].size = curr_size;
-        dest->bytes[chunk_idx].data = curr_ptr + 4;
-        ++chunk_idx;
-        curr_ptr += curr_size + 4;
+    // padding may need more space than the size fields did
+    if (framed_size > resp_mem->size) {
+        char* grown = (char*) realloc(resp_mem->buf, framed_size);
+        if (grown == NULL) {
+            rest_call_close(call);
+            return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        }
+        resp_mem->buf = grown;
+        resp_mem->size = framed_size;
+    }
+    dest->bytes = (OBX_bytes*) malloc(count * sizeof(OBX_bytes));
+    if (dest->bytes == NULL && count != 0) {
+        rest_call_close(call);
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+    dest->count = count;
+
+    // re-iterate through the data to assign the entries their aligned positions...
+    size_t src = 0;
+    framed_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        dest->bytes[i].size = read_uint32_le(resp_mem->buf + src);
+        size_t framed_pos = src + 4 > framed_size ? src + 4 : framed_size;
+        dest->bytes[i].data = resp_mem->buf + OBXC_BYTES_ALIGN_UP(framed_pos);
+        framed_size = OBXC_BYTES_ALIGN_UP(framed_pos) + dest->bytes[i].size;
+        src += 4 + dest->bytes[i].size;
+    }
+
+    // ...and move them there, starting with the last one (pos still points to the terminating size=0)
+    for (size_t i = count; i-- > 0;) {
+        pos -= dest->bytes[i].size;
+        if (dest->bytes[i].data != resp_mem->buf + pos) {
+            memmove(dest->bytes[i].data, resp_mem->buf + pos, dest->bytes[i].size);
+        }
+        pos -= 4;
     }
 
     // move address of response to dest's base pointer to indicate that its memory is continuous
     memory_move(resp_mem, &dest->baseptr, NULL);
+    dest->verified_by = NULL;
     rest_call_close(call);
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
-obx_err obx_data_insert(OBX_store* store, int entityId, const OBX_bytes* src, int* id) {
-    // check if parameters are valid
-    if (store == NULL || store->http_api == NULL || entityId < 0 || src == NULL || src->data == NULL ||
-        src->size == 0 || id == NULL) {
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
-    }
-
-    // do rest call, new id is returned as response
-    OBX_REST_CALL_DATA(rest_post, src->data, src->size, "/data/%d?fb", entityId);
+obx_err data_insert_response(RestCall* call, int* id) {
+    // new id is returned as response
     Memory* resp_mem = rest_call_response(call);
     if (parse_error_response(resp_mem)) {
         rest_call_close(call);
@@ -131,15 +214,34 @@ obx_err obx_data_insert(OBX_store* store, int entityId, const OBX_bytes* src, in
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
-obx_err obx_data_update(OBX_store* store, int entityId, int id, const OBX_bytes* src) {
-    // check if parameters are valid
-    if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0 || src == NULL || src->data == NULL ||
-        src->size == 0) {
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+// response to batch puts: the new IDs in the order of the objects, separated by commas
+obx_err data_ids_response(RestCall* call, size_t count, obx_id* ids) {
+    Memory* resp_mem = rest_call_response(call);
+    if (resp_mem == NULL || parse_error_response(resp_mem) || call->code != 200) {
+        rest_call_close(call);
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
     }
 
-    // do rest call which responds with "204 No Content"
-    OBX_REST_CALL_DATA(rest_put, src->data, src->size, "/data/%d/%d?fb", entityId, id);
+    const char* pos = resp_mem->buf;
+    const char* end = pos + resp_mem->size;
+    size_t parsed = 0;
+    while (pos < end) {
+        const char* start = pos;
+        while (pos < end && *pos >= '0' && *pos <= '9') ++pos;
+        uint64_t id;
+        if (!safe_uint64_parse(start, pos - start, &id) || parsed == count) break;
+        if (ids != NULL) ids[parsed] = id;
+        ++parsed;
+        if (pos < end && *pos == ',') ++pos;
+    }
+    rest_call_close(call);
+
+    if (pos != end || parsed != count) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err data_no_content_response(RestCall* call) {
+    // update and delete respond with "204 No Content"
     Memory* resp_mem = rest_call_response(call);
     if (parse_error_response(resp_mem) || call->code != 204) {
         rest_call_close(call);
@@ -150,22 +252,94 @@ obx_err obx_data_update(OBX_store* store, int entityId, int id, const OBX_bytes*
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
-obx_err obx_data_delete(OBX_store* store, int entityId, int id) {
+obx_err obx_data_count(OBX_store* store, int entityId, uint64_t* count) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || count == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_REST_CALL(rest_get, "/data/%d/count", entityId);
+    return data_count_response(call, count);
+}
+
+obx_err obx_data_get(OBX_store* store, int entityId, int id, OBX_bytes* dest) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0 || dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_REST_CALL(rest_get, "/data/%d/%d?fb", entityId, id);
+    return data_get_response(call, dest);
+}
+
+obx_err obx_data_get_all(OBX_store* store, int entityId, OBX_bytes_array* dest) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_REST_CALL(rest_get, "/data/%d/?fb", entityId);
+    return data_get_all_response(call, dest);
+}
+
+obx_err obx_data_insert(OBX_store* store, int entityId, const OBX_bytes* src, int* id) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || src == NULL || src->data == NULL ||
+        src->size == 0 || id == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_REST_CALL_DATA(rest_post, src->data, src->size, "/data/%d?fb", entityId);
+    return data_insert_response(call, id);
+}
+
+obx_err obx_data_update(OBX_store* store, int entityId, int id, const OBX_bytes* src) {
     // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0 || src == NULL || src->data == NULL ||
+        src->size == 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_REST_CALL_DATA(rest_put, src->data, src->size, "/data/%d/%d?fb", entityId, id);
+    return data_no_content_response(call);
+}
+
+obx_err obx_data_insert_builder(OBX_store* store, int entityId, flatcc_builder_t* builder, int* id) {
+    // check if parameters are valid: the builder must hold a completely finished buffer
+    if (store == NULL || store->http_api == NULL || entityId < 0 || id == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    obx_err err = data_builder_check(builder);
+    if (err != OBX_SUCCESS) return obx_set_last_error_code(err);
+
+    OBX_CONSTRUCT_REST_PATH("/data/%d?fb", entityId);
+    RestCall* call = data_builder_execute(rest_call_create(store->http_api, "POST", path), builder);
+    OBX_CHECK_REST_CALL
+    return data_insert_response(call, id);
+}
+
+obx_err obx_data_update_builder(OBX_store* store, int entityId, int id, flatcc_builder_t* builder) {
+    // check if parameters are valid: the builder must hold a completely finished buffer
     if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0) {
         return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
     }
+    obx_err err = data_builder_check(builder);
+    if (err != OBX_SUCCESS) return obx_set_last_error_code(err);
 
-    // do rest call which responds with "204 No Content"
-    OBX_REST_CALL(rest_del, "/data/%d/%d", entityId, id);
-    Memory* resp_mem = rest_call_response(call);
-    if (parse_error_response(resp_mem) || call->code != 204) {
-        rest_call_close(call);
-        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+    OBX_CONSTRUCT_REST_PATH("/data/%d/%d?fb", entityId, id);
+    RestCall* call = data_builder_execute(rest_call_create(store->http_api, "PUT", path), builder);
+    OBX_CHECK_REST_CALL
+    return data_no_content_response(call);
+}
+
+obx_err obx_data_delete(OBX_store* store, int entityId, int id) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || id < 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
     }
 
-    rest_call_close(call);
-    return obx_set_last_error_code(OBX_SUCCESS);
+    OBX_REST_CALL(rest_del, "/data/%d/%d", entityId, id);
+    return data_no_content_response(call);
 }
 
 void obx_bytes_free(OBX_bytes* bytes) {
@@ -180,19 +354,17 @@ void obx_bytes_free(OBX_bytes* bytes) {
 
 void obx_bytes_array_free(OBX_bytes_array* bytes_array) {
     if (bytes_array) {
-        if (bytes_array->bytes) {
-            if (bytes_array->baseptr) {
-                free(bytes_array->baseptr);
-            } else {
-                for (int i = 0; i < bytes_array->count; ++i) {
-                    obx_bytes_free(bytes_array->bytes + i);
-                }
+        if (bytes_array->baseptr) {
+            free(bytes_array->baseptr);
+        } else if (bytes_array->bytes) {
+            for (int i = 0; i < bytes_array->count; ++i) {
+                obx_bytes_free(bytes_array->bytes + i);
             }
-            free(bytes_array->bytes);
-            bytes_array->bytes = NULL;
-            bytes_array->baseptr = NULL;
         }
-
+        if (bytes_array->bytes) free(bytes_array->bytes);
+        bytes_array->bytes = NULL;
+        bytes_array->baseptr = NULL;
+        bytes_array->verified_by = NULL;
         bytes_array->count = 0;
     }
 }
@@ -0,0 +1,22 @@
+#ifndef OBJECTBOX_DATA_OPERATIONS_H
+#define OBJECTBOX_DATA_OPERATIONS_H
+
+#include "flatcc/flatcc_builder.h"
+#include "http_utils.h"
+#include "objectbox.h"
+
+// Response handling shared by obxc_data_* and obxc_box_*; all of them close the given call
+obx_err data_count_response(RestCall* call, uint64_t* count);
+obx_err data_get_response(RestCall* call, OBXC_bytes* dest);
+obx_err data_get_all_response(RestCall* call, OBXC_bytes_array* dest);
+obx_err data_insert_response(RestCall* call, int* id);
+obx_err data_no_content_response(RestCall* call);
+obx_err data_ids_response(RestCall* call, size_t count, obx_id* ids);
+
+// Checks that the builder holds a finished buffer which can be sent using data_builder_execute(); returns an error code
+obx_err data_builder_check(flatcc_builder_t* builder);
+
+// Sends the builder's buffer as payload of the given call and executes it; returns NULL if call is NULL
+RestCall* data_builder_execute(RestCall* call, flatcc_builder_t* builder);
+
+#endif  // OBJECTBOX_DATA_OPERATIONS_H
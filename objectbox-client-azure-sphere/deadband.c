@@ -0,0 +1,103 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+#include "utilities.h"
+
+struct OBX_deadband {
+    OBX_deadband_field* fields;
+    size_t field_count;
+    uint32_t heartbeat_ms;
+
+    // field values of the last sample which passed, compared against instead of the previous sample so that
+    // slow drifts pass once they add up to a meaningful change
+    double* last;
+    uint64_t last_passed_ns;
+    int has_last;
+};
+
+static uint64_t deadband_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+OBX_deadband* obx_deadband(const OBX_deadband_field* fields, size_t field_count, uint32_t heartbeat_ms) {
+    // check if parameters are valid
+    if (fields == NULL || field_count == 0) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+    for (size_t i = 0; i < field_count; ++i) {
+        if (!sample_field_valid(&fields[i].field) || fields[i].absolute < 0 || fields[i].relative < 0) {
+            obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+            return NULL;
+        }
+    }
+
+    OBX_deadband* deadband = (OBX_deadband*) calloc(1, sizeof(OBX_deadband));
+    if (deadband == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    deadband->fields = (OBX_deadband_field*) malloc(field_count * sizeof(OBX_deadband_field));
+    deadband->last = (double*) malloc(field_count * sizeof(double));
+    if (deadband->fields == NULL || deadband->last == NULL) {
+        obx_deadband_close(deadband);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    memcpy(deadband->fields, fields, field_count * sizeof(OBX_deadband_field));
+    deadband->field_count = field_count;
+    deadband->heartbeat_ms = heartbeat_ms;
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return deadband;
+}
+
+obx_err obx_deadband_close(OBX_deadband* deadband) {
+    if (deadband != NULL) {
+        if (deadband->fields != NULL) free(deadband->fields);
+        if (deadband->last != NULL) free(deadband->last);
+        free(deadband);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+int obx_deadband_pass(OBX_deadband* deadband, const void* sample) {
+    if (deadband == NULL || sample == NULL) return 1;
+
+    uint64_t now = deadband_now_ns();
+    int pass = !deadband->has_last ||
+               (deadband->heartbeat_ms != 0 &&
+                now - deadband->last_passed_ns >= (uint64_t) deadband->heartbeat_ms * 1000000u);
+    for (size_t i = 0; i < deadband->field_count && !pass; ++i) {
+        const OBX_deadband_field* field = deadband->fields + i;
+        double last = deadband->last[i];
+        double band = field->relative * fabs(last);
+        if (band < field->absolute) band = field->absolute;
+        double value = read_sample_value(sample, field->field.offset, field->field.size, field->field.kind);
+
+        // NaN compares false, so a change from or to NaN passes as well; NaN to NaN is no change though
+        if (isnan(value) && isnan(last)) continue;
+        pass = !(fabs(value - last) <= band);
+    }
+
+    if (pass) {
+        for (size_t i = 0; i < deadband->field_count; ++i) {
+            const OBX_field* field = &deadband->fields[i].field;
+            deadband->last[i] = read_sample_value(sample, field->offset, field->size, field->kind);
+        }
+        deadband->last_passed_ns = now;
+        deadband->has_last = 1;
+    }
+    return pass;
+}
+
+void obx_deadband_reset(OBX_deadband* deadband) {
+    if (deadband != NULL) deadband->has_last = 0;
+}
@@ -1,10 +1,12 @@
+#include <stdio.h>
+
 #define OBXC_USE_OBX_ALIASES
 #include "error_manager.h"
 
-obx_err OBX_LAST_ERROR_CODE = 0;
-char* OBX_LAST_ERROR_MESSAGE;
-obx_err OBX_LAST_ERROR_SECONDARY = 0;
-char OBX_LAST_RESPONSE_ERROR_MESSAGE[256];
+_Thread_local obx_err OBX_LAST_ERROR_CODE = 0;
+_Thread_local char* OBX_LAST_ERROR_MESSAGE;
+_Thread_local obx_err OBX_LAST_ERROR_SECONDARY = 0;
+_Thread_local char OBX_LAST_RESPONSE_ERROR_MESSAGE[256];
 
 obx_err obx_last_error_code() { return OBX_LAST_ERROR_CODE; }
 
@@ -23,6 +25,13 @@ void obx_last_error_clear() {
     OBX_LAST_ERROR_MESSAGE = "";
 }
 
+obx_err obx_last_error_set(obx_err code, const char* message) {
+    snprintf(OBX_LAST_RESPONSE_ERROR_MESSAGE, sizeof(OBX_LAST_RESPONSE_ERROR_MESSAGE), "%s", message ? message : "");
+    OBX_LAST_ERROR_MESSAGE = OBX_LAST_RESPONSE_ERROR_MESSAGE;
+    OBX_LAST_ERROR_SECONDARY = 0;
+    return obx_set_last_error_code(code);
+}
+
 obx_err obx_set_last_error_code(obx_err e) {
     OBX_LAST_ERROR_CODE = e;
     return e;
@@ -3,15 +3,17 @@
 
 #include "objectbox.h"
 
-extern obx_err OBX_LAST_ERROR_CODE;
-extern char* OBX_LAST_ERROR_MESSAGE;
-extern obx_err OBX_LAST_ERROR_SECONDARY;
-extern char OBX_LAST_RESPONSE_ERROR_MESSAGE[256];
+// per thread, so the background threads (sampler, observer, verification) don't overwrite the caller's last error
+extern _Thread_local obx_err OBX_LAST_ERROR_CODE;
+extern _Thread_local char* OBX_LAST_ERROR_MESSAGE;
+extern _Thread_local obx_err OBX_LAST_ERROR_SECONDARY;
+extern _Thread_local char OBX_LAST_RESPONSE_ERROR_MESSAGE[256];
 
 obx_err obx_last_error_code();
 obx_err obx_last_error_secondary();
 const char* obx_last_error_message();
 void obx_last_error_clear();
+obx_err obx_last_error_set(obx_err code, const char* message);
 
 obx_err obx_set_last_error_code(obx_err e);
 
@@ -0,0 +1,324 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// maximum number of ready events dispatched per epoll_wait()
+#define LOOP_EVENTS 16
+
+// a timer or a watched file descriptor; registered with epoll by its address (NULL is the stop eventfd)
+typedef struct loop_source {
+    OBX_loop* loop;
+    int fd;
+
+    // removed sources are only freed after dispatching, as later events of the same epoll_wait() may refer to them
+    int removed;
+
+    // exactly one of the callbacks is set
+    obx_timer_callback* timer_callback;
+    obx_watch_callback* watch_callback;
+    void* user_data;
+    struct loop_source* next;
+} loop_source;
+
+struct OBX_timer {
+    // first member, so a timer is freed like any other source
+    loop_source source;
+    uint64_t period_ns;
+    uint64_t first_deadline_ns;
+    uint64_t expirations;
+
+    uint64_t ticks;
+    uint64_t missed;
+    uint64_t lateness_sum_ns;
+    uint64_t lateness_max_ns;
+};
+
+struct OBX_loop {
+    int epoll_fd;
+    int stop_fd;
+    loop_source* sources;
+    int dispatching;
+};
+
+static uint64_t loop_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+// frees the removed sources unless they may still be referenced by the events being dispatched
+static void loop_sweep(OBX_loop* loop) {
+    if (loop->dispatching) return;
+    loop_source** link = &loop->sources;
+    while (*link != NULL) {
+        loop_source* source = *link;
+        if (source->removed) {
+            *link = source->next;
+            free(source);
+        } else {
+            link = &source->next;
+        }
+    }
+}
+
+static void loop_remove(loop_source* source) {
+    epoll_ctl(source->loop->epoll_fd, EPOLL_CTL_DEL, source->fd, NULL);
+    if (source->timer_callback != NULL) close(source->fd);
+    source->removed = 1;
+    loop_sweep(source->loop);
+}
+
+static void timer_tick(OBX_timer* timer) {
+    uint64_t expirations;
+    // the timerfd is non-blocking: nothing to read means the tick was already handled (e.g. the timer was re-armed)
+    if (read(timer->source.fd, &expirations, sizeof(expirations)) != sizeof(expirations) || expirations == 0) return;
+
+    // the deadline of the latest expiration; lateness includes the time the loop spent in other callbacks
+    timer->expirations += expirations;
+    uint64_t deadline = timer->first_deadline_ns + (timer->expirations - 1) * timer->period_ns;
+    uint64_t now = loop_now_ns();
+    uint64_t lateness = now > deadline ? now - deadline : 0;
+    timer->ticks++;
+    timer->missed += expirations - 1;
+    timer->lateness_sum_ns += lateness;
+    if (lateness > timer->lateness_max_ns) timer->lateness_max_ns = lateness;
+
+    timer->source.timer_callback(timer->source.user_data, expirations);
+}
+
+static uint32_t watch_events_to_epoll(uint32_t events) {
+    uint32_t result = 0;
+    if (events & OBXC_WATCH_READ) result |= EPOLLIN;
+    if (events & OBXC_WATCH_WRITE) result |= EPOLLOUT;
+    return result;
+}
+
+static uint32_t watch_events_from_epoll(uint32_t events) {
+    uint32_t result = 0;
+    if (events & (EPOLLIN | EPOLLERR | EPOLLHUP)) result |= OBXC_WATCH_READ;
+    if (events & EPOLLOUT) result |= OBXC_WATCH_WRITE;
+    return result;
+}
+
+OBX_loop* obx_loop(void) {
+    OBX_loop* loop = (OBX_loop*) calloc(1, sizeof(OBX_loop));
+    if (loop == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (loop->epoll_fd < 0 || loop->stop_fd < 0 || epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->stop_fd, &event)) {
+        if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+        if (loop->stop_fd >= 0) close(loop->stop_fd);
+        free(loop);
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return loop;
+}
+
+obx_err obx_loop_close(OBX_loop* loop) {
+    if (loop != NULL) {
+        while (loop->sources != NULL) {
+            loop_source* source = loop->sources;
+            loop->sources = source->next;
+            if (!source->removed && source->timer_callback != NULL) close(source->fd);
+            free(source);
+        }
+        close(loop->stop_fd);
+        close(loop->epoll_fd);
+        free(loop);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_loop_run(OBX_loop* loop) {
+    // check if parameters are valid
+    if (loop == NULL || loop->dispatching) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    struct epoll_event events[LOOP_EVENTS];
+    int stop = 0;
+    while (!stop) {
+        int count = epoll_wait(loop->epoll_fd, events, LOOP_EVENTS, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        }
+
+        loop->dispatching = 1;
+        for (int i = 0; i < count; ++i) {
+            loop_source* source = (loop_source*) events[i].data.ptr;
+            if (source == NULL) {
+                uint64_t value;
+                if (read(loop->stop_fd, &value, sizeof(value)) > 0) stop = 1;
+            } else if (source->removed) {
+                continue;
+            } else if (source->timer_callback != NULL) {
+                timer_tick((OBX_timer*) source);
+            } else {
+                source->watch_callback(source->user_data, source->fd, watch_events_from_epoll(events[i].events));
+            }
+        }
+        loop->dispatching = 0;
+        loop_sweep(loop);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_loop_stop(OBX_loop* loop) {
+    // check if parameters are valid
+    if (loop == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // only write() here, which is async-signal-safe
+    uint64_t one = 1;
+    if (write(loop->stop_fd, &one, sizeof(one)) != sizeof(one) && errno != EAGAIN) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+OBX_timer* obx_loop_timer(OBX_loop* loop, uint64_t period_ns, uint64_t delay_ns, obx_timer_callback* callback,
+                          void* user_data) {
+    // check if parameters are valid
+    if (loop == NULL || period_ns == 0 || callback == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_timer* timer = (OBX_timer*) calloc(1, sizeof(OBX_timer));
+    if (timer == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    timer->source.loop = loop;
+    timer->source.timer_callback = callback;
+    timer->source.user_data = user_data;
+    timer->period_ns = period_ns;
+    timer->first_deadline_ns = loop_now_ns() + (delay_ns != 0 ? delay_ns : period_ns);
+
+    // absolute deadlines on the same clock as loop_now_ns(), repeated by the kernel without accumulating delays
+    struct itimerspec spec;
+    spec.it_value.tv_sec = (time_t) (timer->first_deadline_ns / 1000000000u);
+    spec.it_value.tv_nsec = (long) (timer->first_deadline_ns % 1000000000u);
+    spec.it_interval.tv_sec = (time_t) (period_ns / 1000000000u);
+    spec.it_interval.tv_nsec = (long) (period_ns % 1000000000u);
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.ptr = timer;
+    timer->source.fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timer->source.fd < 0 || timerfd_settime(timer->source.fd, TFD_TIMER_ABSTIME, &spec, NULL) ||
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, timer->source.fd, &event)) {
+        if (timer->source.fd >= 0) close(timer->source.fd);
+        free(timer);
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
+    timer->source.next = loop->sources;
+    loop->sources = &timer->source;
+    obx_set_last_error_code(OBX_SUCCESS);
+    return timer;
+}
+
+obx_err obx_timer_close(OBX_timer* timer) {
+    if (timer != NULL && !timer->source.removed) loop_remove(&timer->source);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_timer_stats(OBX_timer* timer, OBX_timer_stats* stats) {
+    // check if parameters are valid
+    if (timer == NULL || stats == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    stats->ticks = timer->ticks;
+    stats->missed = timer->missed;
+    stats->mean_lateness_ns = timer->ticks > 0 ? timer->lateness_sum_ns / timer->ticks : 0;
+    stats->max_lateness_ns = timer->lateness_max_ns;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+static loop_source* loop_find_watch(OBX_loop* loop, int fd) {
+    for (loop_source* source = loop->sources; source != NULL; source = source->next) {
+        if (!source->removed && source->watch_callback != NULL && source->fd == fd) return source;
+    }
+    return NULL;
+}
+
+obx_err obx_loop_watch(OBX_loop* loop, int fd, uint32_t events, obx_watch_callback* callback, void* user_data) {
+    // check if parameters are valid
+    if (loop == NULL || fd < 0 || events == 0 || (events & ~(uint32_t) (OBXC_WATCH_READ | OBXC_WATCH_WRITE)) ||
+        callback == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = watch_events_to_epoll(events);
+
+    loop_source* source = loop_find_watch(loop, fd);
+    if (source != NULL) {
+        event.data.ptr = source;
+        if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, fd, &event)) {
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        }
+        source->watch_callback = callback;
+        source->user_data = user_data;
+        return obx_set_last_error_code(OBX_SUCCESS);
+    }
+
+    source = (loop_source*) calloc(1, sizeof(loop_source));
+    if (source == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+    source->loop = loop;
+    source->fd = fd;
+    source->watch_callback = callback;
+    source->user_data = user_data;
+    event.data.ptr = source;
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event)) {
+        free(source);
+        return obx_set_last_error_code(errno == EPERM ? OBX_ERROR_ILLEGAL_ARGUMENT : OBX_ERROR_ILLEGAL_STATE);
+    }
+
+    source->next = loop->sources;
+    loop->sources = source;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_loop_unwatch(OBX_loop* loop, int fd) {
+    // check if parameters are valid
+    if (loop == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    loop_source* source = loop_find_watch(loop, fd);
+    if (source == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    loop_remove(source);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
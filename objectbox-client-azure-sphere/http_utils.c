@@ -1,6 +1,10 @@
 #include <string.h>
+#include <time.h>
 
 #include <curl/curl.h>
+#ifdef OBXC_WITH_ZLIB
+#include <zlib.h>
+#endif
 
 #define OBXC_USE_OBX_ALIASES
 #include "error_manager.h"
@@ -28,8 +32,6 @@ obx_err init_curl(CURL** handle, Memory** mem) {
     curl_easy_setopt(*handle, CURLOPT_WRITEFUNCTION, memory_grow);
     curl_easy_setopt(*handle, CURLOPT_WRITEDATA, *mem);
 
-    // for completeness:
-    // curl_easy_setopt(*handle, CURLOPT_ENCODING, "gzip, deflate");
     curl_easy_setopt(*handle, CURLOPT_TIMEOUT, 5L);
     curl_easy_setopt(*handle, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(*handle, CURLOPT_MAXREDIRS, 10L);
@@ -39,6 +41,170 @@ obx_err init_curl(CURL** handle, Memory** mem) {
     return obx_set_last_error_code(OBX_SUCCESS);
 }
 
+#ifdef OBXC_WITH_ZLIB
+// deflate needs (1 << (window_bits + 2)) + (1 << (mem_level + 9)) bytes: 48 KB with these instead of the 256 KB of
+// zlib's defaults, which would be all the RAM an MT3620 application has; costs a few percent of compression
+#define GZIP_WINDOW_BITS 13
+#define GZIP_MEM_LEVEL 5
+#define GZIP_STREAM_CHUNK 1024
+
+static uint64_t gzip_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static int gzip_init(z_stream* z, int level) {
+    return deflateInit2(z, level == 0 ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, GZIP_WINDOW_BITS + 16,
+                        GZIP_MEM_LEVEL, Z_DEFAULT_STRATEGY);
+}
+
+// compresses a body given as data; the output is sized for the worst case up front, so deflate() never runs out of
+// space. Returns NULL if zlib is out of memory, as the level was validated by obx_store_open().
+static void* gzip_compress(const void* data, size_t size, int level, size_t* compressed_size) {
+    z_stream z;
+    memset(&z, 0, sizeof(z));
+    if (gzip_init(&z, level) != Z_OK) return NULL;
+    size_t capacity = deflateBound(&z, (uLong) size);
+    uint8_t* out = (uint8_t*) malloc(capacity);
+    if (out == NULL) {
+        deflateEnd(&z);
+        return NULL;
+    }
+    z.next_in = (Bytef*) data;
+    z.avail_in = (uInt) size;
+    z.next_out = out;
+    z.avail_out = (uInt) capacity;
+    int rc = deflate(&z, Z_FINISH);
+    deflateEnd(&z);
+    if (rc != Z_STREAM_END) {
+        free(out);
+        return NULL;
+    }
+    *compressed_size = z.total_out;
+    return out;
+}
+
+// a streamed body compressed while cURL pulls it: only the deflate state and one input chunk are held, never the
+// whole body, which is sent with chunked transfer encoding as its compressed size isn't known up front
+typedef struct GzipStream {
+    z_stream z;
+    HttpApi* api;
+    curl_read_callback read;
+    void* ctx;
+    size_t left;  // bytes still to pull from read
+    int finished;
+    char chunk[GZIP_STREAM_CHUNK];
+} GzipStream;
+
+static size_t gzip_stream_read(char* buffer, size_t size, size_t nitems, void* ctx) {
+    GzipStream* stream = (GzipStream*) ctx;
+    uint64_t start = gzip_now_ns();
+    size_t result = 0;
+    stream->z.next_out = (Bytef*) buffer;
+    stream->z.avail_out = (uInt) (size * nitems);
+    while (stream->z.avail_out > 0 && !stream->finished) {
+        if (stream->z.avail_in == 0 && stream->left > 0) {
+            size_t want = stream->left < sizeof(stream->chunk) ? stream->left : sizeof(stream->chunk);
+            size_t n = stream->read(stream->chunk, 1, want, stream->ctx);
+            if (n == 0 || n > stream->left) {
+                result = CURL_READFUNC_ABORT;
+                break;
+            }
+            stream->left -= n;
+            stream->z.next_in = (Bytef*) stream->chunk;
+            stream->z.avail_in = (uInt) n;
+        }
+        int rc = deflate(&stream->z, stream->left == 0 ? Z_FINISH : Z_NO_FLUSH);
+        if (rc == Z_STREAM_END) {
+            stream->finished = 1;
+        } else if (rc != Z_OK && rc != Z_BUF_ERROR) {
+            result = CURL_READFUNC_ABORT;
+            break;
+        }
+    }
+    if (result == 0) result = size * nitems - stream->z.avail_out;
+    atomic_fetch_add_explicit(&stream->api->compress_ns, gzip_now_ns() - start, memory_order_relaxed);
+    return result;
+}
+
+static void gzip_stream_free(GzipStream* stream) {
+    if (stream == NULL) return;
+    deflateEnd(&stream->z);
+    free(stream);
+}
+#endif
+
+// sends the body gzip compressed if the API is configured to for bodies of this size; returns 1 if it did, 0 if the
+// body is to be sent as it is and -1 on errors. Bodies given as data not getting smaller are sent as they are; a
+// stream is compressed while it's sent, so it's too late to tell.
+static int request_payload_compressed(HttpRequest* request, const void* data, size_t size, curl_read_callback read,
+                                      void* ctx) {
+    request->body_raw_size = size;
+    request->body_size = size;
+#ifdef OBXC_WITH_ZLIB
+    HttpApi* api = request->api;
+    if (api == NULL || api->compress_min_size == 0 || size < api->compress_min_size) return 0;
+
+    struct curl_slist* headers = curl_slist_append(NULL, "Content-Encoding: gzip");
+    if (headers != NULL && read != NULL) {
+        struct curl_slist* chunked = curl_slist_append(headers, "Transfer-Encoding: chunked");
+        if (chunked == NULL) curl_slist_free_all(headers);
+        headers = chunked;
+    }
+    if (headers == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return -1;
+    }
+
+    if (read != NULL) {
+        GzipStream* stream = (GzipStream*) calloc(1, sizeof(GzipStream));
+        if (stream == NULL || gzip_init(&stream->z, api->compress_level) != Z_OK) {
+            free(stream);
+            curl_slist_free_all(headers);
+            obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+            return -1;
+        }
+        stream->api = api;
+        stream->read = read;
+        stream->ctx = ctx;
+        stream->left = size;
+        request->gzip_stream = stream;
+        request->headers = headers;
+        curl_easy_setopt(request->curl, CURLOPT_HTTPHEADER, headers);
+        curl_easy_setopt(request->curl, CURLOPT_POST, 1L);
+        curl_easy_setopt(request->curl, CURLOPT_READFUNCTION, gzip_stream_read);
+        curl_easy_setopt(request->curl, CURLOPT_READDATA, stream);
+        return 1;
+    }
+
+    uint64_t start = gzip_now_ns();
+    size_t compressed_size = 0;
+    void* compressed = gzip_compress(data, size, api->compress_level, &compressed_size);
+    atomic_fetch_add_explicit(&api->compress_ns, gzip_now_ns() - start, memory_order_relaxed);
+    if (compressed == NULL || compressed_size >= size) {
+        free(compressed);
+        curl_slist_free_all(headers);
+        if (compressed != NULL) return 0;
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return -1;
+    }
+
+    request->body = compressed;
+    request->headers = headers;
+    request->body_size = compressed_size;
+    curl_easy_setopt(request->curl, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(request->curl, CURLOPT_POSTFIELDS, compressed);
+    curl_easy_setopt(request->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) compressed_size);
+    return 1;
+#else
+    (void) data;
+    (void) read;
+    (void) ctx;
+    return 0;
+#endif
+}
+
 // result needs to be freed with curl_free after use
 char* url_encode(HttpApi* api, const char* data, size_t len) { return curl_easy_escape(api->url_encoder, data, len); }
 
@@ -83,6 +249,11 @@ void request_close(HttpRequest* request) {
     if (request != NULL) {
         if (request->result != NULL) memory_free(request->result);
         if (request->curl != NULL) curl_easy_cleanup(request->curl);
+        if (request->headers != NULL) curl_slist_free_all(request->headers);
+#ifdef OBXC_WITH_ZLIB
+        gzip_stream_free((GzipStream*) request->gzip_stream);
+#endif
+        free(request->body);
         free(request);
     }
 }
@@ -93,6 +264,28 @@ int request_cookies(HttpRequest* request, const char* data) {
 }
 
 HttpRequest* request_create(HttpApi* info, const char* method, const char* path) {
+    // set URL: concatenate url + path
+    size_t urlLen = strlen(info->url) + strlen(path);
+    char* total_url = (char*) malloc(urlLen + 1);
+    if (total_url == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    char* pUrl = total_url;
+    strcpy(pUrl, info->url);
+    pUrl += strlen(info->url);
+    strcpy(pUrl, path);
+    pUrl += strlen(path);
+    *pUrl = '\0';
+
+    HttpRequest* request = request_create_url(info, method, total_url);
+    free(total_url);
+    return request;
+}
+
+// like request_create, but with a complete URL instead of a path relative to the API's URL; cURL copies the URL
+HttpRequest* request_create_url(HttpApi* info, const char* method, const char* url) {
     HttpRequest* request = (HttpRequest*) malloc(sizeof(HttpRequest));
     if (request == NULL) {
         obx_set_last_error_code(OBX_ERROR_ALLOCATION);
@@ -101,6 +294,12 @@ HttpRequest* request_create(HttpApi* info, const char* method, const char* path)
 
     request->curl = NULL;
     request->result = NULL;
+    request->api = info;
+    request->body = NULL;
+    request->gzip_stream = NULL;
+    request->headers = NULL;
+    request->body_raw_size = 0;
+    request->body_size = 0;
 
     if (init_curl(&request->curl, &request->result) != OBX_SUCCESS) {
         request_close(request);
@@ -108,40 +307,36 @@ HttpRequest* request_create(HttpApi* info, const char* method, const char* path)
     }
 
     curl_easy_setopt(request->curl, CURLOPT_CUSTOMREQUEST, method);
-
-    {
-        // set URL: concatenate url + path
-        size_t urlLen = strlen(info->url) + strlen(path);
-        char* total_url = (char*) malloc(urlLen + 1);
-        if (total_url == NULL) {
-            obx_set_last_error_code(OBX_ERROR_ALLOCATION);
-            request_close(request);
-            return NULL;
-        }
-
-        char* pUrl = total_url;
-        strcpy(pUrl, info->url);
-        pUrl += strlen(info->url);
-        strcpy(pUrl, path);
-        pUrl += strlen(path);
-        *pUrl = '\0';
-
-        curl_easy_setopt(request->curl, CURLOPT_URL, total_url);
-        free(total_url);
-    }
-
+    curl_easy_setopt(request->curl, CURLOPT_URL, url);
     request_cookies(request, info->cookies);
 
+    // "" offers all encodings cURL can decode, responses arrive decompressed
+    if (info->accept_encoding) curl_easy_setopt(request->curl, CURLOPT_ACCEPT_ENCODING, "");
+
     obx_set_last_error_code(OBX_SUCCESS);
     return request;
 }
 
 int request_payload(HttpRequest* request, const void* data, size_t dataSize) {
+    int compressed = request_payload_compressed(request, data, dataSize, NULL, NULL);
+    if (compressed != 0) return compressed < 0 ? -1 : 0;
     curl_easy_setopt(request->curl, CURLOPT_POSTFIELDS, data);
     curl_easy_setopt(request->curl, CURLOPT_POSTFIELDSIZE, dataSize);
     return 0;
 }
 
+// the payload is pulled from the read callback while sending instead of passing cURL one contiguous block; if it's
+// compressed, the compressor pulls it while cURL pulls the compressed bytes
+int request_payload_stream(HttpRequest* request, curl_read_callback read, void* ctx, size_t dataSize) {
+    int compressed = request_payload_compressed(request, NULL, dataSize, read, ctx);
+    if (compressed != 0) return compressed < 0 ? -1 : 0;
+    curl_easy_setopt(request->curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(request->curl, CURLOPT_READFUNCTION, read);
+    curl_easy_setopt(request->curl, CURLOPT_READDATA, ctx);
+    curl_easy_setopt(request->curl, CURLOPT_POSTFIELDSIZE_LARGE, (curl_off_t) dataSize);
+    return 0;
+}
+
 long request_execute(HttpRequest* request) {
     // perform the request, res will get the return code 
     CURLcode res = curl_easy_perform(request->curl);
@@ -155,6 +350,23 @@ long request_execute(HttpRequest* request) {
         curl_easy_getinfo(request->curl, CURLINFO_RESPONSE_CODE, &rc);
     }
 
+    // sizes as on the wire; the result holds the decompressed response
+#ifdef OBXC_WITH_ZLIB
+    if (request->gzip_stream != NULL) request->body_size = ((GzipStream*) request->gzip_stream)->z.total_out;
+#endif
+    HttpApi* api = request->api;
+    if (api != NULL) {
+        curl_off_t received = 0;
+        curl_easy_getinfo(request->curl, CURLINFO_SIZE_DOWNLOAD_T, &received);
+        atomic_fetch_add_explicit(&api->requests, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&api->sent_raw_bytes, request->body_raw_size, memory_order_relaxed);
+        atomic_fetch_add_explicit(&api->sent_bytes, request->body_size, memory_order_relaxed);
+        atomic_fetch_add_explicit(&api->received_bytes, (uint64_t) received, memory_order_relaxed);
+        if (request->result != NULL) {
+            atomic_fetch_add_explicit(&api->received_raw_bytes, request->result->size, memory_order_relaxed);
+        }
+    }
+
     return rc;
 }
 
@@ -174,6 +386,18 @@ RestCall* rest_call_create(HttpApi* api, const char* method, const char* path) {
     return ret;
 }
 
+RestCall* rest_call_create_url(HttpApi* api, const char* method, const char* url) {
+    RestCall* ret = (RestCall*) malloc(sizeof(RestCall));
+    if (ret == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    ret->code = 0;
+    ret->request = request_create_url(api, method, url);
+    if (ret->request == NULL) return NULL;
+    return ret;
+}
+
 long rest_call_execute(RestCall* rest_call) {
     rest_call->code = request_execute(rest_call->request);
     if (rest_call->request->result == NULL) return -1;
@@ -212,6 +436,15 @@ HttpApi* rest_create(const char* url) {
         return NULL;
     }
     api->cookies = NULL;
+    api->accept_encoding = 0;
+    api->compress_min_size = 0;
+    api->compress_level = 0;
+    atomic_init(&api->requests, 0);
+    atomic_init(&api->sent_raw_bytes, 0);
+    atomic_init(&api->sent_bytes, 0);
+    atomic_init(&api->received_bytes, 0);
+    atomic_init(&api->received_raw_bytes, 0);
+    atomic_init(&api->compress_ns, 0);
     api->url_encoder = curl_easy_init();
     if (api->url_encoder == NULL) {
         obx_set_last_error_code(OBX_ERROR_CURL_INIT_FAILED);
@@ -274,7 +507,10 @@ RestCall* rest_del(HttpApi* api, const char* path) {
 RestCall* rest_post(HttpApi* api, const char* path, const void* data, size_t size) {
     RestCall* call = rest_call_create(api, "POST", path);
     if (call == NULL) return NULL;
-    request_payload(call->request, data, size);
+    if (request_payload(call->request, data, size) != 0) {
+        rest_call_close(call);
+        return NULL;
+    }
     rest_call_execute(call);
     return call;
 }
@@ -282,7 +518,22 @@ RestCall* rest_post(HttpApi* api, const char* path, const void* data, size_t siz
 RestCall* rest_put(HttpApi* api, const char* path, const void* data, size_t size) {
     RestCall* call = rest_call_create(api, "PUT", path);
     if (call == NULL) return NULL;
-    request_payload(call->request, data, size);
+    if (request_payload(call->request, data, size) != 0) {
+        rest_call_close(call);
+        return NULL;
+    }
+    rest_call_execute(call);
+    return call;
+}
+
+// executes a request to a complete URL, e.g. one precomputed by a box; data may be NULL for requests without payload
+RestCall* rest_request_url(HttpApi* api, const char* method, const char* url, const void* data, size_t size) {
+    RestCall* call = rest_call_create_url(api, method, url);
+    if (call == NULL) return NULL;
+    if (data != NULL && request_payload(call->request, data, size) != 0) {
+        rest_call_close(call);
+        return NULL;
+    }
     rest_call_execute(call);
     return call;
 }
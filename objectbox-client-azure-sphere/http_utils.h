@@ -1,6 +1,7 @@
 #ifndef OBJECTBOX_HTTP_UTILS_H
 #define OBJECTBOX_HTTP_UTILS_H
 
+#include <stdatomic.h>
 #include <stdlib.h>
 
 #include <curl/curl.h>
@@ -14,9 +15,19 @@ typedef struct Memory {
     size_t size;
 } Memory;
 
+typedef struct HttpApi HttpApi;
+
 typedef struct HttpRequest {
     CURL* curl;
     Memory* result;
+    HttpApi* api;
+
+    // request body, if it was compressed, and its size before and after compression
+    void* body;
+    void* gzip_stream;  // state of a body compressed while it's sent, see request_payload_stream()
+    struct curl_slist* headers;
+    size_t body_raw_size;
+    size_t body_size;
 } HttpRequest;
 
 typedef struct RestCall {
@@ -24,11 +35,24 @@ typedef struct RestCall {
     HttpRequest* request;
 } RestCall;
 
-typedef struct HttpApi {
+struct HttpApi {
     char* url;
     char* cookies;
     CURL* url_encoder;
-} HttpApi;
+
+    // compression settings, see OBXC_store_options
+    int accept_encoding;
+    size_t compress_min_size;
+    int compress_level;
+
+    // totals of all requests, which may be executed by several threads (e.g. a sampler's)
+    atomic_uint_least64_t requests;
+    atomic_uint_least64_t sent_raw_bytes;
+    atomic_uint_least64_t sent_bytes;
+    atomic_uint_least64_t received_bytes;
+    atomic_uint_least64_t received_raw_bytes;
+    atomic_uint_least64_t compress_ns;
+};
 
 // Utilities
 obx_err init_curl(CURL** handle, Memory** mem);
@@ -41,13 +65,16 @@ void memory_move(Memory* src, void** dest, size_t* destsize);
 
 // HttpRequest
 HttpRequest* request_create(HttpApi* info, const char* method, const char* path);
+HttpRequest* request_create_url(HttpApi* info, const char* method, const char* url);
 int request_cookies(HttpRequest* request, const char* data);
 int request_payload(HttpRequest* request, const void* data, size_t dataSize);
+int request_payload_stream(HttpRequest* request, curl_read_callback read, void* ctx, size_t dataSize);
 long request_execute(HttpRequest* request);
 void request_close(HttpRequest* request);
 
 // RestCall
 RestCall* rest_call_create(HttpApi* api, const char* method, const char* path);
+RestCall* rest_call_create_url(HttpApi* api, const char* method, const char* url);
 long rest_call_execute(RestCall* rest_call);
 Memory* rest_call_response(const RestCall* rest_call);
 void rest_call_close(RestCall* rest_call);
@@ -59,6 +86,7 @@ RestCall* rest_get(HttpApi* api, const char* path);
 RestCall* rest_del(HttpApi* api, const char* path);
 RestCall* rest_post(HttpApi* api, const char* path, const void* data, size_t size);
 RestCall* rest_put(HttpApi* api, const char* path, const void* data, size_t size);
+RestCall* rest_request_url(HttpApi* api, const char* method, const char* url, const void* data, size_t size);
 void rest_close(HttpApi* api);
 
 #endif  // OBJECTBOX_HTTP_UTILS_H
@@ -0,0 +1,219 @@
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <curl/curl.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "http_utils.h"
+#include "objectbox.h"
+#include "obtypes.h"
+#include "utilities.h"
+
+// change entry header: 32 bit size, 32 bit type, 64 bit object id; the list is terminated by a header with type 0
+#define CHANGE_HEADER_SIZE 16
+#define CHANGE_END_SIZE 8
+
+// pause between two attempts if the change feed request failed, checked in steps to react to close() quickly
+#define OBSERVER_RETRY_MS 1000
+#define OBSERVER_RETRY_STEP_MS 100
+
+struct OBX_observer {
+    OBX_store* store;
+    int entity_id;
+    obx_observer_callback* callback;
+    void* user_data;
+
+    pthread_t thread;
+    atomic_int stop;
+};
+
+// cURL progress callback; a non-zero return value aborts a pending long-poll when the observer is being closed
+static int changes_abort_check(void* ctx, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow) {
+    (void) dltotal;
+    (void) dlnow;
+    (void) ultotal;
+    (void) ulnow;
+    return atomic_load((atomic_int*) ctx) != 0;
+}
+
+// response: 64 bit sequence number followed by change entries (see CHANGE_HEADER_SIZE) and their object data
+static obx_err parse_changes(Memory* resp_mem, OBX_change_array* dest) {
+    const char* buf = resp_mem->buf;
+    size_t size = resp_mem->size, pos = 8, count = 0;
+    if (size < 8 + CHANGE_END_SIZE) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+
+    // find number of entries first so that all of them can be allocated at once
+    while (pos + CHANGE_END_SIZE <= size && read_uint32_le(buf + pos + 4) != 0) {
+        if (pos + CHANGE_HEADER_SIZE > size || size - pos - CHANGE_HEADER_SIZE < read_uint32_le(buf + pos)) {
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+        }
+        pos += CHANGE_HEADER_SIZE + read_uint32_le(buf + pos);
+        ++count;
+    }
+    if (pos + CHANGE_END_SIZE > size) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+
+    dest->changes = count == 0 ? NULL : (OBX_change*) malloc(count * sizeof(OBX_change));
+    if (count != 0 && dest->changes == NULL) return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    dest->count = count;
+    dest->seq = read_uint64_le(buf);
+
+    // re-iterate to point the entries to their data inside the response
+    pos = 8;
+    for (size_t i = 0; i < count; ++i) {
+        OBX_change* change = dest->changes + i;
+        change->data.size = read_uint32_le(buf + pos);
+        change->type = read_uint32_le(buf + pos + 4);
+        change->id = read_uint64_le(buf + pos + 8);
+        change->data.data = change->data.size == 0 ? NULL : (void*) (buf + pos + CHANGE_HEADER_SIZE);
+        pos += CHANGE_HEADER_SIZE + change->data.size;
+    }
+
+    memory_move(resp_mem, &dest->baseptr, NULL);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+// if since is NULL, only the current sequence number is requested (the response contains no changes)
+static obx_err fetch_changes(OBX_store* store, int entityId, const uint64_t* since, uint32_t wait_ms,
+                             OBX_change_array* dest, atomic_int* abort_flag) {
+    char path[128];
+    if (since == NULL) {
+        snprintf(path, 128, "/data/%d/changes?fb", entityId);
+    } else {
+        snprintf(path, 128, "/data/%d/changes?fb&since=%" PRIu64 "&wait=%" PRIu32, entityId, *since, wait_ms);
+    }
+
+    RestCall* call = rest_call_create(store->http_api, "GET", path);
+    if (call == NULL) return OBX_LAST_ERROR_CODE;
+
+    // the default request timeout would cut off long-polls, so extend it by the time the server may wait
+    curl_easy_setopt(call->request->curl, CURLOPT_TIMEOUT_MS, 5000L + (long) wait_ms);
+    if (abort_flag != NULL) {
+        curl_easy_setopt(call->request->curl, CURLOPT_XFERINFOFUNCTION, changes_abort_check);
+        curl_easy_setopt(call->request->curl, CURLOPT_XFERINFODATA, abort_flag);
+        curl_easy_setopt(call->request->curl, CURLOPT_NOPROGRESS, 0L);
+    }
+
+    rest_call_execute(call);
+    Memory* resp_mem = rest_call_response(call);
+    if (resp_mem == NULL || parse_error_response(resp_mem) || call->code != 200) {
+        rest_call_close(call);
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+    }
+
+    obx_err err = parse_changes(resp_mem, dest);
+    rest_call_close(call);
+    return err;
+}
+
+obx_err obx_data_changes(OBX_store* store, int entityId, uint64_t since, uint32_t wait_ms, OBX_change_array* dest) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    return fetch_changes(store, entityId, &since, wait_ms, dest, NULL);
+}
+
+void obx_change_array_free(OBX_change_array* changes) {
+    if (changes) {
+        if (changes->baseptr) free(changes->baseptr);
+        if (changes->changes) free(changes->changes);
+        changes->changes = NULL;
+        changes->baseptr = NULL;
+        changes->count = 0;
+    }
+}
+
+obx_err obx_sync_since(OBX_store* store, int entityId, uint64_t* seq_inout, obx_change_visitor* visitor,
+                       void* user_data) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || entityId < 0 || seq_inout == NULL || visitor == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // the server may split the changes into several batches; an empty batch means the client is up to date
+    while (1) {
+        OBX_change_array changes;
+        obx_err err = fetch_changes(store, entityId, seq_inout, 0, &changes, NULL);
+        if (err != OBX_SUCCESS) return err;
+
+        size_t visited = 0;
+        while (visited < changes.count && visitor(user_data, changes.changes + visited)) ++visited;
+        int stopped = visited != changes.count, done = changes.count == 0 || changes.seq == *seq_inout;
+        if (!stopped) *seq_inout = changes.seq;
+        obx_change_array_free(&changes);
+        if (done || stopped) break;
+    }
+
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+static void* observer_run(void* arg) {
+    OBX_observer* observer = (OBX_observer*) arg;
+    uint64_t seq = 0;
+    int has_seq = 0;
+
+    while (!atomic_load(&observer->stop)) {
+        OBX_change_array changes;
+        if (fetch_changes(observer->store, observer->entity_id, has_seq ? &seq : NULL,
+                          has_seq ? OBXC_OBSERVER_WAIT_MS : 0, &changes, &observer->stop) != OBX_SUCCESS) {
+            // server unreachable or request aborted: retry later without losing the current sequence number
+            const struct timespec step = {0, OBSERVER_RETRY_STEP_MS * 1000000L};
+            for (int i = 0; i < OBSERVER_RETRY_MS / OBSERVER_RETRY_STEP_MS && !atomic_load(&observer->stop); ++i) {
+                nanosleep(&step, NULL);
+            }
+            continue;
+        }
+
+        if (has_seq && changes.count > 0 && !atomic_load(&observer->stop)) {
+            observer->callback(observer->user_data, observer->entity_id, &changes);
+        }
+        seq = changes.seq;
+        has_seq = 1;
+        obx_change_array_free(&changes);
+    }
+
+    return NULL;
+}
+
+OBX_observer* obx_observe(OBX_store* store, int entityId, obx_observer_callback* callback, void* user_data) {
+    if (store == NULL || store->http_api == NULL || entityId < 0 || callback == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_observer* observer = (OBX_observer*) malloc(sizeof(OBX_observer));
+    if (observer == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    observer->store = store;
+    observer->entity_id = entityId;
+    observer->callback = callback;
+    observer->user_data = user_data;
+    atomic_init(&observer->stop, 0);
+
+    if (pthread_create(&observer->thread, NULL, observer_run, observer) != 0) {
+        free(observer);
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return observer;
+}
+
+obx_err obx_observer_close(OBX_observer* observer) {
+    if (observer != NULL) {
+        atomic_store(&observer->stop, 1);
+        pthread_join(observer->thread, NULL);
+        free(observer);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
@@ -1,10 +1,25 @@
 #ifndef OBJECTBOX_OBTYPES_H
 #define OBJECTBOX_OBTYPES_H
 
+#include "builder_pool.h"
+#include "flatcc/flatcc_builder.h"
 #include "http_utils.h"
 
 struct OBX_store {
     HttpApi* http_api;
+    BuilderPool builder_pool;
+};
+
+struct OBX_box {
+    OBX_store* store;
+    int entity_id;
+
+    // "<base_url>/data/<entityId>/", followed by the ID and query of the current request
+    char* url;
+    size_t prefix_len;
+
+    // FlatBuffers builder taken from the store's pool on first use and returned when the box is closed
+    flatcc_builder_t* builder;
 };
 
 #endif  // OBJECTBOX_OBTYPES_H
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+#include "utilities.h"
+
+// copies a scalar of the given size (1, 2, 4 or 8 bytes) and converts it to host byte order
+static inline void copy_scalar(uint8_t* dest, const uint8_t* src, size_t size) {
+    switch (size) {
+        case 1:
+            *dest = *src;
+            break;
+        case 2: {
+            uint16_t value = read_uint16_le(src);
+            memcpy(dest, &value, 2);
+            break;
+        }
+        case 4: {
+            uint32_t value = read_uint32_le(src);
+            memcpy(dest, &value, 4);
+            break;
+        }
+        default: {
+            uint64_t value = read_uint64_le(src);
+            memcpy(dest, &value, 8);
+            break;
+        }
+    }
+}
+
+// extracts the columns' values of the object at index; returns 0 if the object is invalid (only checked if !trusted,
+// except for the fields, which must lie within the table for any verifier)
+static int project_object(const OBX_bytes* object, size_t index, const OBX_column* columns, size_t column_count,
+                          int trusted) {
+    const uint8_t* buf = (const uint8_t*) object->data;
+    FlatbufferRoot root;
+    if (!flatbuffer_root(buf, object->size, trusted, &root)) return 0;
+
+    for (size_t c = 0; c < column_count; ++c) {
+        const OBX_column* column = columns + c;
+        uint8_t* dest = (uint8_t*) column->values + index * column->size;
+        size_t entry = 4 + 2 * (size_t) column->field_id;
+        size_t offset = entry + 2 <= root.vt_size ? read_uint16_le(buf + root.vtable + entry) : 0;
+        if (offset == 0) {
+            // absent fields have their default value, which is 0 for the schemas used with this client
+            memset(dest, 0, column->size);
+        } else {
+            if (offset + column->size > root.table_size) return 0;
+            copy_scalar(dest, buf + root.table + offset, column->size);
+        }
+    }
+    return 1;
+}
+
+obx_err obx_bytes_array_project(const OBX_bytes_array* array, const OBX_column* columns, size_t column_count) {
+    // check if parameters are valid
+    if (array == NULL || (columns == NULL && column_count > 0)) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    for (size_t c = 0; c < column_count; ++c) {
+        uint8_t size = columns[c].size;
+        if (columns[c].values == NULL || (size != 1 && size != 2 && size != 4 && size != 8)) {
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        }
+    }
+
+    // objects of a verified array have their tables in bounds, everything else is checked while reading
+    int trusted = array->verified_by != NULL;
+    for (size_t i = 0; i < array->count; ++i) {
+        if (!project_object(array->bytes + i, i, columns, column_count, trusted)) {
+            snprintf(OBX_LAST_RESPONSE_ERROR_MESSAGE, 256, "object %zu is out of bounds", i);
+            OBX_LAST_ERROR_SECONDARY = 0;
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+        }
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
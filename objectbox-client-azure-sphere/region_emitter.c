@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include <string.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+#include "region_emitter.h"
+
+// the buffer is only moved by multiples of this, so the alignment flatcc computed stays valid
+#define REGION_ALIGN 16
+
+// part of the region initially reserved for data emitted to the back, i.e. vtables and end padding
+#define REGION_BACK_SHARE 8
+
+static size_t align_down(size_t n) { return n & ~(size_t)(REGION_ALIGN - 1); }
+
+static size_t align_up(size_t n) { return align_down(n + REGION_ALIGN - 1); }
+
+// amount to move the buffer so that the side that ran out gets at least `need` more bytes; 0 if impossible
+static size_t region_shift(size_t need, size_t other_room) {
+    if (align_down(other_room) < need) return 0;
+    // hand over half of the remaining space as well, so repeated overflows don't move the buffer every time
+    size_t shift = align_down(need + (other_room - need) / 2);
+    return shift < align_up(need) ? align_up(need) : shift;
+}
+
+static int region_emit(void* emit_context, const flatcc_iovec_t* iov, int iov_count, flatbuffers_soffset_t offset,
+                       size_t len) {
+    OBX_region_emitter* E = (OBX_region_emitter*) emit_context;
+    size_t used = (size_t) (E->back - E->front);
+    size_t front_room = (size_t) (E->front - E->start), back_room = (size_t) (E->end - E->back);
+    uint8_t* dest;
+
+    if (offset < 0) {
+        if (front_room < len) {
+            size_t shift = region_shift(len - front_room, back_room);
+            if (shift == 0) {
+                E->full = 1;
+                return -1;
+            }
+            memmove(E->front + shift, E->front, used);
+            E->front += shift;
+            E->back += shift;
+        }
+        E->front -= len;
+        dest = E->front;
+    } else {
+        if (back_room < len) {
+            size_t shift = region_shift(len - back_room, front_room);
+            if (shift == 0) {
+                E->full = 1;
+                return -1;
+            }
+            memmove(E->front - shift, E->front, used);
+            E->front -= shift;
+            E->back -= shift;
+        }
+        dest = E->back;
+        E->back += len;
+    }
+
+    for (int i = 0; i < iov_count; ++i) {
+        memcpy(dest, iov[i].iov_base, iov[i].iov_len);
+        dest += iov[i].iov_len;
+    }
+    return 0;
+}
+
+static void region_rewind(OBX_region_emitter* E) {
+    // front and back start at an aligned split point, leaving most of the region to the front
+    uintptr_t split = (uintptr_t) (E->end - (E->end - E->start) / REGION_BACK_SHARE);
+    E->front = E->back = (uint8_t*) (split & ~(uintptr_t)(REGION_ALIGN - 1));
+    if (E->front < E->start) E->front = E->back = E->start;
+    E->full = 0;
+}
+
+OBX_region_emitter* region_emitter_of(flatcc_builder_t* builder) {
+    return builder != NULL && builder->emit == region_emit ? (OBX_region_emitter*) builder->emit_context : NULL;
+}
+
+obx_err obx_region_builder_init(flatcc_builder_t* builder, OBX_region_emitter* emitter, void* region, size_t size) {
+    // check if parameters are valid
+    if (builder == NULL || emitter == NULL || region == NULL || size < REGION_ALIGN) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    emitter->start = (uint8_t*) region;
+    emitter->end = emitter->start + size;
+    region_rewind(emitter);
+    if (flatcc_builder_custom_init(builder, region_emit, emitter, 0, 0) != 0) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_region_builder_reset(flatcc_builder_t* builder) {
+    OBX_region_emitter* emitter = region_emitter_of(builder);
+    if (emitter == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+
+    // flatcc only resets its own default emitter
+    region_rewind(emitter);
+    if (flatcc_builder_reset(builder) != 0) return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+void* obx_region_builder_buffer(flatcc_builder_t* builder, size_t* size) {
+    OBX_region_emitter* emitter = region_emitter_of(builder);
+    if (emitter == NULL || size == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+    if (emitter->full) {
+        obx_set_last_error_code(OBX_ERROR_OUT_OF_SPACE);
+        return NULL;
+    }
+    if (flatcc_builder_get_level(builder) != 0 || emitter->back == emitter->front) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
+    *size = (size_t) (emitter->back - emitter->front);
+    obx_set_last_error_code(OBX_SUCCESS);
+    return emitter->front;
+}
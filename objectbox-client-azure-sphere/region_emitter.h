@@ -0,0 +1,10 @@
+#ifndef OBJECTBOX_REGION_EMITTER_H
+#define OBJECTBOX_REGION_EMITTER_H
+
+#include "flatcc/flatcc_builder.h"
+#include "objectbox.h"
+
+// region emitter state if the builder was set up using obxc_region_builder_init(), NULL otherwise
+OBXC_region_emitter* region_emitter_of(flatcc_builder_t* builder);
+
+#endif  // OBJECTBOX_REGION_EMITTER_H
@@ -0,0 +1,404 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// pause before another upload attempt after a failed one if there's no flush interval to go by
+#define SAMPLER_RETRY_MS 1000
+
+struct OBX_sampler {
+    OBX_sampler_options options;
+    OBX_box* box;
+    OBX_batch* batch;  // only for OBXC_UPLOAD_BATCH
+
+    // ring of options.capacity samples and the time each one was pushed; the sequence numbers only ever grow,
+    // the slot of a sample is its sequence number modulo the capacity
+    uint8_t* samples;
+    uint64_t* times_ns;
+    uint32_t* trace_ids;
+    uint64_t write_seq;
+    uint64_t read_seq;
+
+    // samples taken out of the ring for the current upload, starting at sequence number staged_seq
+    uint8_t* staged;
+    uint32_t* staged_trace_ids;
+    uint64_t staged_seq;
+    size_t staged_count;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;     // signals the upload thread
+    pthread_cond_t changed;  // signals waiting producers and flush() callers
+    pthread_t thread;
+
+    int flush_requested;
+    int stop;
+    uint64_t retry_at_ns;
+    obx_err last_upload_error;
+    OBX_sampler_stats stats;
+};
+
+static uint64_t sampler_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+// waits on the condition (using CLOCK_MONOTONIC, see sampler_cond_init) until the given time, 0 to wait indefinitely
+static void sampler_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, uint64_t until_ns) {
+    if (until_ns == 0) {
+        pthread_cond_wait(cond, mutex);
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = (time_t) (until_ns / 1000000000u);
+    ts.tv_nsec = (long) (until_ns % 1000000000u);
+    pthread_cond_timedwait(cond, mutex, &ts);
+}
+
+static int sampler_cond_init(pthread_cond_t* cond) {
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) return -1;
+    int ret = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    if (ret == 0) ret = pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+    return ret;
+}
+
+// decides whether buffered samples are due for upload; otherwise returns the time to check again (0: no deadline)
+static int sampler_due(const OBX_sampler* sampler, uint64_t now, uint64_t* next_ns) {
+    uint64_t pending = sampler->write_seq - sampler->read_seq;
+    *next_ns = 0;
+    if (pending == 0) return 0;
+    if (now < sampler->retry_at_ns) {
+        *next_ns = sampler->retry_at_ns;
+        return 0;
+    }
+    if (pending >= sampler->options.flush_count || sampler->flush_requested || sampler->stop) return 1;
+    if (sampler->options.flush_interval_ms == 0) return 0;
+
+    uint64_t oldest = sampler->times_ns[sampler->read_seq % sampler->options.capacity];
+    uint64_t deadline = oldest + (uint64_t) sampler->options.flush_interval_ms * 1000000u;
+    if (now >= deadline) return 1;
+    *next_ns = deadline;
+    return 0;
+}
+
+// copies up to flush_count samples out of the ring; their slots are free for new samples from now on
+static void sampler_take(OBX_sampler* sampler) {
+    size_t capacity = sampler->options.capacity, size = sampler->options.sample_size;
+    uint64_t pending = sampler->write_seq - sampler->read_seq;
+    sampler->staged_seq = sampler->read_seq;
+    sampler->staged_count = pending < sampler->options.flush_count ? (size_t) pending : sampler->options.flush_count;
+    for (size_t i = 0; i < sampler->staged_count; ++i) {
+        size_t slot = (size_t) ((sampler->staged_seq + i) % capacity);
+        memcpy(sampler->staged + i * size, sampler->samples + slot * size, size);
+        sampler->staged_trace_ids[i] = sampler->trace_ids[slot];
+    }
+    sampler->read_seq += sampler->staged_count;
+}
+
+// after a failed upload, puts the staged samples back unless new samples have overwritten their slots meanwhile
+static void sampler_restore(OBX_sampler* sampler) {
+    uint64_t capacity = sampler->options.capacity;
+    uint64_t first_kept = sampler->write_seq > capacity ? sampler->write_seq - capacity : 0;
+    uint64_t staged_end = sampler->staged_seq + sampler->staged_count;
+    if (first_kept < sampler->staged_seq) first_kept = sampler->staged_seq;
+
+    // samples behind the staged ones which were dropped by the producer are counted as dropped already
+    if (first_kept < staged_end) sampler->stats.lost += first_kept - sampler->staged_seq;
+    else sampler->stats.lost += sampler->staged_count;
+    if (first_kept < sampler->read_seq) sampler->read_seq = first_kept;
+}
+
+static void sampler_trace(OBX_sampler* sampler, OBX_trace_stage stage) {
+    for (size_t i = 0; i < sampler->staged_count; ++i) obx_trace(sampler->staged_trace_ids[i], stage);
+}
+
+// builds the staged samples into the batch and inserts them with a single request
+static obx_err sampler_upload_batch(OBX_sampler* sampler, size_t* uploaded, size_t* requests) {
+    for (size_t i = 0; i < sampler->staged_count; ++i) {
+        obx_err err = sampler->options.add(sampler->batch, sampler->staged + i * sampler->options.sample_size);
+        if (err != OBX_SUCCESS) {
+            obx_batch_clear(sampler->batch);
+            return err;
+        }
+        obx_trace(sampler->staged_trace_ids[i], OBXC_TRACE_ENCODE);
+    }
+    sampler_trace(sampler, OBXC_TRACE_SEND);
+    obx_err err = obx_box_put_batch(sampler->box, sampler->batch, NULL);
+    *requests = 1;
+    sampler_trace(sampler, OBXC_TRACE_RESPONSE);
+    if (err == OBX_SUCCESS) {
+        sampler_trace(sampler, OBXC_TRACE_COMMIT);
+        *uploaded = sampler->staged_count;
+    }
+    return err;
+}
+
+// inserts the staged samples one by one, using the box's builder; stops at the first failure
+static obx_err sampler_upload_objects(OBX_sampler* sampler, size_t* uploaded, size_t* requests) {
+    for (size_t i = 0; i < sampler->staged_count; ++i) {
+        uint32_t trace_id = sampler->staged_trace_ids[i];
+        flatcc_builder_t* builder = obx_box_builder(sampler->box);
+        if (builder == NULL) return OBX_LAST_ERROR_CODE;
+        if (sampler->options.build(builder, sampler->staged + i * sampler->options.sample_size) != 0) {
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        }
+        obx_trace(trace_id, OBXC_TRACE_ENCODE);
+
+        int id;
+        obx_trace(trace_id, OBXC_TRACE_SEND);
+        obx_err err = obx_box_put_builder(sampler->box, builder, &id);
+        (*requests)++;
+        obx_trace(trace_id, OBXC_TRACE_RESPONSE);
+        if (err != OBX_SUCCESS) return err;
+        obx_trace(trace_id, OBXC_TRACE_COMMIT);
+        (*uploaded)++;
+    }
+    return OBX_SUCCESS;
+}
+
+// uploads the staged samples; uploaded receives how many of them are stored, requests the number of requests sent.
+// Called without the lock held.
+static obx_err sampler_upload(OBX_sampler* sampler, size_t* uploaded, size_t* requests) {
+    *uploaded = 0;
+    *requests = 0;
+    if (sampler->options.upload == OBXC_UPLOAD_BATCH) return sampler_upload_batch(sampler, uploaded, requests);
+    return sampler_upload_objects(sampler, uploaded, requests);
+}
+
+static void* sampler_run(void* arg) {
+    OBX_sampler* sampler = (OBX_sampler*) arg;
+    pthread_mutex_lock(&sampler->mutex);
+    while (1) {
+        uint64_t next_ns;
+        if (!sampler_due(sampler, sampler_now_ns(), &next_ns)) {
+            // when stopping, everything has been uploaded or given up on at this point
+            if (sampler->stop) break;
+            if (sampler->flush_requested && (sampler->write_seq == sampler->read_seq || next_ns != 0)) {
+                sampler->flush_requested = 0;
+                pthread_cond_broadcast(&sampler->changed);
+            }
+            sampler_wait(&sampler->wake, &sampler->mutex, next_ns);
+            continue;
+        }
+
+        sampler_take(sampler);
+        pthread_cond_broadcast(&sampler->changed);  // producers blocked by a full ring may continue
+        pthread_mutex_unlock(&sampler->mutex);
+        size_t uploaded, requests;
+        obx_err err = sampler_upload(sampler, &uploaded, &requests);
+        pthread_mutex_lock(&sampler->mutex);
+
+        // samples stored before a failed request aren't sent again: only the ones after them are restored
+        sampler->last_upload_error = err;
+        sampler->stats.uploaded += uploaded;
+        sampler->staged_seq += uploaded;
+        sampler->staged_count -= uploaded;
+        if (err == OBX_SUCCESS) {
+            sampler->stats.requests += requests;
+        } else {
+            if (requests > 0) sampler->stats.requests += requests - 1;
+            sampler->stats.failed_requests++;
+            if (sampler->stop) {
+                sampler->stats.lost += sampler->staged_count + (sampler->write_seq - sampler->read_seq);
+                sampler->read_seq = sampler->write_seq;
+            } else {
+                sampler_restore(sampler);
+                uint32_t retry_ms = sampler->options.flush_interval_ms ? sampler->options.flush_interval_ms
+                                                                       : SAMPLER_RETRY_MS;
+                sampler->retry_at_ns = sampler_now_ns() + (uint64_t) retry_ms * 1000000u;
+            }
+        }
+        sampler->staged_count = 0;
+        pthread_cond_broadcast(&sampler->changed);
+    }
+    pthread_mutex_unlock(&sampler->mutex);
+    return NULL;
+}
+
+static void sampler_free(OBX_sampler* sampler) {
+    if (sampler->batch != NULL) obx_batch_close(sampler->batch);
+    if (sampler->box != NULL) obx_box_close(sampler->box);
+    if (sampler->samples != NULL) free(sampler->samples);
+    if (sampler->times_ns != NULL) free(sampler->times_ns);
+    if (sampler->trace_ids != NULL) free(sampler->trace_ids);
+    if (sampler->staged != NULL) free(sampler->staged);
+    if (sampler->staged_trace_ids != NULL) free(sampler->staged_trace_ids);
+    free(sampler);
+}
+
+OBX_sampler* obx_sampler(OBX_store* store, const OBX_sampler_options* options) {
+    // check if parameters are valid
+    if (store == NULL || options == NULL || options->entity_id < 0 || options->sample_size == 0 ||
+        options->upload > OBXC_UPLOAD_BATCH || (options->upload == OBXC_UPLOAD_OBJECTS && options->build == NULL) ||
+        (options->upload == OBXC_UPLOAD_BATCH && options->add == NULL) || options->capacity == 0 ||
+        options->flush_count == 0 || options->flush_count > options->capacity ||
+        options->overflow > OBXC_OVERFLOW_BLOCK) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_sampler* sampler = (OBX_sampler*) calloc(1, sizeof(OBX_sampler));
+    if (sampler == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    sampler->options = *options;
+
+    // all memory is allocated up front, pushing a sample never allocates
+    sampler->samples = (uint8_t*) malloc(options->capacity * options->sample_size);
+    sampler->times_ns = (uint64_t*) malloc(options->capacity * sizeof(uint64_t));
+    sampler->trace_ids = (uint32_t*) malloc(options->capacity * sizeof(uint32_t));
+    sampler->staged = (uint8_t*) malloc(options->flush_count * options->sample_size);
+    sampler->staged_trace_ids = (uint32_t*) malloc(options->flush_count * sizeof(uint32_t));
+    if (sampler->samples == NULL || sampler->times_ns == NULL || sampler->trace_ids == NULL ||
+        sampler->staged == NULL || sampler->staged_trace_ids == NULL) {
+        sampler_free(sampler);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    sampler->box = obx_box(store, options->entity_id);
+    if (sampler->box != NULL && options->upload == OBXC_UPLOAD_BATCH) sampler->batch = obx_batch(store);
+    if (sampler->box == NULL || (options->upload == OBXC_UPLOAD_BATCH && sampler->batch == NULL)) {
+        obx_err err = OBX_LAST_ERROR_CODE;
+        sampler_free(sampler);
+        obx_set_last_error_code(err);
+        return NULL;
+    }
+
+    // the synchronization primitives are initialized one after another, a failure cleans up the ones before
+    int ret = pthread_mutex_init(&sampler->mutex, NULL);
+    if (ret == 0) {
+        ret = sampler_cond_init(&sampler->wake);
+        if (ret == 0) {
+            ret = sampler_cond_init(&sampler->changed);
+            if (ret == 0) {
+                ret = pthread_create(&sampler->thread, NULL, sampler_run, sampler);
+                if (ret != 0) pthread_cond_destroy(&sampler->changed);
+            }
+            if (ret != 0) pthread_cond_destroy(&sampler->wake);
+        }
+        if (ret != 0) pthread_mutex_destroy(&sampler->mutex);
+    }
+    if (ret != 0) {
+        sampler_free(sampler);
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return sampler;
+}
+
+obx_err obx_sampler_push(OBX_sampler* sampler, const void* sample) {
+    return obx_sampler_push_traced(sampler, sample, obx_trace_id());
+}
+
+obx_err obx_sampler_push_traced(OBX_sampler* sampler, const void* sample, uint32_t trace_id) {
+    // check if parameters are valid
+    if (sampler == NULL || sample == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t capacity = sampler->options.capacity;
+    pthread_mutex_lock(&sampler->mutex);
+    sampler->stats.pushed++;
+
+    // checked before the deadband filter: it takes each sample it passes as its new reference, a dropped one must not
+    // become it, else the next samples would be compared against a value that was never uploaded
+    if (sampler->write_seq - sampler->read_seq == capacity && sampler->options.overflow == OBXC_OVERFLOW_DROP_NEWEST) {
+        sampler->stats.dropped++;
+        pthread_mutex_unlock(&sampler->mutex);
+        return obx_set_last_error_code(OBX_ERROR_OUT_OF_SPACE);
+    }
+    if (sampler->options.deadband != NULL && !obx_deadband_pass(sampler->options.deadband, sample)) {
+        sampler->stats.suppressed++;
+        pthread_mutex_unlock(&sampler->mutex);
+        return obx_set_last_error_code(OBX_SUCCESS);
+    }
+    if (sampler->write_seq - sampler->read_seq == capacity) {
+        if (sampler->options.overflow == OBXC_OVERFLOW_DROP_OLDEST) {
+            sampler->read_seq++;
+            sampler->stats.dropped++;
+        } else {
+            while (sampler->write_seq - sampler->read_seq == capacity) {
+                sampler_wait(&sampler->changed, &sampler->mutex, 0);
+            }
+        }
+    }
+
+    size_t slot = (size_t) (sampler->write_seq % capacity);
+    memcpy(sampler->samples + slot * sampler->options.sample_size, sample, sampler->options.sample_size);
+    sampler->times_ns[slot] = sampler_now_ns();
+    sampler->trace_ids[slot] = trace_id;
+    sampler->write_seq++;
+    obx_trace(trace_id, OBXC_TRACE_ENQUEUE);
+
+    // the upload thread only needs to wake up for the sample completing a batch; time based flushes are timed
+    if (sampler->write_seq - sampler->read_seq == sampler->options.flush_count ||
+        sampler->write_seq - sampler->read_seq == 1) {
+        pthread_cond_signal(&sampler->wake);
+    }
+    pthread_mutex_unlock(&sampler->mutex);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_sampler_flush(OBX_sampler* sampler) {
+    // check if parameters are valid
+    if (sampler == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // waits until everything pushed so far is uploaded or an upload failed
+    pthread_mutex_lock(&sampler->mutex);
+    uint64_t failed = sampler->stats.failed_requests;
+    sampler->flush_requested = 1;
+    sampler->retry_at_ns = 0;
+    pthread_cond_signal(&sampler->wake);
+    while ((sampler->write_seq != sampler->read_seq || sampler->staged_count != 0) &&
+           sampler->stats.failed_requests == failed) {
+        sampler_wait(&sampler->changed, &sampler->mutex, 0);
+    }
+    obx_err err = sampler->stats.failed_requests == failed ? OBX_SUCCESS : sampler->last_upload_error;
+    pthread_mutex_unlock(&sampler->mutex);
+    return obx_set_last_error_code(err);
+}
+
+obx_err obx_sampler_stats(OBX_sampler* sampler, OBX_sampler_stats* stats) {
+    // check if parameters are valid
+    if (sampler == NULL || stats == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    pthread_mutex_lock(&sampler->mutex);
+    *stats = sampler->stats;
+    stats->buffered = (size_t) (sampler->write_seq - sampler->read_seq) + sampler->staged_count;
+    pthread_mutex_unlock(&sampler->mutex);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_sampler_close(OBX_sampler* sampler) {
+    if (sampler != NULL) {
+        // the upload thread sends what's left before it ends (one attempt)
+        pthread_mutex_lock(&sampler->mutex);
+        sampler->stop = 1;
+        sampler->retry_at_ns = 0;
+        pthread_cond_signal(&sampler->wake);
+        pthread_mutex_unlock(&sampler->mutex);
+        pthread_join(sampler->thread, NULL);
+
+        pthread_cond_destroy(&sampler->wake);
+        pthread_cond_destroy(&sampler->changed);
+        pthread_mutex_destroy(&sampler->mutex);
+        sampler_free(sampler);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
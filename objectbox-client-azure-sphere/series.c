@@ -0,0 +1,297 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+#include "utilities.h"
+
+#define SERIES_MAGIC "OBXS"
+#define SERIES_VERSION 1
+#define SERIES_HEADER_SIZE 12
+
+// worst case per value: 4 control bits + 64 for integers, 2 + 5 + 6 control bits + 64 for floats
+#define SERIES_MAX_VALUE_BITS 77
+
+// Bits are written most significant first; the buffer is zeroed up front so writing only needs to OR.
+typedef struct bit_writer {
+    uint8_t* data;
+    size_t bits;
+} bit_writer;
+
+typedef struct bit_reader {
+    const uint8_t* data;
+    size_t size_bits;
+    size_t bits;
+} bit_reader;
+
+static void bits_write(bit_writer* writer, uint64_t value, unsigned count) {
+    while (count > 0) {
+        unsigned room = 8 - (unsigned) (writer->bits & 7);
+        unsigned n = count < room ? count : room;
+        uint8_t chunk = (uint8_t) ((value >> (count - n)) & ((1u << n) - 1));
+        writer->data[writer->bits >> 3] |= (uint8_t) (chunk << (room - n));
+        writer->bits += n;
+        count -= n;
+    }
+}
+
+// returns 0 if the stream ends before count bits
+static int bits_read(bit_reader* reader, unsigned count, uint64_t* value) {
+    if (reader->size_bits - reader->bits < count) return 0;
+    uint64_t result = 0;
+    while (count > 0) {
+        unsigned room = 8 - (unsigned) (reader->bits & 7);
+        unsigned n = count < room ? count : room;
+        uint8_t byte = reader->data[reader->bits >> 3];
+        result = (result << n) | ((byte >> (room - n)) & ((1u << n) - 1));
+        reader->bits += n;
+        count -= n;
+    }
+    *value = result;
+    return 1;
+}
+
+// counts the leading 1 bits, up to max; returns 0 if the stream ends
+static int bits_read_prefix(bit_reader* reader, unsigned max, unsigned* ones) {
+    uint64_t bit = 1;
+    *ones = 0;
+    while (*ones < max && bit == 1) {
+        if (!bits_read(reader, 1, &bit)) return 0;
+        if (bit == 1) (*ones)++;
+    }
+    return 1;
+}
+
+static int fits_signed(int64_t value, unsigned bits) {
+    int64_t limit = (int64_t) 1 << (bits - 1);
+    return value >= -limit && value < limit;
+}
+
+static int64_t sign_extend(uint64_t value, unsigned bits) {
+    uint64_t sign = (uint64_t) 1 << (bits - 1);
+    return (int64_t) ((value ^ sign) - sign);
+}
+
+// delta-of-delta bucket widths for the prefixes 10, 110, 1110 and 1111; sized for nanosecond timestamps, whose
+// jitter is rather microseconds than the seconds of the original Gorilla buckets
+static const unsigned DOD_BITS[] = {14, 20, 32, 64};
+
+// integers: the first value as is, then the difference of consecutive deltas ("0" if the interval didn't change)
+static void encode_integers(bit_writer* writer, const uint8_t* samples, size_t count, size_t sample_size,
+                            const OBX_field* field) {
+    uint64_t prev = 0, prev_delta = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = read_sample_bits(samples + i * sample_size, field->offset, field->size, field->kind);
+        if (i == 0) {
+            bits_write(writer, value, 64);
+        } else {
+            uint64_t delta = value - prev;
+            int64_t dod = (int64_t) (delta - prev_delta);
+            if (dod == 0) {
+                bits_write(writer, 0, 1);
+            } else {
+                unsigned bucket = 0;
+                while (bucket < 3 && !fits_signed(dod, DOD_BITS[bucket])) bucket++;
+                bits_write(writer, bucket < 3 ? ((uint64_t) 1 << (bucket + 2)) - 2 : 15, bucket < 3 ? bucket + 2 : 4);
+                bits_write(writer, (uint64_t) dod, DOD_BITS[bucket]);
+            }
+            prev_delta = delta;
+        }
+        prev = value;
+    }
+}
+
+static int decode_integers(bit_reader* reader, uint8_t* samples, size_t count, size_t sample_size,
+                           const OBX_field* field) {
+    uint64_t prev = 0, prev_delta = 0, value;
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            if (!bits_read(reader, 64, &value)) return 0;
+        } else {
+            unsigned ones;
+            uint64_t bits = 0;
+            if (!bits_read_prefix(reader, 4, &ones)) return 0;
+            if (ones > 0 && !bits_read(reader, DOD_BITS[ones - 1], &bits)) return 0;
+            uint64_t dod = ones > 0 ? (uint64_t) sign_extend(bits, DOD_BITS[ones - 1]) : 0;
+            prev_delta += dod;
+            value = prev + prev_delta;
+        }
+        write_sample_bits(samples + i * sample_size, field->offset, field->size, value);
+        prev = value;
+    }
+    return 1;
+}
+
+// floats: the first value as is, then the XOR with the previous value: "0" if equal, "10" + the meaningful bits if
+// they fit into the previous leading/trailing zero window, else "11" + leading zeros (5 bits) + length + bits
+static void encode_floats(bit_writer* writer, const uint8_t* samples, size_t count, size_t sample_size,
+                          const OBX_field* field) {
+    unsigned width = field->size * 8u;
+    unsigned length_bits = field->size == 4 ? 5 : 6;
+    unsigned prev_leading = 0, prev_trailing = 0;
+    int has_window = 0;
+    uint64_t prev = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t value = read_sample_bits(samples + i * sample_size, field->offset, field->size, field->kind);
+        uint64_t x = value ^ prev;
+        if (i == 0) {
+            bits_write(writer, value, width);
+        } else if (x == 0) {
+            bits_write(writer, 0, 1);
+        } else {
+            unsigned leading = (unsigned) __builtin_clzll(x) - (64 - width);
+            unsigned trailing = (unsigned) __builtin_ctzll(x);
+            if (leading > 31) leading = 31;
+            if (has_window && leading >= prev_leading && trailing >= prev_trailing) {
+                bits_write(writer, 2, 2);
+                bits_write(writer, x >> prev_trailing, width - prev_leading - prev_trailing);
+            } else {
+                unsigned length = width - leading - trailing;
+                bits_write(writer, 3, 2);
+                bits_write(writer, leading, 5);
+                bits_write(writer, length - 1, length_bits);
+                bits_write(writer, x >> trailing, length);
+                prev_leading = leading;
+                prev_trailing = trailing;
+                has_window = 1;
+            }
+        }
+        prev = value;
+    }
+}
+
+static int decode_floats(bit_reader* reader, uint8_t* samples, size_t count, size_t sample_size,
+                         const OBX_field* field) {
+    unsigned width = field->size * 8u;
+    unsigned length_bits = field->size == 4 ? 5 : 6;
+    unsigned prev_leading = 0, prev_trailing = 0;
+    int has_window = 0;
+    uint64_t value = 0, bits;
+    for (size_t i = 0; i < count; ++i) {
+        if (i == 0) {
+            if (!bits_read(reader, width, &value)) return 0;
+        } else {
+            unsigned ones;
+            if (!bits_read_prefix(reader, 2, &ones)) return 0;
+            if (ones == 2) {
+                uint64_t leading, length;
+                if (!bits_read(reader, 5, &leading) || !bits_read(reader, length_bits, &length)) return 0;
+                if (leading + length + 1 > width) return 0;
+                prev_leading = (unsigned) leading;
+                prev_trailing = width - prev_leading - (unsigned) length - 1;
+                has_window = 1;
+            } else if (ones == 1 && !has_window) {
+                return 0;
+            }
+            if (ones > 0) {
+                if (!bits_read(reader, width - prev_leading - prev_trailing, &bits)) return 0;
+                value ^= bits << prev_trailing;
+            }
+        }
+        write_sample_bits(samples + i * sample_size, field->offset, field->size, value);
+    }
+    return 1;
+}
+
+static int series_fields_valid(size_t sample_size, const OBX_field* fields, size_t field_count) {
+    if (fields == NULL || field_count == 0 || field_count > 255) return 0;
+    for (size_t f = 0; f < field_count; ++f) {
+        if (!sample_field_valid(fields + f) || fields[f].offset + fields[f].size > sample_size) return 0;
+    }
+    return 1;
+}
+
+static uint8_t series_field_type(const OBX_field* field) { return (uint8_t) (field->size | field->kind << 4); }
+
+obx_err obx_series_encode(const void* samples, size_t count, size_t sample_size, const OBX_field* fields,
+                          size_t field_count, OBX_bytes* dest) {
+    // check if parameters are valid
+    if ((samples == NULL && count > 0) || count > UINT32_MAX || dest == NULL ||
+        !series_fields_valid(sample_size, fields, field_count)) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t header_size = SERIES_HEADER_SIZE + field_count;
+    size_t max_size = header_size + (count * field_count * SERIES_MAX_VALUE_BITS + 7) / 8;
+    bit_writer writer;
+    writer.data = (uint8_t*) calloc(1, max_size);
+    writer.bits = header_size * 8;
+    if (writer.data == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+
+    // header: magic, version, field count, 2 reserved bytes, sample count (little endian), one type byte per field
+    memcpy(writer.data, SERIES_MAGIC, 4);
+    writer.data[4] = SERIES_VERSION;
+    writer.data[5] = (uint8_t) field_count;
+    for (int i = 0; i < 4; ++i) writer.data[8 + i] = (uint8_t) (count >> (8 * i));
+    for (size_t f = 0; f < field_count; ++f) writer.data[SERIES_HEADER_SIZE + f] = series_field_type(fields + f);
+
+    // column by column, so each field's values are compared with their predecessors of the same field
+    for (size_t f = 0; f < field_count; ++f) {
+        if (fields[f].kind == OBXC_VALUE_FLOAT) {
+            encode_floats(&writer, (const uint8_t*) samples, count, sample_size, fields + f);
+        } else {
+            encode_integers(&writer, (const uint8_t*) samples, count, sample_size, fields + f);
+        }
+    }
+
+    dest->data = writer.data;
+    dest->size = (writer.bits + 7) / 8;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_series_count(const void* data, size_t size, size_t* count) {
+    // check if parameters are valid
+    if (data == NULL || count == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    const uint8_t* bytes = (const uint8_t*) data;
+    if (size < SERIES_HEADER_SIZE || memcmp(bytes, SERIES_MAGIC, 4) != 0 || bytes[4] != SERIES_VERSION) {
+        return obx_set_last_error_code(OBX_ERROR_FILE_CORRUPT);
+    }
+    *count = read_uint32_le(bytes + 8);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_series_decode(const void* data, size_t size, void* samples, size_t capacity, size_t sample_size,
+                          const OBX_field* fields, size_t field_count, size_t* count) {
+    // check if parameters are valid
+    if (samples == NULL || count == NULL || !series_fields_valid(sample_size, fields, field_count)) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t series_count;
+    obx_err err = obx_series_count(data, size, &series_count);
+    if (err != OBX_SUCCESS) return err;
+
+    // the fields must be the ones the series was encoded with
+    const uint8_t* bytes = (const uint8_t*) data;
+    if (bytes[5] != field_count || size < SERIES_HEADER_SIZE + field_count) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    for (size_t f = 0; f < field_count; ++f) {
+        if (bytes[SERIES_HEADER_SIZE + f] != series_field_type(fields + f)) {
+            return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        }
+    }
+    if (series_count > capacity) {
+        return obx_set_last_error_code(OBX_ERROR_OUT_OF_SPACE);
+    }
+
+    bit_reader reader;
+    reader.data = bytes;
+    reader.size_bits = size * 8;
+    reader.bits = (SERIES_HEADER_SIZE + field_count) * 8;
+    for (size_t f = 0; f < field_count; ++f) {
+        int ok = fields[f].kind == OBXC_VALUE_FLOAT
+                     ? decode_floats(&reader, (uint8_t*) samples, series_count, sample_size, fields + f)
+                     : decode_integers(&reader, (uint8_t*) samples, series_count, sample_size, fields + f);
+        if (!ok) return obx_set_last_error_code(OBX_ERROR_FILE_CORRUPT);
+    }
+
+    *count = series_count;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <string.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// keys per block; a lookup binary-searches the block fences first, which fit into cache even for millions of keys,
+// and then a single block
+#define INDEX_BLOCK 64
+
+struct OBX_index {
+    size_t count;
+
+    // sorted keys and the views of their objects at the same positions
+    uint64_t* keys;
+    OBX_bytes* bytes;
+
+    // first key of each block
+    uint64_t* fences;
+    size_t fence_count;
+};
+
+typedef struct IndexEntry {
+    uint64_t key;
+    size_t pos;
+} IndexEntry;
+
+// orders by key, then by position in the source array, so objects with equal keys keep their order
+static int index_entry_compare(const void* a, const void* b) {
+    const IndexEntry* ea = (const IndexEntry*) a;
+    const IndexEntry* eb = (const IndexEntry*) b;
+    if (ea->key != eb->key) return ea->key < eb->key ? -1 : 1;
+    return ea->pos < eb->pos ? -1 : ea->pos > eb->pos;
+}
+
+// sorts keys and views together; data fetched in ID order is often sorted by time already, which skips the sort
+static int index_sort(OBX_index* index, const OBX_bytes_array* array) {
+    size_t i = 1;
+    while (i < index->count && index->keys[i - 1] <= index->keys[i]) ++i;
+    if (i >= index->count) {
+        if (index->count > 0) memcpy(index->bytes, array->bytes, index->count * sizeof(OBX_bytes));
+        return 1;
+    }
+
+    IndexEntry* entries = (IndexEntry*) malloc(index->count * sizeof(IndexEntry));
+    if (entries == NULL) return 0;
+    for (i = 0; i < index->count; ++i) {
+        entries[i].key = index->keys[i];
+        entries[i].pos = i;
+    }
+    qsort(entries, index->count, sizeof(IndexEntry), index_entry_compare);
+    for (i = 0; i < index->count; ++i) {
+        index->keys[i] = entries[i].key;
+        index->bytes[i] = array->bytes[entries[i].pos];
+    }
+    free(entries);
+    return 1;
+}
+
+// returns the position of the first key not less than (or if upper, greater than) the given one
+static size_t index_bound(const OBX_index* index, uint64_t key, int upper) {
+    // the first block whose fence is past the key; the bound lies in the block before
+    size_t lo = 0, hi = index->fence_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (upper ? index->fences[mid] <= key : index->fences[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) return 0;
+
+    hi = lo * INDEX_BLOCK < index->count ? lo * INDEX_BLOCK : index->count;
+    lo = (lo - 1) * INDEX_BLOCK;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (upper ? index->keys[mid] <= key : index->keys[mid] < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+OBX_index* obx_index(const OBX_bytes_array* array, uint16_t field_id) {
+    // check if parameters are valid
+    if (array == NULL || (array->bytes == NULL && array->count > 0)) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    OBX_index* index = (OBX_index*) calloc(1, sizeof(OBX_index));
+    if (index == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    index->count = array->count;
+    index->fence_count = (array->count + INDEX_BLOCK - 1) / INDEX_BLOCK;
+
+    // +1 so that empty arrays don't depend on malloc(0)
+    index->keys = (uint64_t*) malloc(array->count * sizeof(uint64_t) + 1);
+    index->bytes = (OBX_bytes*) malloc(array->count * sizeof(OBX_bytes) + 1);
+    index->fences = (uint64_t*) malloc(index->fence_count * sizeof(uint64_t) + 1);
+    if (index->keys == NULL || index->bytes == NULL || index->fences == NULL) {
+        obx_index_close(index);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+
+    // keys are read like any other column, including the bounds checks of unverified arrays
+    OBX_column column = {field_id, sizeof(uint64_t), index->keys};
+    if (obx_bytes_array_project(array, &column, 1) != OBX_SUCCESS) {
+        obx_err err = OBX_LAST_ERROR_CODE;
+        obx_index_close(index);
+        obx_set_last_error_code(err);
+        return NULL;
+    }
+
+    if (!index_sort(index, array)) {
+        obx_index_close(index);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    for (size_t b = 0; b < index->fence_count; ++b) index->fences[b] = index->keys[b * INDEX_BLOCK];
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return index;
+}
+
+obx_err obx_index_close(OBX_index* index) {
+    if (index != NULL) {
+        if (index->keys != NULL) free(index->keys);
+        if (index->bytes != NULL) free(index->bytes);
+        if (index->fences != NULL) free(index->fences);
+        free(index);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_index_range(const OBX_index* index, uint64_t min, uint64_t max, OBX_index_range* range) {
+    // check if parameters are valid
+    if (index == NULL || range == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t begin = min > max ? 0 : index_bound(index, min, 0);
+    size_t end = min > max ? 0 : index_bound(index, max, 1);
+    range->bytes = index->bytes + begin;
+    range->keys = index->keys + begin;
+    range->count = end - begin;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
@@ -0,0 +1,154 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// separates the members written by the producer from the ones written by the consumer, so that each side's writes
+// don't invalidate the cache line the other side is reading from (false sharing)
+#define RING_CACHE_LINE 64
+
+struct OBX_ring {
+    // read-only after construction
+    size_t record_size;
+    size_t capacity;
+    size_t mask;
+    uint8_t* records;
+    char pad0[RING_CACHE_LINE];
+
+    // producer: tail counts all records ever pushed; head_cache is its (possibly outdated) copy of head, only
+    // refreshed when the ring seems full
+    atomic_size_t tail;
+    size_t head_cache;
+    atomic_uint_least64_t dropped;
+    char pad1[RING_CACHE_LINE];
+
+    // consumer: head counts all records ever popped
+    atomic_size_t head;
+    size_t tail_cache;
+    atomic_size_t max_depth;
+    char pad2[RING_CACHE_LINE];
+};
+
+OBX_ring* obx_ring(size_t record_size, size_t capacity) {
+    // check if parameters are valid
+    if (record_size == 0 || capacity == 0 || capacity > ((size_t) -1 >> 2) / record_size) {
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+        return NULL;
+    }
+
+    // a power of two, so positions map to slots by masking and the counters may wrap around
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+
+    OBX_ring* ring = (OBX_ring*) calloc(1, sizeof(OBX_ring));
+    if (ring == NULL) {
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    ring->records = (uint8_t*) malloc(slots * record_size);
+    if (ring->records == NULL) {
+        free(ring);
+        obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+        return NULL;
+    }
+    ring->record_size = record_size;
+    ring->capacity = slots;
+    ring->mask = slots - 1;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->dropped, 0);
+    atomic_init(&ring->max_depth, 0);
+
+    obx_set_last_error_code(OBX_SUCCESS);
+    return ring;
+}
+
+obx_err obx_ring_close(OBX_ring* ring) {
+    if (ring != NULL) {
+        free(ring->records);
+        free(ring);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_ring_push(OBX_ring* ring, const void* record) {
+    // check if parameters are valid
+    if (ring == NULL || record == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    if (tail - ring->head_cache == ring->capacity) {
+        ring->head_cache = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail - ring->head_cache == ring->capacity) {
+            // only the producer writes this counter, no read-modify-write needed
+            uint64_t dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+            atomic_store_explicit(&ring->dropped, dropped + 1, memory_order_relaxed);
+            return obx_set_last_error_code(OBX_ERROR_OUT_OF_SPACE);
+        }
+    }
+
+    memcpy(ring->records + (tail & ring->mask) * ring->record_size, record, ring->record_size);
+
+    // publishes the record: the consumer's acquire load of tail sees the copied bytes
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    // the last error is left alone on success, its global would be written by both threads on every record
+    return OBX_SUCCESS;
+}
+
+obx_err obx_ring_pop(OBX_ring* ring, void* records, size_t max_count, size_t* count) {
+    // check if parameters are valid
+    if (ring == NULL || records == NULL || count == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    if (ring->tail_cache - head < max_count) {
+        ring->tail_cache = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+        // the depth peaks right before the consumer catches up, so this sees the maximum
+        size_t depth = ring->tail_cache - head;
+        if (depth > atomic_load_explicit(&ring->max_depth, memory_order_relaxed)) {
+            atomic_store_explicit(&ring->max_depth, depth, memory_order_relaxed);
+        }
+    }
+
+    size_t n = ring->tail_cache - head;
+    if (n > max_count) n = max_count;
+    for (size_t i = 0; i < n;) {
+        // copy contiguous slots at once, i.e. at most two memcpy() per pop
+        size_t slot = (head + i) & ring->mask;
+        size_t chunk = ring->capacity - slot;
+        if (chunk > n - i) chunk = n - i;
+        memcpy((uint8_t*) records + i * ring->record_size, ring->records + slot * ring->record_size,
+               chunk * ring->record_size);
+        i += chunk;
+    }
+
+    // frees the slots: the producer's acquire load of head sees them as read
+    atomic_store_explicit(&ring->head, head + n, memory_order_release);
+    *count = n;
+    return OBX_SUCCESS;
+}
+
+obx_err obx_ring_stats(OBX_ring* ring, OBX_ring_stats* stats) {
+    // check if parameters are valid
+    if (ring == NULL || stats == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    // head before tail: tail never falls behind a head loaded earlier, so the depth can't be negative
+    size_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    stats->pushed = (uint64_t) tail;
+    stats->popped = (uint64_t) head;
+    stats->dropped = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    stats->depth = tail - head;
+    stats->max_depth = atomic_load_explicit(&ring->max_depth, memory_order_relaxed);
+    stats->capacity = ring->capacity;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
@@ -4,6 +4,7 @@
 #include <curl/curl.h>
 
 #define OBXC_USE_OBX_ALIASES
+#include "builder_pool.h"
 #include "error_manager.h"
 #include "http_utils.h"
 #include "objectbox.h"
@@ -73,7 +74,7 @@ obx_err obx_store_authenticate(OBX_store* store, const char* db, const char* use
 }
 
 OBX_store* obx_store_open(const OBX_store_options* options) {
-    if (options == NULL || options->base_url == NULL) {
+    if (options == NULL || options->base_url == NULL || options->compress_level < 0 || options->compress_level > 9) {
         obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
         return NULL;
     }
@@ -84,7 +85,18 @@ OBX_store* obx_store_open(const OBX_store_options* options) {
         return NULL;
     }
 
+    if (builder_pool_init(&ret->builder_pool) != 0) {
+        free(ret);
+        obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+        return NULL;
+    }
+
     ret->http_api = rest_create(options->base_url);
+    if (ret->http_api != NULL) {
+        ret->http_api->accept_encoding = options->accept_encoding;
+        ret->http_api->compress_min_size = options->compress_min_size;
+        ret->http_api->compress_level = options->compress_level;
+    }
     if (obx_store_authenticate(ret, options->db, options->user, options->pass, options->model.data == NULL ? NULL : &options->model)) {
         return NULL;
     }
@@ -96,7 +108,24 @@ OBX_store* obx_store_open(const OBX_store_options* options) {
 obx_err obx_store_close(OBX_store* store) {
     if (store != NULL) {
         if (store->http_api != NULL) rest_close(store->http_api);
+        builder_pool_close(&store->builder_pool);
         free(store);
     }
     return obx_set_last_error_code(OBX_SUCCESS);
 }
+
+obx_err obx_store_transfer_stats(OBX_store* store, OBX_transfer_stats* stats) {
+    // check if parameters are valid
+    if (store == NULL || store->http_api == NULL || stats == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    HttpApi* api = store->http_api;
+    stats->requests = atomic_load_explicit(&api->requests, memory_order_relaxed);
+    stats->sent_raw_bytes = atomic_load_explicit(&api->sent_raw_bytes, memory_order_relaxed);
+    stats->sent_bytes = atomic_load_explicit(&api->sent_bytes, memory_order_relaxed);
+    stats->received_bytes = atomic_load_explicit(&api->received_bytes, memory_order_relaxed);
+    stats->received_raw_bytes = atomic_load_explicit(&api->received_raw_bytes, memory_order_relaxed);
+    stats->compress_ns = atomic_load_explicit(&api->compress_ns, memory_order_relaxed);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
@@ -0,0 +1,61 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "flatcc/flatcc_builder.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "data_operations.h"
+#include "error_manager.h"
+#include "objectbox.h"
+#include "region_emitter.h"
+#include "utilities.h"
+
+// finds each field's position in the buffer using the root table's vtable
+static obx_err template_locate_fields(OBX_template* tpl) {
+    const uint8_t* buf = (const uint8_t*) tpl->buffer;
+    FlatbufferRoot root;
+    if (!flatbuffer_root(buf, tpl->size, 0, &root)) return OBX_ERROR_ILLEGAL_ARGUMENT;
+    tpl->field_count = (root.vt_size - 4) / 2;
+    if (tpl->field_count > OBXC_TEMPLATE_MAX_FIELDS) return OBX_ERROR_ILLEGAL_ARGUMENT;
+
+    for (size_t i = 0; i < tpl->field_count; ++i) {
+        size_t offset = read_uint16_le(buf + root.vtable + 4 + 2 * i);
+        if (offset >= root.table_size) return OBX_ERROR_ILLEGAL_ARGUMENT;
+        tpl->field_pos[i] = offset == 0 ? 0 : (uint32_t)(root.table + offset);
+    }
+    return OBX_SUCCESS;
+}
+
+obx_err obx_template_init(OBX_template* tpl, flatcc_builder_t* builder) {
+    // check if parameters are valid: the builder must hold a completely finished buffer
+    if (tpl == NULL) return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    obx_err err = data_builder_check(builder);
+    if (err != OBX_SUCCESS) return obx_set_last_error_code(err);
+
+    // keep a private copy, the builder is usually reused afterwards
+    tpl->size = flatcc_builder_get_buffer_size(builder);
+    tpl->buffer = malloc(tpl->size);
+    if (tpl->buffer == NULL) return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    if (region_emitter_of(builder) != NULL) {
+        size_t size;
+        memcpy(tpl->buffer, obx_region_builder_buffer(builder, &size), tpl->size);
+    } else {
+        flatcc_builder_copy_buffer(builder, tpl->buffer, tpl->size);
+    }
+
+    err = template_locate_fields(tpl);
+    if (err != OBX_SUCCESS) {
+        obx_template_free(tpl);
+        return obx_set_last_error_code(err);
+    }
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+void obx_template_free(OBX_template* tpl) {
+    if (tpl) {
+        if (tpl->buffer) free(tpl->buffer);
+        tpl->buffer = NULL;
+        tpl->size = 0;
+        tpl->field_count = 0;
+    }
+}
@@ -0,0 +1,129 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+#define TRACE_MAGIC "OBXT"
+#define TRACE_VERSION 1
+#define TRACE_HEADER_SIZE 12
+#define TRACE_EVENT_SIZE 13
+
+// One event; written by any thread without locks. seq is odd while the slot is being written and 2 * (index + 1)
+// afterwards, so the dump skips slots which are incomplete or were overwritten while it read them.
+typedef struct trace_slot {
+    atomic_uint_least64_t seq;
+    atomic_uint_least64_t time_ns;
+    atomic_uint_least32_t trace_id;
+    atomic_uint_least32_t stage;
+} trace_slot;
+
+// set up by obx_trace_enable() before tracing threads run, so these don't need to be atomic themselves
+static trace_slot* trace_slots = NULL;
+static size_t trace_mask = 0;
+
+static atomic_uint_least64_t trace_next = 0;
+static atomic_uint_least32_t trace_last_id = 0;
+
+static uint64_t trace_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+static void trace_put_le(uint8_t* dest, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) dest[i] = (uint8_t) (value >> (8 * i));
+}
+
+obx_err obx_trace_enable(size_t capacity) {
+    if (trace_slots != NULL) {
+        free(trace_slots);
+        trace_slots = NULL;
+        trace_mask = 0;
+    }
+    atomic_store(&trace_next, 0);
+    if (capacity == 0) return obx_set_last_error_code(OBX_SUCCESS);
+
+    // a power of two, so the slot of an event is its index masked
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+    trace_slots = (trace_slot*) calloc(slots, sizeof(trace_slot));
+    if (trace_slots == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+    trace_mask = slots - 1;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+uint32_t obx_trace_id(void) {
+    if (trace_slots == NULL) return 0;
+
+    // 0 means "not traced", skip it when wrapping around
+    uint32_t id = (uint32_t) atomic_fetch_add_explicit(&trace_last_id, 1, memory_order_relaxed) + 1;
+    if (id == 0) id = (uint32_t) atomic_fetch_add_explicit(&trace_last_id, 1, memory_order_relaxed) + 1;
+    return id;
+}
+
+void obx_trace(uint32_t trace_id, OBX_trace_stage stage) {
+    if (trace_slots == NULL || trace_id == 0) return;
+
+    uint64_t index = atomic_fetch_add_explicit(&trace_next, 1, memory_order_relaxed);
+    trace_slot* slot = trace_slots + (index & trace_mask);
+    atomic_store_explicit(&slot->seq, 2 * index + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->time_ns, trace_now_ns(), memory_order_relaxed);
+    atomic_store_explicit(&slot->trace_id, trace_id, memory_order_relaxed);
+    atomic_store_explicit(&slot->stage, (uint32_t) stage, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, 2 * index + 2, memory_order_release);
+}
+
+obx_err obx_trace_dump(OBX_bytes* dest) {
+    // check if parameters are valid
+    if (dest == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+    if (trace_slots == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_STATE);
+    }
+
+    // the newest events, at most one ring's worth, oldest first
+    uint64_t end = atomic_load_explicit(&trace_next, memory_order_acquire);
+    uint64_t capacity = (uint64_t) trace_mask + 1;
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    uint8_t* data = (uint8_t*) malloc(TRACE_HEADER_SIZE + (size_t) (end - begin) * TRACE_EVENT_SIZE);
+    if (data == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ALLOCATION);
+    }
+
+    uint8_t* event = data + TRACE_HEADER_SIZE;
+    uint32_t count = 0;
+    for (uint64_t index = begin; index < end; ++index) {
+        trace_slot* slot = trace_slots + (index & trace_mask);
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        uint64_t time_ns = atomic_load_explicit(&slot->time_ns, memory_order_relaxed);
+        uint32_t trace_id = atomic_load_explicit(&slot->trace_id, memory_order_relaxed);
+        uint32_t stage = atomic_load_explicit(&slot->stage, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+        if (seq != 2 * index + 2 || atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) continue;
+
+        trace_put_le(event, trace_id, 4);
+        event[4] = (uint8_t) stage;
+        trace_put_le(event + 5, time_ns, 8);
+        event += TRACE_EVENT_SIZE;
+        count++;
+    }
+
+    // header: magic, version, stage count, event count (little endian)
+    memcpy(data, TRACE_MAGIC, 4);
+    trace_put_le(data + 4, TRACE_VERSION, 2);
+    trace_put_le(data + 6, OBXC_TRACE_STAGE_COUNT, 2);
+    trace_put_le(data + 8, count, 4);
+
+    dest->data = data;
+    dest->size = TRACE_HEADER_SIZE + (size_t) count * TRACE_EVENT_SIZE;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
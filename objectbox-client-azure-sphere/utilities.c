@@ -9,10 +9,14 @@
 #define MAX_NUM_STRLEN 20
 
 int safe_uint64_parse(const char* str, size_t len, uint64_t* dest) {
-    if (str == NULL || dest == NULL) return 0;
-    *dest = strtoull(str, NULL, 10);
+    if (str == NULL || dest == NULL || len > MAX_NUM_STRLEN) return 0;
 
+    // str is not null-terminated, e.g. a response body, so strtoull() could read past it
     char num_str[MAX_NUM_STRLEN + 1];
+    memcpy(num_str, str, len);
+    num_str[len] = '\0';
+    *dest = strtoull(num_str, NULL, 10);
+
     snprintf(num_str, MAX_NUM_STRLEN + 1, "%" PRIu64, *dest);
     if (len != strlen(num_str) || strncmp(str, num_str, len) != 0) {
         return 0;
@@ -96,3 +100,96 @@ int atoi_n(char* str, size_t len) {
 
     return sign * res;
 }
+
+// the server sends all binary integers in little endian; reading bytewise is safe for unaligned positions as well
+uint16_t read_uint16_le(const void* ptr) {
+    const uint8_t* b = (const uint8_t*) ptr;
+    return (uint16_t) (b[0] | b[1] << 8);
+}
+
+uint32_t read_uint32_le(const void* ptr) {
+    const uint8_t* b = (const uint8_t*) ptr;
+    return (uint32_t) b[0] | (uint32_t) b[1] << 8 | (uint32_t) b[2] << 16 | (uint32_t) b[3] << 24;
+}
+
+uint64_t read_uint64_le(const void* ptr) {
+    return (uint64_t) read_uint32_le(ptr) | (uint64_t) read_uint32_le((const uint8_t*) ptr + 4) << 32;
+}
+
+int flatbuffer_root(const uint8_t* buf, size_t size, int trusted, FlatbufferRoot* root) {
+    if (!trusted && (buf == NULL || size < 8)) return 0;
+
+    // the vtable's position is the table's minus the signed offset stored at the table
+    root->table = read_uint32_le(buf);
+    if (!trusted && root->table > size - 4) return 0;
+    root->vtable = root->table - (size_t) (int64_t) (int32_t) read_uint32_le(buf + root->table);
+    if (!trusted && root->vtable > size - 4) return 0;
+    root->vt_size = read_uint16_le(buf + root->vtable);
+    root->table_size = read_uint16_le(buf + root->vtable + 2);
+    if (trusted) return 1;
+    return root->vt_size >= 4 && root->vt_size <= size - root->vtable && root->table_size <= size - root->table;
+}
+
+int sample_field_valid(const OBX_field* field) {
+    if (field->kind == OBXC_VALUE_FLOAT) return field->size == 4 || field->size == 8;
+    return field->kind < OBXC_VALUE_FLOAT &&
+           (field->size == 1 || field->size == 2 || field->size == 4 || field->size == 8);
+}
+
+uint64_t read_sample_bits(const void* sample, size_t offset, uint8_t size, OBX_value_kind kind) {
+    // memcpy avoids alignment assumptions about the struct
+    const uint8_t* src = (const uint8_t*) sample + offset;
+    uint16_t v16;
+    uint32_t v32;
+    uint64_t v64;
+    switch (size) {
+        case 1:
+            return kind == OBXC_VALUE_SIGNED ? (uint64_t) (int64_t) (int8_t) *src : *src;
+        case 2:
+            memcpy(&v16, src, 2);
+            return kind == OBXC_VALUE_SIGNED ? (uint64_t) (int64_t) (int16_t) v16 : v16;
+        case 4:
+            memcpy(&v32, src, 4);
+            return kind == OBXC_VALUE_SIGNED ? (uint64_t) (int64_t) (int32_t) v32 : v32;
+        default:
+            memcpy(&v64, src, 8);
+            return v64;
+    }
+}
+
+void write_sample_bits(void* sample, size_t offset, uint8_t size, uint64_t bits) {
+    uint8_t* dest = (uint8_t*) sample + offset;
+    uint8_t v8 = (uint8_t) bits;
+    uint16_t v16 = (uint16_t) bits;
+    uint32_t v32 = (uint32_t) bits;
+    switch (size) {
+        case 1:
+            memcpy(dest, &v8, 1);
+            break;
+        case 2:
+            memcpy(dest, &v16, 2);
+            break;
+        case 4:
+            memcpy(dest, &v32, 4);
+            break;
+        default:
+            memcpy(dest, &bits, 8);
+            break;
+    }
+}
+
+double read_sample_value(const void* sample, size_t offset, uint8_t size, OBX_value_kind kind) {
+    uint64_t bits = read_sample_bits(sample, offset, size, kind);
+    if (kind == OBXC_VALUE_FLOAT && size == sizeof(float)) {
+        float value;
+        uint32_t v32 = (uint32_t) bits;
+        memcpy(&value, &v32, sizeof(value));
+        return value;
+    }
+    if (kind == OBXC_VALUE_FLOAT) {
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    return kind == OBXC_VALUE_SIGNED ? (double) (int64_t) bits : (double) bits;
+}
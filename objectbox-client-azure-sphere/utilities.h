@@ -9,5 +9,32 @@
 int safe_uint64_parse(const char* str, size_t len, uint64_t* dest);
 int parse_error_response(Memory* mem);
 int atoi_n(char* str, size_t len);
+uint16_t read_uint16_le(const void* ptr);
+uint32_t read_uint32_le(const void* ptr);
+uint64_t read_uint64_le(const void* ptr);
+
+// positions of a FlatBuffer's root table and its vtable, and their sizes as stored in the vtable
+typedef struct FlatbufferRoot {
+    size_t table;
+    size_t table_size;
+    size_t vtable;
+    size_t vt_size;
+} FlatbufferRoot;
+
+// locates the root table and its vtable; unless trusted, returns 0 if they don't lie within the buffer
+int flatbuffer_root(const uint8_t* buf, size_t size, int trusted, FlatbufferRoot* root);
+
+// checks the size of a scalar member against its kind: 1, 2, 4 or 8 bytes, 4 or 8 for floats
+int sample_field_valid(const OBXC_field* field);
+
+// reads the bits of a scalar member (1, 2, 4 or 8 bytes; floats 4 or 8) of a sample struct in host byte order;
+// signed integers are sign-extended to 64 bits
+uint64_t read_sample_bits(const void* sample, size_t offset, uint8_t size, OBXC_value_kind kind);
+
+// writes the lowest size bytes of the bits to a scalar member of a sample struct
+void write_sample_bits(void* sample, size_t offset, uint8_t size, uint64_t bits);
+
+// reads a scalar member of a sample struct as a number
+double read_sample_value(const void* sample, size_t offset, uint8_t size, OBXC_value_kind kind);
 
 #endif  // OBJECTBOX_UTILITIES_H
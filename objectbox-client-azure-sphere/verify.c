@@ -0,0 +1,147 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "flatcc/flatcc_verifier.h"
+
+#define OBXC_USE_OBX_ALIASES
+#include "error_manager.h"
+#include "objectbox.h"
+
+// arrays smaller than this per thread are verified by the calling thread alone, starting threads would take longer
+#define VERIFY_MIN_CHUNK_OBJECTS 64
+
+typedef struct VerifyChunk {
+    const OBX_bytes_array* array;
+    obx_verifier* verifier;
+    size_t begin;
+    size_t end;
+    pthread_t thread;
+    int started;
+
+    OBX_verify_stats stats;
+} VerifyChunk;
+
+static uint64_t verify_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+// verifies the objects [begin, end), stopping at the first invalid one; doesn't touch the global error state
+static int verify_objects(const OBX_bytes_array* array, size_t begin, size_t end, obx_verifier* verifier,
+                          OBX_verify_stats* stats) {
+    stats->objects = 0;
+    stats->bytes = 0;
+    stats->error = 0;
+    stats->error_index = 0;
+
+    for (size_t i = begin; i < end; ++i) {
+        const OBX_bytes* bytes = array->bytes + i;
+        int ret = bytes->data == NULL ? flatcc_verify_error_buffer_header_too_small
+                                      : verifier(bytes->data, bytes->size);
+        if (ret != flatcc_verify_ok) {
+            stats->error = ret;
+            stats->error_index = i;
+            return ret;
+        }
+        ++stats->objects;
+        stats->bytes += bytes->size;
+    }
+    return flatcc_verify_ok;
+}
+
+static void* verify_chunk_run(void* arg) {
+    VerifyChunk* chunk = (VerifyChunk*) arg;
+    verify_objects(chunk->array, chunk->begin, chunk->end, chunk->verifier, &chunk->stats);
+    return NULL;
+}
+
+// reports an invalid object like an error returned by the server, i.e. with a message and the reason as secondary code
+static obx_err verify_failed(size_t index, int reason) {
+    snprintf(OBX_LAST_RESPONSE_ERROR_MESSAGE, 256, "object %zu failed verification: %s", index,
+             flatcc_verify_error_string(reason));
+    OBX_LAST_ERROR_SECONDARY = reason;
+    return obx_set_last_error_code(OBX_ERROR_ILLEGAL_RESPONSE);
+}
+
+obx_err obx_bytes_verify(const OBX_bytes* bytes, obx_verifier* verifier) {
+    // check if parameters are valid
+    if (bytes == NULL || verifier == NULL) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    int ret = bytes->data == NULL ? flatcc_verify_error_buffer_header_too_small : verifier(bytes->data, bytes->size);
+    if (ret != flatcc_verify_ok) return verify_failed(0, ret);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_bytes_array_verify_range(const OBX_bytes_array* array, size_t begin, size_t end, obx_verifier* verifier,
+                                     OBX_verify_stats* stats) {
+    // check if parameters are valid
+    if (array == NULL || verifier == NULL || begin > end || end > array->count) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_verify_stats local;
+    if (stats == NULL) stats = &local;
+    uint64_t start = verify_now_ns();
+    int ret = verify_objects(array, begin, end, verifier, stats);
+    stats->duration_ns = verify_now_ns() - start;
+
+    if (ret != flatcc_verify_ok) return verify_failed(stats->error_index, ret);
+    return obx_set_last_error_code(OBX_SUCCESS);
+}
+
+obx_err obx_bytes_array_verify(OBX_bytes_array* array, obx_verifier* verifier, size_t threads,
+                               OBX_verify_stats* stats) {
+    // check if parameters are valid
+    if (array == NULL || verifier == NULL || threads > OBXC_VERIFY_MAX_THREADS) {
+        return obx_set_last_error_code(OBX_ERROR_ILLEGAL_ARGUMENT);
+    }
+
+    OBX_verify_stats total = {0};
+    if (array->verified_by == verifier) {
+        if (stats != NULL) *stats = total;
+        return obx_set_last_error_code(OBX_SUCCESS);
+    }
+
+    // split into equally sized chunks; the last one is verified by the calling thread
+    if (threads == 0) threads = 1;
+    if (array->count / threads < VERIFY_MIN_CHUNK_OBJECTS) threads = array->count / VERIFY_MIN_CHUNK_OBJECTS;
+    if (threads == 0) threads = 1;
+
+    VerifyChunk chunks[OBXC_VERIFY_MAX_THREADS];
+    uint64_t start = verify_now_ns();
+    for (size_t i = 0; i < threads; ++i) {
+        VerifyChunk* chunk = chunks + i;
+        chunk->array = array;
+        chunk->verifier = verifier;
+        chunk->begin = array->count * i / threads;
+        chunk->end = array->count * (i + 1) / threads;
+        chunk->started = i + 1 < threads && pthread_create(&chunk->thread, NULL, verify_chunk_run, chunk) == 0;
+    }
+
+    // chunks whose thread couldn't be started are verified here as well
+    for (size_t i = threads; i-- > 0;) {
+        if (!chunks[i].started) verify_chunk_run(chunks + i);
+    }
+
+    int ret = flatcc_verify_ok;
+    for (size_t i = 0; i < threads; ++i) {
+        if (chunks[i].started) pthread_join(chunks[i].thread, NULL);
+        total.objects += chunks[i].stats.objects;
+        total.bytes += chunks[i].stats.bytes;
+        if (ret == flatcc_verify_ok && chunks[i].stats.error != flatcc_verify_ok) {
+            ret = total.error = chunks[i].stats.error;
+            total.error_index = chunks[i].stats.error_index;
+        }
+    }
+    total.duration_ns = verify_now_ns() - start;
+    if (stats != NULL) *stats = total;
+
+    if (ret != flatcc_verify_ok) return verify_failed(total.error_index, ret);
+    array->verified_by = verifier;
+    return obx_set_last_error_code(OBX_SUCCESS);
+}